@@ -55,6 +55,52 @@ const unsigned int BLOCKCHAIN_SIZE = 50;
 // Number of nodes sent from lookup node to newly joined node
 const unsigned int SEED_PEER_LIST_SIZE = 20;
 
+// Byte budgets of the caches used by lookup node to serve block sync requests
+const unsigned int SEED_BLOCK_CACHE_SIZE_IN_BYTES = 64 * 1024 * 1024;
+const unsigned int SEED_BLOCK_RANGE_CACHE_SIZE_IN_BYTES = 32 * 1024 * 1024;
+
+// Parallel tx block synchronization from seed nodes
+const unsigned int TXBLOCK_SYNC_CHUNK_SIZE = 10;
+const unsigned int TXBLOCK_SYNC_CHUNK_TIMEOUT_IN_SECONDS = 5;
+const unsigned int TXBLOCK_SYNC_CHUNK_MAX_ATTEMPTS = 3;
+
+// State snapshots served by lookup nodes to bootstrapping nodes
+const unsigned int STATE_SNAPSHOT_CHUNK_SIZE_IN_BYTES = 4 * 1024 * 1024;
+const unsigned int STATE_SNAPSHOT_CHUNK_TIMEOUT_IN_SECONDS = 10;
+const unsigned int STATE_SNAPSHOT_MAX_RETRIES = 5;
+
+// Lookup JSON-RPC server: per-block response cache
+const unsigned int LOOKUP_RPC_RESPONSE_CACHE_SIZE_IN_BYTES = 64 * 1024 * 1024;
+const unsigned int LOOKUP_RPC_RESPONSE_MAX_CACHED_SIZE_IN_BYTES = 1024 * 1024;
+const unsigned int LOOKUP_RPC_MAX_TXNS_PER_BATCH = 1000;
+const unsigned int LOOKUP_RPC_NUM_VERIFIER_THREADS = 4;
+
+// Contract state queries served by the lookup JSON-RPC server
+const unsigned int CONTRACT_STATE_PAGE_SIZE = 100;
+const unsigned int CONTRACT_STATE_PAGE_SIZE_IN_BYTES = 1024 * 1024;
+// Opt-in cap on the whole state returned by GetSmartContractState, 0 for no
+// limit. With a cap, larger states fail and must be read with
+// GetSmartContractSubState instead, which breaks existing callers.
+const unsigned int CONTRACT_STATE_JSON_MAX_SIZE_IN_BYTES = 0;
+
+// Txn packets streamed by lookup nodes to the shards within an epoch
+const unsigned int LOOKUP_TXNPACKET_STREAM_INTERVAL_IN_MS = 500;
+const unsigned int TXN_PACKET_HEADER_SIZE_IN_BYTES = 1024;
+
+// Sharding structure sent to shard nodes as a delta against that of the
+// previous DS block, with a full structure every few DS blocks
+const unsigned int SHARDINGSTRUCTURE_SNAPSHOT_INTERVAL = 10;
+const unsigned int SHARDINGSTRUCTURE_FETCH_TIMEOUT_IN_MS = 5000;
+
+// Mempool summaries sent by shard backups to the leader at the end of the
+// txn distribution window, so that missing txns are fetched before consensus
+const unsigned int TXN_PREFETCH_TIMEOUT_IN_MS = 1000;
+const unsigned int TXN_PREFETCH_MAX_REPLY_SIZE_IN_BYTES = 8 * 1024 * 1024;
+
+// Txn bodies and microblocks kept by lookup nodes in LevelDB for this many DS
+// epochs, then moved to immutable cold storage segments (0 keeps all)
+const unsigned int TXBODY_HOT_RETENTION_DS_EPOCHS = 50;
+
 // Transaction body sharing
 
 const unsigned int NUM_VACUOUS_EPOCHS = 1;
@@ -80,6 +126,7 @@ enum MetaType : unsigned char {
   LATESTACTIVEDSBLOCKNUM,
   WAKEUPFORUPGRADE,
   LATEST_EPOCH_STATES_UPDATED,
+  CONTRACTSTORAGEROOTMIGRATION,
 };
 
 // Sync Type
@@ -51,9 +51,11 @@ static const std::string NodeInstructionStrings[]{
     MAKE_LITERAL_STRING(FORWARDTXNPACKET),
     MAKE_LITERAL_STRING(FALLBACKCONSENSUS),
     MAKE_LITERAL_STRING(FALLBACKBLOCK),
-    MAKE_LITERAL_STRING(PROPOSEGASPRICE)};
+    MAKE_LITERAL_STRING(PROPOSEGASPRICE),
+    MAKE_LITERAL_STRING(DSGUARDNODENETWORKINFOUPDATE),
+    MAKE_LITERAL_STRING(MEMPOOLSUMMARY)};
 
-static_assert(ARRAY_SIZE(NodeInstructionStrings) == PROPOSEGASPRICE + 1,
+static_assert(ARRAY_SIZE(NodeInstructionStrings) == MEMPOOLSUMMARY + 1,
               "NodeInstructionStrings definition is not correct");
 
 static const std::string LookupInstructionStrings[]{
@@ -72,8 +74,8 @@ static const std::string LookupInstructionStrings[]{
     MAKE_LITERAL_STRING(RAISESTARTPOW),
     MAKE_LITERAL_STRING(GETSTARTPOWFROMSEED),
     MAKE_LITERAL_STRING(SETSTARTPOWFROMSEED),
-    MAKE_LITERAL_STRING(GETSHARDSFROMSEED),        // UNUSED
-    MAKE_LITERAL_STRING(SETSHARDSFROMSEED),        // UNUSED
+    MAKE_LITERAL_STRING(GETSHARDSFROMSEED),
+    MAKE_LITERAL_STRING(SETSHARDSFROMSEED),
     MAKE_LITERAL_STRING(GETMICROBLOCKFROMLOOKUP),  // UNUSED
     MAKE_LITERAL_STRING(SETMICROBLOCKFROMLOOKUP),  // UNUSED
     MAKE_LITERAL_STRING(GETTXNFROMLOOKUP),         // UNUSED
@@ -87,9 +89,14 @@ static const std::string LookupInstructionStrings[]{
     MAKE_LITERAL_STRING(VCGETLATESTDSTXBLOCK),
     MAKE_LITERAL_STRING(FORWARDTXN),
     MAKE_LITERAL_STRING(GETGUARDNODENETWORKINFOUPDATE),
-    MAKE_LITERAL_STRING(SETHISTORICALDB)};
-
-static_assert(ARRAY_SIZE(LookupInstructionStrings) == SETHISTORICALDB + 1,
+    MAKE_LITERAL_STRING(SETHISTORICALDB),
+    MAKE_LITERAL_STRING(GETSTATESNAPSHOTMANIFESTFROMSEED),
+    MAKE_LITERAL_STRING(SETSTATESNAPSHOTMANIFESTFROMSEED),
+    MAKE_LITERAL_STRING(GETSTATESNAPSHOTCHUNKFROMSEED),
+    MAKE_LITERAL_STRING(SETSTATESNAPSHOTCHUNKFROMSEED)};
+
+static_assert(ARRAY_SIZE(LookupInstructionStrings) ==
+                  SETSTATESNAPSHOTCHUNKFROMSEED + 1,
               "LookupInstructionStrings definition is not correct");
 
 static const std::string *MessageTypeInstructionStrings[]{
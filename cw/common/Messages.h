@@ -57,6 +57,7 @@ enum NodeInstructionType : unsigned char {
   FALLBACKBLOCK = 0x0A,
   PROPOSEGASPRICE = 0x0B,
   DSGUARDNODENETWORKINFOUPDATE = 0x0C,
+  MEMPOOLSUMMARY = 0x0D,
 };
 
 enum LookupInstructionType : unsigned char {
@@ -75,8 +76,8 @@ enum LookupInstructionType : unsigned char {
   RAISESTARTPOW = 0x0C,
   GETSTARTPOWFROMSEED = 0x0D,
   SETSTARTPOWFROMSEED = 0x0E,
-  GETSHARDSFROMSEED = 0x0F,        // UNUSED
-  SETSHARDSFROMSEED = 0x10,        // UNUSED
+  GETSHARDSFROMSEED = 0x0F,
+  SETSHARDSFROMSEED = 0x10,
   GETMICROBLOCKFROMLOOKUP = 0x11,  // UNUSED
   SETMICROBLOCKFROMLOOKUP = 0x12,  // UNUSED
   GETTXNFROMLOOKUP = 0x13,         // UNUSED
@@ -90,7 +91,11 @@ enum LookupInstructionType : unsigned char {
   VCGETLATESTDSTXBLOCK = 0x1B,
   FORWARDTXN = 0x1C,
   GETGUARDNODENETWORKINFOUPDATE = 0x1D,
-  SETHISTORICALDB = 0x1E
+  SETHISTORICALDB = 0x1E,
+  GETSTATESNAPSHOTMANIFESTFROMSEED = 0x1F,
+  SETSTATESNAPSHOTMANIFESTFROMSEED = 0x20,
+  GETSTATESNAPSHOTCHUNKFROMSEED = 0x21,
+  SETSTATESNAPSHOTCHUNKFROMSEED = 0x22
 };
 
 enum TxSharingMode : unsigned char {
@@ -137,6 +137,20 @@ string LevelDB::Lookup(const std::string & key) const
     return value;
 }
 
+string LevelDB::Lookup(const std::string & key, bool &found) const
+{
+    string value;
+    leveldb::Status s = m_db->Get(leveldb::ReadOptions(), key, &value);
+
+    if (!s.ok())
+    {
+        found = false;
+        return "";
+    }
+    found = true;
+    return value;
+}
+
 string LevelDB::Lookup(const boost::multiprecision::uint256_t & blockNum) const
 {
     string value;
@@ -342,6 +356,25 @@ bool LevelDB::BatchInsert(const std::unordered_map<std::string, std::string>& kv
     return true;
 }
 
+bool LevelDB::BatchInsert(const std::vector<std::pair<dev::h256, dev::bytesConstRef>>& kvs)
+{
+    ldb::WriteBatch batch;
+
+    for (const auto & i: kvs)
+    {
+        batch.Put(leveldb::Slice(i.first.hex()), i.second);
+    }
+
+    ldb::Status s = m_db->Write(leveldb::WriteOptions(), &batch);
+
+    if (!s.ok())
+    {
+        return false;
+    }
+
+    return true;
+}
+
 bool LevelDB::Exists(const dev::h256 & key) const
 {
     auto ret = Lookup(key);
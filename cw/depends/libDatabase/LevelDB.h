@@ -58,6 +58,9 @@ public:
     /// Returns the value at the specified key.
     std::string Lookup(const std::string & key) const;
 
+    /// Returns the value at the specified key and also mark if key was found or not
+    std::string Lookup(const std::string & key, bool &found) const;
+
     /// Returns the value at the specified key.
     std::string Lookup(const boost::multiprecision::uint256_t & blockNum) const;
 
@@ -102,6 +105,9 @@ public:
 
     bool BatchInsert(const std::unordered_map<std::string, std::string>& kv_map);
 
+    /// Sets the values at the specified keys in a single write.
+    bool BatchInsert(const std::vector<std::pair<dev::h256, dev::bytesConstRef>>& kvs);
+
     /// Returns true if value corresponding to specified key exists.
     bool Exists(const dev::h256 & key) const;
     bool Exists(const boost::multiprecision::uint256_t & blockNum) const;
@@ -230,7 +230,7 @@ bool Account::SetStorage(const Address& addr,
   }
 
   if (!ContractStorage::GetContractStorage().PutContractState(
-          addr, entries, m_storageRoot, temp, revertible, {}, false)) {
+          addr, entries, m_storageRoot, temp, revertible)) {
     LOG_GENERAL(WARNING, "PutContractState failed");
     return false;
   }
@@ -246,8 +246,8 @@ string Account::GetRawStorage(const h256& k_hash, bool temp) const {
     //             "Not contract account, why call Account::GetRawStorage!");
     return "";
   }
-  return ContractStorage::GetContractStorage().GetContractStateData(k_hash,
-                                                                    temp);
+  return ContractStorage::GetContractStorage().GetContractStateData(
+      m_address, k_hash, temp);
 }
 
 bool Account::PrepareInitDataJson(const bytes& initData, const Address& addr,
@@ -315,7 +315,8 @@ Json::Value Account::GetStateJson(bool temp) const {
 }
 
 bool Account::GetStorageJson(pair<Json::Value, Json::Value>& roots, bool temp,
-                             uint32_t& scilla_version) const {
+                             uint32_t& scilla_version,
+                             uint64_t maxSizeInBytes) const {
   if (!isContract()) {
     LOG_GENERAL(WARNING,
                 "Not contract account, why call Account::GetStorageJson!");
@@ -324,7 +325,7 @@ bool Account::GetStorageJson(pair<Json::Value, Json::Value>& roots, bool temp,
 
   // Init, Other
   if (!ContractStorage::GetContractStorage().GetContractStateJson(
-          m_address, roots, scilla_version, temp)) {
+          m_address, roots, scilla_version, temp, maxSizeInBytes)) {
     LOG_GENERAL(WARNING, "ContractStorage::GetContractStateJson failed");
     return false;
   }
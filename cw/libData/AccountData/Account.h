@@ -176,9 +176,12 @@ class Account : public AccountBase {
 
   std::vector<dev::h256> GetStorageKeyHashes(bool temp = false) const;
 
+  /// Get the init and mutable states, failing if the raw states exceed
+  /// maxSizeInBytes (0 for no limit)
   bool GetStorageJson(
       std::pair<Json::Value, Json::Value>& roots, bool temp = false,
-      uint32_t& scilla_version = scilla_version_place_holder) const;
+      uint32_t& scilla_version = scilla_version_place_holder,
+      uint64_t maxSizeInBytes = 0) const;
 
   /// Computes an account address from a specified PubKey.
   static Address GetAddressFromPublicKey(const PubKey& pubKey);
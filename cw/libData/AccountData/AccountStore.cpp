@@ -116,6 +116,32 @@ bool AccountStore::Deserialize(const bytes& src, unsigned int offset) {
   return true;
 }
 
+bool AccountStore::SerializeChunks(vector<bytes>& chunks,
+                                   const unsigned int maxChunkSize) const {
+  LOG_MARKER();
+  shared_lock<shared_timed_mutex> lock(m_mutexPrimary);
+
+  if (!MessengerAccountStoreTrie::SetAccountStoreTrieChunks(
+          chunks, maxChunkSize, m_state, m_addressToAccount)) {
+    LOG_GENERAL(WARNING,
+                "MessengerAccountStoreTrie::SetAccountStoreTrieChunks failed.");
+    return false;
+  }
+
+  return true;
+}
+
+bool AccountStore::DeserializeChunk(const bytes& src, unsigned int offset) {
+  unique_lock<shared_timed_mutex> g(m_mutexPrimary);
+
+  if (!Messenger::GetAccountStore(src, offset, *this)) {
+    LOG_GENERAL(WARNING, "Messenger::GetAccountStore failed.");
+    return false;
+  }
+
+  return true;
+}
+
 bool AccountStore::SerializeDelta() {
   LOG_MARKER();
 
@@ -364,6 +390,11 @@ bool AccountStore::RetrieveFromDisk() {
   unique_lock<mutex> g2(m_mutexDB, defer_lock);
   lock(g, g2);
 
+  if (!ContractStorage::GetContractStorage().MigrateLegacyStateIndexes()) {
+    LOG_GENERAL(WARNING, "ContractStorage::MigrateLegacyStateIndexes failed");
+    return false;
+  }
+
   bytes rootBytes;
   if (!BlockStorage::GetBlockStorage().GetStateRoot(rootBytes)) {
     // To support backward compatibilty - lookup with new binary trying to
@@ -390,9 +421,101 @@ bool AccountStore::RetrieveFromDisk() {
                              << boost::diagnostic_information(e));
     return false;
   }
+
+  if (!MigrateContractStorageRoots()) {
+    LOG_GENERAL(WARNING, "MigrateContractStorageRoots failed");
+    return false;
+  }
+
   return true;
 }
 
+bool AccountStore::MigrateContractStorageRoots() {
+  // The metadata holds the state roots before and after the migration
+  bytes migration;
+  if (BlockStorage::GetBlockStorage().GetMetadata(CONTRACTSTORAGEROOTMIGRATION,
+                                                  migration)) {
+    return true;
+  }
+
+  LOG_MARKER();
+
+  const h256 legacyRoot = m_state.root();
+
+  try {
+    vector<pair<Address, Account>> contracts;
+    for (const auto& i : m_state) {
+      Account account;
+      if (!account.DeserializeBase(bytes(i.second.begin(), i.second.end()),
+                                   0)) {
+        LOG_GENERAL(WARNING, "Account::DeserializeBase failed");
+        return false;
+      }
+      if (account.isContract()) {
+        contracts.emplace_back(Address(i.first), account);
+      }
+    }
+
+    for (auto& contract : contracts) {
+      h256 storageRoot;
+      if (!ContractStorage::GetContractStorage().RebuildContractStateTrie(
+              contract.first, storageRoot)) {
+        LOG_GENERAL(WARNING, "RebuildContractStateTrie failed for contract "
+                                 << contract.first);
+        return false;
+      }
+      contract.second.SetStorageRoot(storageRoot);
+      if (!UpdateStateTrie(contract.first, contract.second)) {
+        LOG_GENERAL(WARNING, "UpdateStateTrie failed for contract "
+                                 << contract.first);
+        return false;
+      }
+    }
+
+    if (!ContractStorage::GetContractStorage().CommitStateDB()) {
+      LOG_GENERAL(WARNING, "CommitStateDB failed");
+      return false;
+    }
+
+    m_state.db()->commit();
+    m_prevRoot = m_state.root();
+    if (!MoveRootToDisk(m_prevRoot)) {
+      LOG_GENERAL(WARNING, "MoveRootToDisk failed " << m_prevRoot.hex());
+      return false;
+    }
+
+    LOG_GENERAL(INFO, "Migrated the storage roots of "
+                          << contracts.size() << " contracts, state root "
+                          << legacyRoot << " is now " << m_prevRoot);
+  } catch (const boost::exception& e) {
+    LOG_GENERAL(WARNING,
+                "Error with AccountStore::MigrateContractStorageRoots. "
+                    << boost::diagnostic_information(e));
+    return false;
+  }
+
+  migration = legacyRoot.asBytes();
+  migration.insert(migration.end(), m_prevRoot.begin(), m_prevRoot.end());
+  return BlockStorage::GetBlockStorage().PutMetadata(
+      CONTRACTSTORAGEROOTMIGRATION, migration);
+}
+
+bool AccountStore::IsMigratedFrom(const h256& blockRoot) const {
+  bytes migration;
+  if (!BlockStorage::GetBlockStorage().GetMetadata(CONTRACTSTORAGEROOTMIGRATION,
+                                                   migration) ||
+      migration.size() != 2 * h256::size) {
+    return false;
+  }
+
+  const h256 legacyRoot(bytes(migration.begin(),
+                              migration.begin() + h256::size));
+  const h256 migratedRoot(bytes(migration.begin() + h256::size,
+                                migration.end()));
+  return legacyRoot != migratedRoot && legacyRoot == blockRoot &&
+         migratedRoot == GetStateRootHash();
+}
+
 Account* AccountStore::GetAccountTemp(const Address& address) {
   return m_accountStoreTemp->GetAccount(address);
 }
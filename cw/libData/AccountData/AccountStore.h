@@ -92,6 +92,10 @@ class AccountStore
   /// Store the trie root to leveldb
   bool MoveRootToDisk(const dev::h256& root);
 
+  /// Sets the storage roots of the contracts kept with roots of the previous
+  /// format to the roots of their state tries, once per database
+  bool MigrateContractStorageRoots();
+
  public:
   /// Returns the singleton AccountStore instance.
   static AccountStore& GetInstance();
@@ -100,6 +104,14 @@ class AccountStore
 
   bool Deserialize(const bytes& src, unsigned int offset) override;
 
+  /// split the states into serialized account stores of roughly maxChunkSize
+  /// bytes each
+  bool SerializeChunks(std::vector<bytes>& chunks,
+                       const unsigned int maxChunkSize) const;
+
+  /// add the accounts of one serialized chunk to the current states
+  bool DeserializeChunk(const bytes& src, unsigned int offset);
+
   /// generate serialized raw bytes for StateDelta
   bool SerializeDelta();
 
@@ -134,6 +146,10 @@ class AccountStore
   /// repopulate the in-memory data structures from persistent storage
   bool RetrieveFromDisk();
 
+  /// Returns true if the states on disk were migrated from the state root
+  /// blockRoot to the current state root by MigrateContractStorageRoots
+  bool IsMigratedFrom(const dev::h256& blockRoot) const;
+
   Account* GetAccountTemp(const Address& address);
 
   /// update account states in AccountStoreTemp
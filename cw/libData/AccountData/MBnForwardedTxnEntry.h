@@ -26,6 +26,8 @@
 struct MBnForwardedTxnEntry {
   MicroBlock m_microBlock;
   std::vector<TransactionWithReceipt> m_transactions;
+  /// Wire bytes of m_transactions as received, kept on lookup nodes only
+  std::vector<bytes> m_serializedTransactions;
 
   friend std::ostream& operator<<(std::ostream& os,
                                   const MBnForwardedTxnEntry& t);
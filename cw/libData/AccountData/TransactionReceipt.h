@@ -121,17 +121,24 @@ class TransactionWithReceipt : public SerializableDataBlock {
       const std::vector<TxnHash>& txnOrder,
       std::unordered_map<TxnHash, TransactionWithReceipt>& txrs,
       TxnHash& trHash) {
-    std::vector<TransactionWithReceipt> vec;
+    if (txnOrder.empty()) {
+      LOG_GENERAL(INFO, "txrs is empty");
+      trHash = TxnHash();
+      return true;
+    }
 
+    // Hash the receipts in place instead of copying every txn
+    SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
     for (const auto& th : txnOrder) {
       auto it = txrs.find(th);
       if (it == txrs.end()) {
         LOG_GENERAL(WARNING, "Missing txnHash " << th);
         return false;
       }
-      vec.emplace_back(it->second);
+      sha2.Update(DataConversion::StringToCharArray(
+          it->second.GetTransactionReceipt().GetString()));
     }
-    trHash = ComputeTransactionReceiptsHash(vec);
+    trHash = TxnHash(sha2.Finalize());
     return true;
   }
 };
@@ -27,10 +27,10 @@
 
 struct TxnPool {
   struct PubKeyNonceHash {
-    std::size_t operator()(const std::pair<PubKey, uint128_t>& p) const {
+    std::size_t operator()(const std::pair<PubKey, uint64_t>& p) const {
       std::size_t seed = 0;
       boost::hash_combine(seed, std::string(p.first));
-      boost::hash_combine(seed, p.second.convert_to<std::string>());
+      boost::hash_combine(seed, p.second);
 
       return seed;
     }
@@ -18,96 +18,129 @@
 #ifndef __BLOCKCHAIN_H__
 #define __BLOCKCHAIN_H__
 
+#include <atomic>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 #include "libData/BlockData/Block/DSBlock.h"
-#include "libData/DataStructures/CircularArray.h"
 #include "libPersistence/BlockStorage.h"
 
 /// Transient storage for DS/Tx/ Blocks. The block should have function
 /// .GetHeader().GetBlockNum()
+/// Blocks are held as immutable shared objects. Writers swap them in under
+/// m_mutexBlocks, while readers only atomically load the pointers and never
+/// block on or copy the stored blocks.
 template <class T>
 class BlockChain {
   std::mutex m_mutexBlocks;
-  CircularArray<T> m_blocks;
+  std::vector<std::shared_ptr<const T>> m_blocks;
+  std::shared_ptr<const T> m_lastBlock;
+
+  /// number of blocks stored till now, including missed ones
+  std::atomic<uint64_t> m_blockCount{0};
 
  protected:
   /// Constructor.
-  BlockChain() { Reset(); }
+  BlockChain() : m_blocks(BLOCKCHAIN_SIZE) {}
 
   ~BlockChain() {}
 
-  virtual T GetBlockFromPersistentStorage(const uint64_t& blockNum) = 0;
+  virtual std::shared_ptr<const T> GetBlockFromPersistentStorage(
+      const uint64_t& blockNum) = 0;
 
  public:
   /// Reset
-  void Reset() { m_blocks.resize(BLOCKCHAIN_SIZE); }
-
-  /// Returns the number of blocks.
-  uint64_t GetBlockCount() {
+  void Reset() {
     std::lock_guard<std::mutex> g(m_mutexBlocks);
-    return m_blocks.size();
+    for (auto& block : m_blocks) {
+      std::atomic_store(&block, std::shared_ptr<const T>());
+    }
+    std::atomic_store(&m_lastBlock, std::shared_ptr<const T>());
+    m_blockCount = 0;
   }
 
+  /// Returns the number of blocks.
+  uint64_t GetBlockCount() { return m_blockCount; }
+
   /// Returns the last stored block.
-  T GetLastBlock() {
-    std::lock_guard<std::mutex> g(m_mutexBlocks);
-    try {
-      return m_blocks.back();
-    } catch (...) {
-      return T();
+  std::shared_ptr<const T> GetLastBlockPtr() {
+    auto lastBlock = std::atomic_load(&m_lastBlock);
+    if (!lastBlock) {
+      return std::make_shared<const T>();
     }
+    return lastBlock;
   }
 
   /// Returns the block at the specified block number.
-  T GetBlock(const uint64_t& blockNum) {
-    std::lock_guard<std::mutex> g(m_mutexBlocks);
+  std::shared_ptr<const T> GetBlockPtr(const uint64_t& blockNum) {
+    const auto lastBlock = std::atomic_load(&m_lastBlock);
 
-    if (m_blocks.size() > 0 &&
-        (m_blocks.back().GetHeader().GetBlockNum() < blockNum)) {
+    if (lastBlock && (lastBlock->GetHeader().GetBlockNum() < blockNum)) {
       LOG_GENERAL(WARNING,
                   "BlockNum too high " << blockNum << " Dummy block used");
-      return T();
+      return std::make_shared<const T>();
     }
 
-    else if (blockNum + m_blocks.capacity() < m_blocks.size()) {
+    else if (blockNum + m_blocks.size() < m_blockCount) {
       return GetBlockFromPersistentStorage(blockNum);
     }
 
-    if (m_blocks[blockNum].GetHeader().GetBlockNum() != blockNum) {
+    const auto block = std::atomic_load(&m_blocks[blockNum % m_blocks.size()]);
+    const uint64_t blockNumOfBlock =
+        block ? block->GetHeader().GetBlockNum() : INIT_BLOCK_NUMBER;
+
+    if (blockNumOfBlock != blockNum) {
       LOG_GENERAL(WARNING,
                   "BlockNum : " << blockNum << " != GetBlockNum() : "
-                                << m_blocks[blockNum].GetHeader().GetBlockNum()
+                                << blockNumOfBlock
                                 << ", a dummy block will be used and abnormal "
                                    "behavior may happen!");
-      return T();
+      return std::make_shared<const T>();
     }
-    return m_blocks[blockNum];
+    return block;
   }
+
+  /// Returns a copy of the last stored block, for callers that modify it.
+  T GetLastBlock() { return *GetLastBlockPtr(); }
+
+  /// Returns a copy of the block at the specified block number, for callers
+  /// that modify it.
+  T GetBlock(const uint64_t& blockNum) { return *GetBlockPtr(blockNum); }
+
   /// Adds a block to the chain.
   int AddBlock(const T& block) {
-    uint64_t blockNumOfNewBlock = block.GetHeader().GetBlockNum();
+    return AddBlock(std::make_shared<const T>(block));
+  }
+
+  /// Adds a block to the chain without copying it.
+  int AddBlock(const std::shared_ptr<const T>& block) {
+    uint64_t blockNumOfNewBlock = block->GetHeader().GetBlockNum();
 
     std::lock_guard<std::mutex> g(m_mutexBlocks);
 
+    auto& slot = m_blocks[blockNumOfNewBlock % m_blocks.size()];
     uint64_t blockNumOfExistingBlock =
-        m_blocks[blockNumOfNewBlock].GetHeader().GetBlockNum();
+        slot ? slot->GetHeader().GetBlockNum() : INIT_BLOCK_NUMBER;
 
     if (blockNumOfExistingBlock < blockNumOfNewBlock ||
         INIT_BLOCK_NUMBER == blockNumOfExistingBlock) {
-      if (m_blocks.size() > 0) {
-        uint64_t blockNumOfLastBlock =
-            m_blocks.back().GetHeader().GetBlockNum();
+      if (m_blockCount > 0 && m_lastBlock) {
+        uint64_t blockNumOfLastBlock = m_lastBlock->GetHeader().GetBlockNum();
         uint64_t blockNumMissed = blockNumOfNewBlock - blockNumOfLastBlock - 1;
         if (blockNumMissed > 0) {
           LOG_GENERAL(INFO,
-                      "block number inconsistent, increase the size of "
-                      "CircularArray, blockNumMissed: "
+                      "block number inconsistent, increase the block count, "
+                      "blockNumMissed: "
                           << blockNumMissed);
-          m_blocks.increase_size(blockNumMissed);
+          m_blockCount += blockNumMissed;
         }
       }
-      m_blocks.insert_new(blockNumOfNewBlock, block);
+      // Counted first, so that GetBlockPtr reads the block evicted from the
+      // slot from persistent storage instead of getting the new one
+      m_blockCount++;
+      std::atomic_store(&slot, block);
+      std::atomic_store(&m_lastBlock, block);
     } else {
       LOG_GENERAL(WARNING, "Failed to add " << blockNumOfNewBlock << " "
                                             << blockNumOfExistingBlock);
@@ -120,33 +153,35 @@ class BlockChain {
 
 class DSBlockChain : public BlockChain<DSBlock> {
  public:
-  DSBlock GetBlockFromPersistentStorage(const uint64_t& blockNum) {
+  std::shared_ptr<const DSBlock> GetBlockFromPersistentStorage(
+      const uint64_t& blockNum) {
     DSBlockSharedPtr block;
     if (!BlockStorage::GetBlockStorage().GetDSBlock(blockNum, block)) {
       LOG_GENERAL(WARNING, "BlockNum not in persistent storage "
                                << blockNum << " Dummy block used");
-      return DSBlock();
+      return std::make_shared<const DSBlock>();
     }
-    return *block;
+    return block;
   }
 };
 
 class TxBlockChain : public BlockChain<TxBlock> {
  public:
-  TxBlock GetBlockFromPersistentStorage(const uint64_t& blockNum) {
+  std::shared_ptr<const TxBlock> GetBlockFromPersistentStorage(
+      const uint64_t& blockNum) {
     TxBlockSharedPtr block;
     if (!BlockStorage::GetBlockStorage().GetTxBlock(blockNum, block)) {
       LOG_GENERAL(WARNING, "BlockNum not in persistent storage "
                                << blockNum << " Dummy block used");
-      return TxBlock();
+      return std::make_shared<const TxBlock>();
     }
-    return *block;
+    return block;
   }
 };
 
 class VCBlockChain : public BlockChain<VCBlock> {
  public:
-  VCBlock GetBlockFromPersistentStorage([
+  std::shared_ptr<const VCBlock> GetBlockFromPersistentStorage([
       [gnu::unused]] const uint64_t& blockNum) {
     throw "vc block persistent storage not supported";
   }
@@ -154,7 +189,7 @@ class VCBlockChain : public BlockChain<VCBlock> {
 
 class FallbackBlockChain : public BlockChain<FallbackBlock> {
  public:
-  FallbackBlock GetBlockFromPersistentStorage([
+  std::shared_ptr<const FallbackBlock> GetBlockFromPersistentStorage([
       [gnu::unused]] const uint64_t& blockNum) {
     throw "fallback block persistent storage not supported";
   }
@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __BYTESCACHE_H__
+#define __BYTESCACHE_H__
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "common/BaseType.h"
+
+/// Utility class - thread-safe LRU cache of immutable byte buffers, bounded by
+/// the total number of bytes held rather than by the number of entries.
+template <class Key>
+class BytesCache {
+  using Entry = std::pair<Key, std::shared_ptr<const bytes>>;
+
+  std::list<Entry> m_entries;  // most recently used at the front
+  std::map<Key, typename std::list<Entry>::iterator> m_index;
+  uint64_t m_sizeInBytes;
+  uint64_t m_capacityInBytes;
+  mutable std::mutex m_mutex;
+
+  void EvictIfNeeded() {
+    while (m_sizeInBytes > m_capacityInBytes && !m_entries.empty()) {
+      const Entry& last = m_entries.back();
+      m_sizeInBytes -= last.second->size();
+      m_index.erase(last.first);
+      m_entries.pop_back();
+    }
+  }
+
+ public:
+  /// Constructor.
+  explicit BytesCache(uint64_t capacityInBytes)
+      : m_sizeInBytes(0), m_capacityInBytes(capacityInBytes) {}
+
+  BytesCache(const BytesCache<Key>& bytesCache) = delete;
+
+  BytesCache& operator=(const BytesCache<Key>& bytesCache) = delete;
+
+  /// Returns the cached buffer for the key, or nullptr if absent.
+  std::shared_ptr<const bytes> Get(const Key& key) {
+    std::lock_guard<std::mutex> g(m_mutex);
+
+    auto it = m_index.find(key);
+    if (it == m_index.end()) {
+      return nullptr;
+    }
+
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return it->second->second;
+  }
+
+  /// Adds or replaces the buffer for the key, evicting the least recently
+  /// used entries once the byte budget is exceeded. Buffers larger than the
+  /// whole budget are not cached.
+  void Put(const Key& key, const std::shared_ptr<const bytes>& value) {
+    if (value == nullptr || value->size() > m_capacityInBytes) {
+      return;
+    }
+
+    std::lock_guard<std::mutex> g(m_mutex);
+
+    auto it = m_index.find(key);
+    if (it != m_index.end()) {
+      m_sizeInBytes -= it->second->second->size();
+      m_entries.erase(it->second);
+      m_index.erase(it);
+    }
+
+    m_entries.emplace_front(key, value);
+    m_index[key] = m_entries.begin();
+    m_sizeInBytes += value->size();
+
+    EvictIfNeeded();
+  }
+
+  /// Removes all entries.
+  void Clear() {
+    std::lock_guard<std::mutex> g(m_mutex);
+    m_entries.clear();
+    m_index.clear();
+    m_sizeInBytes = 0;
+  }
+
+  /// Returns the total number of bytes currently held.
+  uint64_t SizeInBytes() const {
+    std::lock_guard<std::mutex> g(m_mutex);
+    return m_sizeInBytes;
+  }
+};
+
+#endif  // __BYTESCACHE_H__
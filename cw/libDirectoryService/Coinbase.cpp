@@ -376,7 +376,7 @@ void DirectoryService::InitCoinbase() {
   // LuckyDraw
 
   uint16_t lastBlockHash = DataConversion::charArrTo16Bits(
-      m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes());
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetBlockHash().asBytes());
   DiagnosticDataCoinbase entry = {
       node_count,  sig_count,        lookup_count, total_reward,
       base_reward, base_reward_each, lookupReward, reward_each_lookup,
@@ -420,12 +420,12 @@ void DirectoryService::StoreCoinbaseInDiagnosticDB(
   if ((MAX_ENTRIES_FOR_DIAGNOSTIC_DATA > 0) &&  // If limit is 0, skip deletion
       (BlockStorage::GetBlockStorage().GetDiagnosticDataCoinbaseCount() >=
        MAX_ENTRIES_FOR_DIAGNOSTIC_DATA) &&  // Limit reached
-      (m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() >=
+      (m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum() >=
        MAX_ENTRIES_FOR_DIAGNOSTIC_DATA)) {  // DS Block number is not below
                                             // limit
 
     const uint64_t oldBlockNum =
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() -
+        m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum() -
         MAX_ENTRIES_FOR_DIAGNOSTIC_DATA;
 
     canPutNewEntry =
@@ -443,7 +443,7 @@ void DirectoryService::StoreCoinbaseInDiagnosticDB(
 
   if (canPutNewEntry) {
     BlockStorage::GetBlockStorage().PutDiagnosticDataCoinbase(
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum(),
+        m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum(),
         entry);
   }
 }
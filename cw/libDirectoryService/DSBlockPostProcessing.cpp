@@ -103,6 +103,12 @@ bool DirectoryService::StoreDSBlockToStorage() {
   return true;
 }
 
+bool DirectoryService::UseShardingStructureDelta(
+    const uint64_t& dsBlockNum) const {
+  return !m_prevShards.empty() &&
+         dsBlockNum % SHARDINGSTRUCTURE_SNAPSHOT_INTERVAL != 0;
+}
+
 bool DirectoryService::ComposeDSBlockMessageForSender(bytes& dsblock_message) {
   if (LOOKUP_NODE_MODE) {
     LOG_GENERAL(WARNING,
@@ -162,6 +168,17 @@ void DirectoryService::SendDSBlockToShardNodes(
 
   LOG_MARKER();
 
+  bool sendDelta = false;
+  DequeOfShard prevShards;
+  {
+    lock_guard<mutex> g(m_mutexShards);
+    sendDelta =
+        UseShardingStructureDelta(m_pendingDSBlock->GetHeader().GetBlockNum());
+    if (sendDelta) {
+      prevShards = m_prevShards;
+    }
+  }
+
   auto p = shards.begin();
   advance(p, my_shards_lo);
 
@@ -172,10 +189,19 @@ void DirectoryService::SendDSBlockToShardNodes(
 
     bytes dsblock_message_to_shard = {MessageType::NODE,
                                       NodeInstructionType::DSBLOCK};
-    if (!Messenger::SetNodeVCDSBlocksMessage(
-            dsblock_message_to_shard, MessageOffset::BODY, shardId,
-            *m_pendingDSBlock, m_VCBlockVector, SHARDINGSTRUCTURE_VERSION,
-            m_shards)) {
+    bool result;
+    if (sendDelta) {
+      result = Messenger::SetNodeVCDSBlocksMessage(
+          dsblock_message_to_shard, MessageOffset::BODY, shardId,
+          *m_pendingDSBlock, m_VCBlockVector, SHARDINGSTRUCTURE_VERSION,
+          m_shards, prevShards);
+    } else {
+      result = Messenger::SetNodeVCDSBlocksMessage(
+          dsblock_message_to_shard, MessageOffset::BODY, shardId,
+          *m_pendingDSBlock, m_VCBlockVector, SHARDINGSTRUCTURE_VERSION,
+          m_shards);
+    }
+    if (!result) {
       LOG_EPOCH(
           WARNING, m_mediator.m_currentEpochNum,
           "Messenger::SetNodeVCDSBlocksMessage failed. " << *m_pendingDSBlock);
@@ -233,8 +259,8 @@ void DirectoryService::SendDSBlockToShardNodes(
 
 void DirectoryService::UpdateMyDSModeAndConsensusId() {
   LOG_MARKER();
-  uint16_t numOfIncomingDs = m_mediator.m_dsBlockChain.GetLastBlock()
-                                 .GetHeader()
+  uint16_t numOfIncomingDs = m_mediator.m_dsBlockChain.GetLastBlockPtr()
+                                 ->GetHeader()
                                  .GetDSPoWWinners()
                                  .size();
 
@@ -420,7 +446,13 @@ void DirectoryService::StartFirstTxEpoch() {
     m_mediator.m_node->m_myshardId = m_shards.size();
     m_mediator.m_node->m_justDidFallback = false;
     m_mediator.m_node->CommitTxnPacketBuffer();
-    m_stateDeltaFromShards.clear();
+    {
+      lock_guard<mutex> g(m_mutexMicroBlocks);
+      m_stateDeltaFromShards.clear();
+      m_stateDeltaFromShardsDirty = false;
+      m_stateDeltaExclusiveUpdates.clear();
+      m_stateDeltaMergedShards.clear();
+    }
 
     // Start sharding work
     SetState(MICROBLOCK_SUBMISSION);
@@ -458,8 +490,8 @@ void DirectoryService::StartFirstTxEpoch() {
         LOG_STATE("[MIBLKSWAIT]["
                   << setw(15) << left
                   << m_mediator.m_selfPeer.GetPrintableIPAddress() << "]["
-                  << m_mediator.m_txBlockChain.GetLastBlock()
-                             .GetHeader()
+                  << m_mediator.m_txBlockChain.GetLastBlockPtr()
+                             ->GetHeader()
                              .GetBlockNum() +
                          1
                   << "] TIMEOUT: Didn't receive all Microblock.");
@@ -538,7 +570,7 @@ void DirectoryService::ProcessDSBlockConsensusWhenDone() {
     m_pendingDSBlock->SetCoSignatures(*m_consensusObject);
 
     if (m_pendingDSBlock->GetHeader().GetBlockNum() >
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() +
+        m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum() +
             1) {
       LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
                 "We are missing some blocks. What to do here?");
@@ -614,9 +646,12 @@ void DirectoryService::ProcessDSBlockConsensusWhenDone() {
     DataSender::GetInstance().SendDataToOthers(
         *m_pendingDSBlock, *(m_mediator.m_DSCommittee), m_shards, {},
         m_mediator.m_lookup->GetLookupNodes(),
-        m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash(),
+        m_mediator.m_txBlockChain.GetLastBlockPtr()->GetBlockHash(),
         m_consensusMyID, composeDSBlockMessageForSender, false,
         sendDSBlockToLookupNodesAndNewDSMembers, sendDSBlockToShardNodes);
+
+    lock_guard<mutex> g2(m_mutexShards);
+    m_prevShards = m_shards;
   }
 
   LOG_STATE(
@@ -629,6 +664,7 @@ void DirectoryService::ProcessDSBlockConsensusWhenDone() {
   ClearVCBlockVector();
   UpdateDSCommiteeComposition();
   UpdateMyDSModeAndConsensusId();
+  m_mediator.UpdateCommitteeView();
 
   if (m_mediator.m_DSCommittee->at(GetConsensusLeaderID()).first ==
       m_mediator.m_selfKey.second) {
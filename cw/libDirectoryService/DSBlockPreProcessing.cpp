@@ -35,6 +35,7 @@
 #include "libUtils/DataConversion.h"
 #include "libUtils/DetachedFunction.h"
 #include "libUtils/HashUtils.h"
+#include "libUtils/JoinableFunction.h"
 #include "libUtils/Logger.h"
 #include "libUtils/SanityChecks.h"
 #include "libUtils/ShardSizeCalculator.h"
@@ -96,8 +97,8 @@ unsigned int DirectoryService::ComputeDSBlockParameters(
         m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDSDifficulty());
     LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
               "Current DS difficulty "
-                  << std::to_string(m_mediator.m_dsBlockChain.GetLastBlock()
-                                        .GetHeader()
+                  << std::to_string(m_mediator.m_dsBlockChain.GetLastBlockPtr()
+                                        ->GetHeader()
                                         .GetDSDifficulty())
                   << ", new DS difficulty " << std::to_string(dsDifficulty));
 
@@ -105,8 +106,8 @@ unsigned int DirectoryService::ComputeDSBlockParameters(
         m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDifficulty());
     LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
               "Current difficulty "
-                  << std::to_string(m_mediator.m_dsBlockChain.GetLastBlock()
-                                        .GetHeader()
+                  << std::to_string(m_mediator.m_dsBlockChain.GetLastBlockPtr()
+                                        ->GetHeader()
                                         .GetDifficulty())
                   << ", new difficulty " << std::to_string(difficulty));
   }
@@ -161,7 +162,7 @@ void DirectoryService::ComputeSharding(const VectorOfPoWSoln& sortedPoWSolns) {
 
   if (m_mediator.m_currentEpochNum > 1) {
     lastBlockHash =
-        m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes();
+        m_mediator.m_txBlockChain.GetLastBlockPtr()->GetBlockHash().asBytes();
   }
 
   bytes hashVec(BLOCK_HASH_SIZE + POW_SIZE);
@@ -301,8 +302,8 @@ bool DirectoryService::VerifyPoWWinner(
                       << ". Will continue look for it in PoW from leader.");
       if (dsWinnerPoWsFromLeader.find(DSPowWinner.first) !=
           dsWinnerPoWsFromLeader.end()) {
-        uint8_t expectedDSDiff = m_mediator.m_dsBlockChain.GetLastBlock()
-                                     .GetHeader()
+        uint8_t expectedDSDiff = m_mediator.m_dsBlockChain.GetLastBlockPtr()
+                                     ->GetHeader()
                                      .GetDSDifficulty();
         const auto& peer = m_allPoWConns.at(DSPowWinner.first);
         const auto& dsPowSoln = dsWinnerPoWsFromLeader.at(DSPowWinner.first);
@@ -367,7 +368,7 @@ bool DirectoryService::VerifyDifficulty() {
 
   auto remoteDifficulty = m_pendingDSBlock->GetHeader().GetDifficulty();
   auto localDifficulty = CalculateNewDifficulty(
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDifficulty());
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetDifficulty());
   uint32_t difficultyDiff = std::max(remoteDifficulty, localDifficulty) -
                             std::min(remoteDifficulty, localDifficulty);
   LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
@@ -393,7 +394,7 @@ bool DirectoryService::VerifyPoWOrdering(
 
   if (m_mediator.m_currentEpochNum > 1) {
     lastBlockHash =
-        m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes();
+        m_mediator.m_txBlockChain.GetLastBlockPtr()->GetBlockHash().asBytes();
   }
 
   const float MISORDER_TOLERANCE =
@@ -421,6 +422,89 @@ bool DirectoryService::VerifyPoWOrdering(
     }
   }
 
+  // Index the PoW result of every shard node up front. Solutions that are
+  // only in the announcement are collected and verified in parallel.
+  unordered_map<PubKey, std::array<unsigned char, 32>> powResults;
+  for (const auto& pairPoWKey : sortedPoWSolns) {
+    powResults.emplace(pairPoWKey.second, pairPoWKey.first);
+  }
+
+  vector<pair<PubKey, Peer>> powsToVerify;
+  for (const auto& shard : shards) {
+    for (const auto& shardNode : shard) {
+      const PubKey& toFind = std::get<SHARD_NODE_PUBKEY>(shardNode);
+      if (powResults.find(toFind) != powResults.end()) {
+        continue;
+      }
+
+      LOG_GENERAL(WARNING, "Failed to find key in the PoW ordering "
+                               << toFind << " " << sortedPoWSolns.size());
+
+      auto localPoW = m_allPoWs.find(toFind);
+      if (localPoW != m_allPoWs.end()) {
+        powResults.emplace(toFind, localPoW->second.result);
+        LOG_GENERAL(INFO, "Found the PoW from local PoW list");
+      } else if (allPoWsFromLeader.find(toFind) != allPoWsFromLeader.end()) {
+        powsToVerify.emplace_back(toFind, std::get<SHARD_NODE_PEER>(shardNode));
+      } else {
+        LOG_GENERAL(INFO, "Key also not in the PoWs in the announcement.");
+        return false;
+      }
+    }
+  }
+
+  if (!powsToVerify.empty()) {
+    LOG_GENERAL(INFO, "Verifying " << powsToVerify.size()
+                                   << " PoWs from the announcement");
+
+    vector<unsigned char> verified(powsToVerify.size(), 0);
+    vector<unsigned char> isDSPoW(powsToVerify.size(), 0);
+    atomic<unsigned int> next{0};
+    atomic<bool> failed{false};
+    auto verifyFunc = [this, &next, &failed, &powsToVerify, &allPoWsFromLeader,
+                       &verified, &isDSPoW]() mutable -> void {
+      for (unsigned int i = next++; i < powsToVerify.size() && !failed;
+           i = next++) {
+        const auto& pubKey = powsToVerify.at(i).first;
+        bool dsPoW = false;
+        if (!VerifyPoWFromLeader(powsToVerify.at(i).second, pubKey,
+                                 allPoWsFromLeader.at(pubKey), dsPoW)) {
+          failed = true;
+          return;
+        }
+        verified.at(i) = 1;
+        isDSPoW.at(i) = dsPoW;
+      }
+    };
+    // hardware_concurrency() may return 0, always start at least one worker
+    const unsigned int numVerifiers = max<unsigned int>(
+        1, min<unsigned int>(powsToVerify.size(),
+                             thread::hardware_concurrency()));
+    JoinableFunction verifiers(numVerifiers, verifyFunc);
+    verifiers.join();
+
+    for (unsigned int i = 0; i < powsToVerify.size(); i++) {
+      if (!verified.at(i)) {
+        continue;
+      }
+      const auto& pubKey = powsToVerify.at(i).first;
+      const auto& powSoln = allPoWsFromLeader.at(pubKey);
+      {
+        lock_guard<mutex> lock(m_mutexAllPOW);
+        m_allPoWs[pubKey] = powSoln;
+      }
+      m_allPoWConns.emplace(pubKey, powsToVerify.at(i).second);
+      if (isDSPoW.at(i)) {
+        AddDSPoWs(pubKey, powSoln);
+      }
+      powResults.emplace(pubKey, powSoln.result);
+    }
+
+    if (failed) {
+      return false;
+    }
+  }
+
   bytes hashVec(BLOCK_HASH_SIZE + BLOCK_HASH_SIZE);
   std::copy(lastBlockHash.begin(), lastBlockHash.end(), hashVec.begin());
   bool ret = true;
@@ -428,44 +512,15 @@ bool DirectoryService::VerifyPoWOrdering(
   uint32_t misorderNodes = 0;
   for (const auto& shard : shards) {
     for (const auto& shardNode : shard) {
-      const PubKey& toFind = std::get<SHARD_NODE_PUBKEY>(shardNode);
-      auto it = std::find_if(
-          sortedPoWSolns.cbegin(), sortedPoWSolns.cend(),
-          [&toFind](
-              const std::pair<std::array<unsigned char, 32>, PubKey>& item) {
-            return item.second == toFind;
-          });
-
-      std::array<unsigned char, 32> result;
-      if (it == sortedPoWSolns.cend()) {
-        LOG_GENERAL(WARNING, "Failed to find key in the PoW ordering "
-                                 << toFind << " " << sortedPoWSolns.size());
-
-        if (m_allPoWs.find(toFind) != m_allPoWs.end()) {
-          result = m_allPoWs.at(toFind).result;
-          LOG_GENERAL(INFO, "Found the PoW from local PoW list");
-        } else {
-          LOG_GENERAL(INFO,
-                      "Checking for the key and PoW in the announcement...");
-          auto pubKeyToPoW = allPoWsFromLeader.find(toFind);
-          if (pubKeyToPoW != allPoWsFromLeader.end()) {
-            const auto& peer = std::get<SHARD_NODE_PEER>(shardNode);
-            const auto& powSoln = pubKeyToPoW->second;
-            if (VerifyPoWFromLeader(peer, pubKeyToPoW->first, powSoln)) {
-              result = powSoln.result;
-            } else {
-              ret = false;
-              break;
-            }
-          } else {
-            LOG_GENERAL(INFO, "Key also not in the PoWs in the announcement.");
-            ret = false;
-            break;
-          }
-        }
-      } else {
-        result = it->first;
+      const auto resultIt =
+          powResults.find(std::get<SHARD_NODE_PUBKEY>(shardNode));
+      if (resultIt == powResults.end()) {
+        LOG_GENERAL(WARNING, "No PoW result for shard node "
+                                 << std::get<SHARD_NODE_PUBKEY>(shardNode));
+        ret = false;
+        break;
       }
+      const auto& result = resultIt->second;
 
       auto r = keyset.insert(std::get<SHARD_NODE_PUBKEY>(shardNode));
       if (!r.second) {
@@ -528,7 +583,8 @@ bool DirectoryService::VerifyPoWOrdering(
 
 bool DirectoryService::VerifyPoWFromLeader(const Peer& peer,
                                            const PubKey& pubKey,
-                                           const PoWSolution& powSoln) {
+                                           const PoWSolution& powSoln,
+                                           bool& isDSPoW) {
   auto headerHash = POW::GenHeaderHash(
       m_mediator.m_dsBlockRand, m_mediator.m_txBlockRand, peer.m_ipAddress,
       pubKey, powSoln.lookupId, powSoln.gasPrice);
@@ -536,8 +592,8 @@ bool DirectoryService::VerifyPoWFromLeader(const Peer& peer,
   auto difficulty =
       (GUARD_MODE && Guard::GetInstance().IsNodeInShardGuardList(pubKey))
           ? (POW_DIFFICULTY / POW_DIFFICULTY)
-          : m_mediator.m_dsBlockChain.GetLastBlock()
-                .GetHeader()
+          : m_mediator.m_dsBlockChain.GetLastBlockPtr()
+                ->GetHeader()
                 .GetDifficulty();
 
   string resultStr, mixHashStr;
@@ -557,18 +613,12 @@ bool DirectoryService::VerifyPoWFromLeader(const Peer& peer,
     return false;
   }
 
-  m_allPoWs[pubKey] = powSoln;
-
-  m_allPoWConns.emplace(pubKey, peer);
-
   auto dsDifficulty =
       m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDSDifficulty();
 
-  if (POW::GetInstance().PoWVerify(m_pendingDSBlock->GetHeader().GetBlockNum(),
-                                   dsDifficulty, headerHash, powSoln.nonce,
-                                   resultStr, mixHashStr)) {
-    AddDSPoWs(pubKey, powSoln);
-  }
+  isDSPoW = POW::GetInstance().PoWVerify(
+      m_pendingDSBlock->GetHeader().GetBlockNum(), dsDifficulty, headerHash,
+      powSoln.nonce, resultStr, mixHashStr);
   return true;
 }
 
@@ -878,7 +928,7 @@ bool DirectoryService::RunConsensusOnDSBlockWhenDSPrimary() {
   // Create new consensus object
   uint32_t consensusID = 0;
   m_consensusBlockHash =
-      m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes();
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetBlockHash().asBytes();
 
 #ifdef VC_TEST_DS_SUSPEND_1
   if (m_mode == PRIMARY_DS && m_viewChangeCounter < 1) {
@@ -1098,9 +1148,9 @@ bool DirectoryService::RunConsensusOnDSBlockWhenDSBackup() {
 
 #ifdef VC_TEST_VC_PRECHECK_1
   uint64_t dsCurBlockNum =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
   uint64_t txCurBlockNum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
 
   // FIXME: Prechecking not working due at epoch 1 due to the way we have low
   // blocknum
@@ -1122,7 +1172,7 @@ bool DirectoryService::RunConsensusOnDSBlockWhenDSBackup() {
   // Dummy values for now
   uint32_t consensusID = 0x0;
   m_consensusBlockHash =
-      m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes();
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetBlockHash().asBytes();
 
   auto func = [this](const bytes& input, unsigned int offset, bytes& errorMsg,
                      const uint32_t consensusID, const uint64_t blockNumber,
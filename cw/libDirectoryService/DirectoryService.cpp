@@ -286,8 +286,8 @@ bool DirectoryService::ProcessSetPrimary(const bytes& message,
   }
 
   LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
-            "START OF EPOCH " << m_mediator.m_dsBlockChain.GetLastBlock()
-                                         .GetHeader()
+            "START OF EPOCH " << m_mediator.m_dsBlockChain.GetLastBlockPtr()
+                                         ->GetHeader()
                                          .GetBlockNum() +
                                      1);
 
@@ -353,9 +353,9 @@ bool DirectoryService::CheckWhetherDSBlockIsFresh(const uint64_t dsblock_num) {
   }
 
   // uint128_t latest_block_num_in_blockchain =
-  // m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+  // m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
   uint64_t latest_block_num_in_blockchain =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
 
   if (dsblock_num < latest_block_num_in_blockchain + 1) {
     LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
@@ -417,7 +417,11 @@ bool DirectoryService::CleanVariables() {
 
   LOG_MARKER();
 
-  m_shards.clear();
+  {
+    lock_guard<mutex> g(m_mutexShards);
+    m_shards.clear();
+    m_prevShards.clear();
+  }
   m_publicKeyToshardIdMap.clear();
   m_allPoWConns.clear();
   m_mapNodeReputation.clear();
@@ -426,6 +430,7 @@ bool DirectoryService::CleanVariables() {
     lock_guard<mutex> g(m_mediator.m_mutexDSCommittee);
     m_mediator.m_DSCommittee->clear();
   }
+  m_mediator.UpdateCommitteeView();
 
   m_stopRecvNewMBSubmission = false;
   m_startedRunFinalblockConsensus = false;
@@ -546,6 +551,7 @@ bool DirectoryService::FinishRejoinAsDS() {
       P2PComm::GetInstance().InitializeRumorManager(peers, pubKeys);
     }
   }
+  m_mediator.UpdateCommitteeView();
 
   if (m_awaitingToSubmitNetworkInfoUpdate && GUARD_MODE) {
     UpdateDSGuardIdentity();
@@ -1128,27 +1134,9 @@ void DirectoryService::GetEntireNetworkPeerInfo(VectorOfNode& peers,
 }
 
 bool DirectoryService::CheckIfDSNode(const PubKey& submitterPubKey) {
-  lock_guard<mutex> g(m_mediator.m_mutexDSCommittee);
-
-  for (const auto& dsMember : *m_mediator.m_DSCommittee) {
-    if (dsMember.first == submitterPubKey) {
-      return true;
-    }
-  }
-
-  return false;
+  return m_mediator.GetCommitteeView()->IsDSNode(submitterPubKey);
 }
 
 bool DirectoryService::CheckIfShardNode(const PubKey& submitterPubKey) {
-  lock_guard<mutex> g(m_mutexShards);
-
-  for (const auto& shard : m_shards) {
-    for (const auto& node : shard) {
-      if (std::get<SHARD_NODE_PUBKEY>(node) == submitterPubKey) {
-        return true;
-      }
-    }
-  }
-
-  return false;
+  return m_mediator.GetCommitteeView()->IsShardNode(submitterPubKey);
 }
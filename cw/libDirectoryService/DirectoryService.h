@@ -99,6 +99,10 @@ const int LOOKUP_REWARD = -2;
 using VectorOfPoWSoln =
     std::vector<std::pair<std::array<unsigned char, 32>, PubKey>>;
 using MapOfPubKeyPoW = std::map<PubKey, PoWSolution>;
+/// Microblock hash and accounts exclusively updated by the state delta of each
+/// shard, by shard ID
+using StateDeltaExclusiveUpdates =
+    std::map<uint32_t, std::pair<BlockHash, std::vector<Address>>>;
 
 /// Implements Directory Service functionality including PoW verification, DS,
 /// Tx Block Consensus and sharding management.
@@ -287,8 +291,10 @@ class DirectoryService : public Executable {
   bool VerifyPoWOrdering(const DequeOfShard& shards,
                          const MapOfPubKeyPoW& allPoWsFromLeader,
                          const MapOfPubKeyPoW& priorityNodePoWs);
+  /// Checks a PoW solution announced by the leader without recording it.
+  /// Safe to call from several threads.
   bool VerifyPoWFromLeader(const Peer& peer, const PubKey& pubKey,
-                           const PoWSolution& powSoln);
+                           const PoWSolution& powSoln, bool& isDSPoW);
   bool VerifyNodePriority(const DequeOfShard& shards,
                           MapOfPubKeyPoW& priorityNodePoWs);
 
@@ -332,9 +338,18 @@ class DirectoryService : public Executable {
                                   uint128_t& allRewards, uint32_t& numTxs);
   bool VerifyMicroBlockCoSignature(const MicroBlock& microBlock,
                                    uint32_t shardId);
+  bool VerifyStateDelta(const bytes& stateDelta,
+                        const StateHash& microBlockStateDeltaHash,
+                        std::vector<Address>& exclusiveUpdates);
   bool ProcessStateDelta(const bytes& stateDelta,
                          const StateHash& microBlockStateDeltaHash,
-                         const BlockHash& microBlockHash);
+                         const BlockHash& microBlockHash,
+                         const uint32_t shardId,
+                         const std::vector<Address>& exclusiveUpdates);
+  bool ResolveStateDeltaConflicts();
+  bool MergeStateDeltas(const std::set<uint32_t>& shards);
+  bool AlignStateDeltasWithFinalBlock(bool& changed);
+  bool SerializeStateDeltaFromShards();
   void SkipDSMicroBlock();
   void PrepareRunConsensusOnFinalBlockNormal();
 
@@ -470,6 +485,10 @@ class DirectoryService : public Executable {
   DequeOfShard m_shards;
   std::map<PubKey, uint32_t> m_publicKeyToshardIdMap;
 
+  /// Sharding structure of the previous DS block, the base of the deltas
+  /// sent to shard nodes. Guarded by m_mutexShards.
+  DequeOfShard m_prevShards;
+
   // Proof of Reputation(PoR) variables.
   std::map<PubKey, uint16_t> m_mapNodeReputation;
 
@@ -488,6 +507,16 @@ class DirectoryService : public Executable {
   /// Serialized account store temp to revert to if ds microblock consensus
   /// failed
   bytes m_stateDeltaFromShards;
+  /// Whether shard state deltas were merged since m_stateDeltaFromShards was
+  /// last serialized (protected by m_mutexMicroBlocks)
+  bool m_stateDeltaFromShardsDirty = false;
+  /// Microblock hash and accounts with an exclusive update in the state delta
+  /// of each shard in the current epoch, used to resolve conflicting shard
+  /// state deltas (protected by m_mutexMicroBlocks)
+  StateDeltaExclusiveUpdates m_stateDeltaExclusiveUpdates;
+  /// Shards whose state deltas are merged in AccountStoreTemp (protected by
+  /// m_mutexMicroBlocks)
+  std::set<uint32_t> m_stateDeltaMergedShards;
 
   /// Whether ds started microblock consensus
   std::atomic<bool> m_stopRecvNewMBSubmission;
@@ -588,6 +617,10 @@ class DirectoryService : public Executable {
       std::map<PubKey, uint32_t>& publicKeyToshardIdMap,
       std::map<PubKey, uint16_t>& mapNodeReputation);
 
+  /// Whether the sharding structure of DS block dsBlockNum is sent to shard
+  /// nodes as a delta against m_prevShards. Call with m_mutexShards held.
+  bool UseShardingStructureDelta(const uint64_t& dsBlockNum) const;
+
   /// Used by PoW winner to finish setup as the next DS leader
   void StartFirstTxEpoch();
 
@@ -605,6 +638,11 @@ class DirectoryService : public Executable {
   /// the network.
   static uint8_t CalculateNodePriority(uint16_t reputation);
 
+  /// Returns the shards whose state delta updates an account exclusively
+  /// updated by a shard with a lower ID. These are left out of the final block.
+  static std::set<uint32_t> GetConflictingShards(
+      const StateDeltaExclusiveUpdates& exclusiveUpdates);
+
   /// PoW (DS block) consensus functions
   void RunConsensusOnDSBlock(bool isRejoin = false);
   bool IsDSBlockVCState(unsigned char vcBlockState);
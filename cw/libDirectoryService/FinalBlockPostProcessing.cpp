@@ -111,7 +111,7 @@ bool DirectoryService::ComposeFinalBlockMessageForSender(
   finalblock_message = {MessageType::NODE, NodeInstructionType::FINALBLOCK};
 
   const uint64_t dsBlockNumber =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
 
   bytes stateDelta;
   AccountStore::GetInstance().GetSerializedDelta(stateDelta);
@@ -182,8 +182,8 @@ void DirectoryService::ProcessFinalBlockConsensusWhenDone() {
   if (isVacuousEpoch) {
     auto writeStateToDisk = [this]() -> void {
       if (!AccountStore::GetInstance().MoveUpdatesToDisk(
-              ENABLE_REPOPULATE && (m_mediator.m_dsBlockChain.GetLastBlock()
-                                            .GetHeader()
+              ENABLE_REPOPULATE && (m_mediator.m_dsBlockChain.GetLastBlockPtr()
+                                            ->GetHeader()
                                             .GetBlockNum() %
                                         REPOPULATE_STATE_PER_N_DS ==
                                     REPOPULATE_STATE_IN_DS))) {
@@ -206,8 +206,8 @@ void DirectoryService::ProcessFinalBlockConsensusWhenDone() {
         LOG_STATE("[FLBLK][" << setw(15) << left
                              << m_mediator.m_selfPeer.GetPrintableIPAddress()
                              << "]["
-                             << m_mediator.m_txBlockChain.GetLastBlock()
-                                        .GetHeader()
+                             << m_mediator.m_txBlockChain.GetLastBlockPtr()
+                                        ->GetHeader()
                                         .GetBlockNum() +
                                     1
                              << "] FINISH WRITE STATE TO DISK");
@@ -232,7 +232,7 @@ void DirectoryService::ProcessFinalBlockConsensusWhenDone() {
   // Acquire shard receivers cosigs from MicroBlocks
   unordered_map<uint32_t, BlockBase> t_microBlocks;
   const auto& microBlocks = m_microBlocks
-      [m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum()];
+      [m_mediator.m_txBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum()];
   for (const auto& microBlock : microBlocks) {
     t_microBlocks.emplace(microBlock.GetHeader().GetShardId(), microBlock);
   }
@@ -264,7 +264,13 @@ void DirectoryService::ProcessFinalBlockConsensusWhenDone() {
 
   AccountStore::GetInstance().InitTemp();
   AccountStore::GetInstance().InitRevertibles();
-  m_stateDeltaFromShards.clear();
+  {
+    lock_guard<mutex> g(m_mutexMicroBlocks);
+    m_stateDeltaFromShards.clear();
+    m_stateDeltaFromShardsDirty = false;
+    m_stateDeltaExclusiveUpdates.clear();
+    m_stateDeltaMergedShards.clear();
+  }
   m_allPoWConns.clear();
   ClearDSPoWSolns();
   ResetPoWSubmissionCounter();
@@ -290,8 +296,8 @@ void DirectoryService::ProcessFinalBlockConsensusWhenDone() {
       LOG_STATE("[MIBLKSWAIT][" << setw(15) << left
                                 << m_mediator.m_selfPeer.GetPrintableIPAddress()
                                 << "]["
-                                << m_mediator.m_txBlockChain.GetLastBlock()
-                                           .GetHeader()
+                                << m_mediator.m_txBlockChain.GetLastBlockPtr()
+                                           ->GetHeader()
                                            .GetBlockNum() +
                                        1
                                 << "] BEGIN");
@@ -314,8 +320,8 @@ void DirectoryService::ProcessFinalBlockConsensusWhenDone() {
         LOG_STATE("[MIBLKSWAIT]["
                   << setw(15) << left
                   << m_mediator.m_selfPeer.GetPrintableIPAddress() << "]["
-                  << m_mediator.m_txBlockChain.GetLastBlock()
-                             .GetHeader()
+                  << m_mediator.m_txBlockChain.GetLastBlockPtr()
+                             ->GetHeader()
                              .GetBlockNum() +
                          1
                   << "] TIMEOUT: Didn't receive all Microblock.");
@@ -215,10 +215,10 @@ bool DirectoryService::RunConsensusOnFinalBlockWhenDSPrimary() {
   if (!m_mediator.GetIsVacuousEpoch() &&
       ((m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDifficulty() >=
             TXN_SHARD_TARGET_DIFFICULTY &&
-        m_mediator.m_dsBlockChain.GetLastBlock()
-                .GetHeader()
+        m_mediator.m_dsBlockChain.GetLastBlockPtr()
+                ->GetHeader()
                 .GetDSDifficulty() >= TXN_DS_TARGET_DIFFICULTY) ||
-       m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() >=
+       m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum() >=
            TXN_DS_TARGET_NUM)) {
     m_mediator.m_node->ProcessTransactionWhenShardLeader();
     if (!AccountStore::GetInstance().SerializeDelta()) {
@@ -263,7 +263,7 @@ bool DirectoryService::RunConsensusOnFinalBlockWhenDSPrimary() {
 
   // Create new consensus object
   m_consensusBlockHash =
-      m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes();
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetBlockHash().asBytes();
 
   auto commitErrorFunc = [this](const bytes& errorMsg,
                                 const Peer& from) mutable -> bool {
@@ -371,7 +371,7 @@ bool DirectoryService::CheckPreviousFinalBlockHash() {
 
   const BlockHash& finalblockPrevHash = m_finalBlock->GetHeader().GetPrevHash();
   BlockHash expectedPrevHash =
-      m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash();
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetBlockHash();
 
   if (finalblockPrevHash != expectedPrevHash) {
     LOG_CHECK_FAIL("Prev block hash", finalblockPrevHash, expectedPrevHash);
@@ -968,7 +968,20 @@ bool DirectoryService::FinalBlockValidator(
   if (CheckMicroBlocks(t_errorMsg, true,
                        false)) {  // Firstly check whether the leader
                                   // has any mb that I don't have
+    bool stateDeltasChanged = false;
+    if (!AlignStateDeltasWithFinalBlock(stateDeltasChanged)) {
+      LOG_GENERAL(WARNING, "AlignStateDeltasWithFinalBlock failed");
+      m_mediator.m_node->m_microblock = nullptr;
+      m_consensusObject->SetConsensusErrorCode(
+          ConsensusCommon::INVALID_FINALBLOCK);
+      errorMsg.insert(errorMsg.begin(), CHECKFINALBLOCK);
+      return false;
+    }
     if (m_mediator.m_node->m_microblock != nullptr) {
+      if (stateDeltasChanged) {
+        // The DS transactions were applied over the previous shard deltas
+        m_mediator.m_node->ProcessTransactionWhenShardBackup();
+      }
       if (!CheckMicroBlockValidity(errorMsg)) {
         LOG_GENERAL(WARNING, "DS CheckMicroBlockValidity Failed");
         if (m_consensusObject->GetConsensusErrorCode() ==
@@ -1030,9 +1043,9 @@ bool DirectoryService::RunConsensusOnFinalBlockWhenDSBackup() {
 
 #ifdef VC_TEST_VC_PRECHECK_2
   uint64_t dsCurBlockNum =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
   uint64_t txCurBlockNum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
 
   // FIXME: Prechecking not working due at epoch 1 due to the way we have low
   // blocknum
@@ -1047,10 +1060,10 @@ bool DirectoryService::RunConsensusOnFinalBlockWhenDSBackup() {
   if (!m_mediator.GetIsVacuousEpoch() &&
       ((m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDifficulty() >=
             TXN_SHARD_TARGET_DIFFICULTY &&
-        m_mediator.m_dsBlockChain.GetLastBlock()
-                .GetHeader()
+        m_mediator.m_dsBlockChain.GetLastBlockPtr()
+                ->GetHeader()
                 .GetDSDifficulty() >= TXN_DS_TARGET_DIFFICULTY) ||
-       m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() >=
+       m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum() >=
            TXN_DS_TARGET_NUM)) {
     m_mediator.m_node->ProcessTransactionWhenShardBackup();
   }
@@ -1064,7 +1077,7 @@ bool DirectoryService::RunConsensusOnFinalBlockWhenDSBackup() {
 
   // Create new consensus object
   m_consensusBlockHash =
-      m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes();
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetBlockHash().asBytes();
 
   auto func = [this](const bytes& input, unsigned int offset, bytes& errorMsg,
                      const uint32_t consensusID, const uint64_t blockNumber,
@@ -1158,13 +1171,24 @@ void DirectoryService::RunConsensusOnFinalBlock() {
 
     m_mediator.m_node->PrepareGoodStateForFinalBlock();
 
+    // Serialize the merged shard state deltas once, before the DS microblock
+    // transactions are applied on top of them
+    const bool stateDeltaReady = SerializeStateDeltaFromShards();
+
     LOG_GENERAL(INFO, "RunConsensusOnFinalBlock ");
     PrepareRunConsensusOnFinalBlockNormal();
 
     // Upon consensus object creation failure, one should not return from the
     // function, but rather wait for view change.
     bool ConsensusObjCreation = true;
-    if (m_mode == PRIMARY_DS) {
+    if (!stateDeltaReady) {
+      // The final block cannot be proposed or checked without the merged
+      // shard state, so skip this round
+      LOG_GENERAL(WARNING,
+                  "SerializeStateDeltaFromShards failed, skipping final block "
+                  "consensus");
+      ConsensusObjCreation = false;
+    } else if (m_mode == PRIMARY_DS) {
       this_thread::sleep_for(chrono::milliseconds(ANNOUNCEMENT_DELAY_IN_MS));
       ConsensusObjCreation = RunConsensusOnFinalBlockWhenDSPrimary();
       if (!ConsensusObjCreation) {
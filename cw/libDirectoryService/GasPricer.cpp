@@ -26,17 +26,17 @@ uint128_t DirectoryService::GetNewGasPrice() {
   LOG_MARKER();
 
   uint64_t loBlockNum =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetEpochNum();
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetEpochNum();
   uint64_t hiBlockNum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
   uint64_t totalBlockNum = 0;
   uint64_t fullBlockNum = 0;
 
   for (uint64_t i = loBlockNum; i <= hiBlockNum; ++i) {
     uint128_t gasUsed =
-        m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetGasUsed();
+        m_mediator.m_txBlockChain.GetBlockPtr(i)->GetHeader().GetGasUsed();
     uint128_t gasLimit =
-        m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetGasLimit();
+        m_mediator.m_txBlockChain.GetBlockPtr(i)->GetHeader().GetGasLimit();
     if (gasUsed >= gasLimit * GAS_CONGESTION_PERCENT / 100) {
       fullBlockNum++;
     }
@@ -54,7 +54,7 @@ uint128_t DirectoryService::GetNewGasPrice() {
 
 uint128_t DirectoryService::GetHistoricalMeanGasPrice() {
   uint64_t curDSBlockNum =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
   uint64_t lowDSBlockNum = (curDSBlockNum > MEAN_GAS_PRICE_DS_NUM)
                                ? (curDSBlockNum - MEAN_GAS_PRICE_DS_NUM)
                                : 0;
@@ -66,7 +66,7 @@ uint128_t DirectoryService::GetHistoricalMeanGasPrice() {
     }
     if (!SafeMath<uint128_t>::add(
             totalGasPrice,
-            m_mediator.m_dsBlockChain.GetBlock(i).GetHeader().GetGasPrice(),
+            m_mediator.m_dsBlockChain.GetBlockPtr(i)->GetHeader().GetGasPrice(),
             totalGasPrice)) {
       continue;
     }
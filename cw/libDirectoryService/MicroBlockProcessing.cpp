@@ -33,6 +33,7 @@
 #include "libUtils/BitVector.h"
 #include "libUtils/DataConversion.h"
 #include "libUtils/DetachedFunction.h"
+#include "libUtils/JoinableFunction.h"
 #include "libUtils/Logger.h"
 #include "libUtils/SanityChecks.h"
 #include "libUtils/TimestampVerifier.h"
@@ -122,14 +123,14 @@ bool DirectoryService::VerifyMicroBlockCoSignature(const MicroBlock& microBlock,
   return true;
 }
 
-bool DirectoryService::ProcessStateDelta(
+bool DirectoryService::VerifyStateDelta(
     const bytes& stateDelta, const StateHash& microBlockStateDeltaHash,
-    const BlockHash& microBlockHash) {
+    vector<Address>& exclusiveUpdates) {
   LOG_MARKER();
 
   if (LOOKUP_NODE_MODE) {
     LOG_GENERAL(WARNING,
-                "DirectoryService::ProcessStateDelta not expected to be "
+                "DirectoryService::VerifyStateDelta not expected to be "
                 "called from LookUp node.");
     return true;
   }
@@ -150,16 +151,12 @@ bool DirectoryService::ProcessStateDelta(
   }
 
   if (stateDelta.empty()) {
-    LOG_GENERAL(INFO, "State Delta is empty");
-    if (microBlockStateDeltaHash != StateHash()) {
-      LOG_GENERAL(WARNING, "State Delta and StateDeltaHash inconsistent");
-      return false;
-    }
-    return true;
-  } else {
-    LOG_GENERAL(INFO, "State Delta size: " << stateDelta.size());
+    LOG_GENERAL(WARNING, "State Delta and StateDeltaHash inconsistent");
+    return false;
   }
 
+  LOG_GENERAL(INFO, "State Delta size: " << stateDelta.size());
+
   SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
   sha2.Update(stateDelta);
   StateHash stateDeltaHash(sha2.Finalize());
@@ -172,25 +169,240 @@ bool DirectoryService::ProcessStateDelta(
     return false;
   }
 
-  if (microBlockStateDeltaHash == StateHash()) {
-    LOG_GENERAL(INFO, "State Delta from microblock is empty");
+  if (!Messenger::StateDeltaToExclusiveUpdates(stateDelta, 0,
+                                               exclusiveUpdates)) {
+    LOG_GENERAL(WARNING, "Messenger::StateDeltaToExclusiveUpdates failed.");
     return false;
   }
 
+  return true;
+}
+
+bool DirectoryService::ProcessStateDelta(
+    const bytes& stateDelta, const StateHash& microBlockStateDeltaHash,
+    const BlockHash& microBlockHash, const uint32_t shardId,
+    const vector<Address>& exclusiveUpdates) {
+  LOG_MARKER();
+
+  if (LOOKUP_NODE_MODE) {
+    LOG_GENERAL(WARNING,
+                "DirectoryService::ProcessStateDelta not expected to be "
+                "called from LookUp node.");
+    return true;
+  }
+
+  // Caller holds m_mutexMicroBlocks and has run VerifyStateDelta beforehand
+  if (microBlockStateDeltaHash == StateHash()) {
+    return true;
+  }
+
   if (!AccountStore::GetInstance().DeserializeDeltaTemp(stateDelta, 0)) {
     LOG_GENERAL(WARNING, "AccountStore::DeserializeDeltaTemp failed.");
     return false;
   }
 
+  // Conflicts with other shards are resolved in ResolveStateDeltaConflicts
+  m_stateDeltaExclusiveUpdates[shardId] =
+      make_pair(microBlockHash, exclusiveUpdates);
+  m_stateDeltaMergedShards.emplace(shardId);
+
+  // The combined delta is serialized once in SerializeStateDeltaFromShards
+  m_stateDeltaFromShardsDirty = true;
+
+  m_microBlockStateDeltas[m_mediator.m_currentEpochNum].emplace(microBlockHash,
+                                                                stateDelta);
+
+  return true;
+}
+
+set<uint32_t> DirectoryService::GetConflictingShards(
+    const StateDeltaExclusiveUpdates& exclusiveUpdates) {
+  // An account can only be sent from by one shard within an epoch, and a
+  // contract only updated by one, so two shards updating the same account
+  // exclusively means their deltas conflict. Shards are visited by ascending
+  // ID and the higher one loses, so every DS node resolves the same conflicts
+  // whatever order the microblocks arrived in.
+  unordered_map<Address, uint32_t> owners;
+  set<uint32_t> conflictingShards;
+  for (const auto& shard : exclusiveUpdates) {
+    bool conflict = false;
+    for (const auto& address : shard.second.second) {
+      const auto& owner = owners.find(address);
+      if (owner != owners.end()) {
+        LOG_GENERAL(WARNING, "State delta of shard "
+                                 << shard.first << " conflicts with shard "
+                                 << owner->second << " on account "
+                                 << address);
+        conflict = true;
+        break;
+      }
+    }
+    if (conflict) {
+      conflictingShards.emplace(shard.first);
+      continue;
+    }
+    for (const auto& address : shard.second.second) {
+      owners.emplace(address, shard.first);
+    }
+  }
+
+  return conflictingShards;
+}
+
+bool DirectoryService::ResolveStateDeltaConflicts() {
+  LOG_MARKER();
+
+  // Caller holds m_mutexMicroBlocks
+
+  const set<uint32_t> conflictingShards =
+      GetConflictingShards(m_stateDeltaExclusiveUpdates);
+
+  set<uint32_t> shards;
+  for (const auto& shard : m_stateDeltaExclusiveUpdates) {
+    if (conflictingShards.find(shard.first) == conflictingShards.end()) {
+      shards.emplace(shard.first);
+    }
+  }
+
+  // Only the leader drops the conflicting microblocks, so that they are left
+  // out of its final block. A backup keeps them, as the leader may not have
+  // the lower shard's microblock and announce the higher one instead, and
+  // follows the final block in AlignStateDeltasWithFinalBlock.
+  if (m_mode == PRIMARY_DS) {
+    auto& microBlocksAtEpoch = m_microBlocks[m_mediator.m_currentEpochNum];
+    auto& stateDeltasAtEpoch =
+        m_microBlockStateDeltas[m_mediator.m_currentEpochNum];
+    for (const auto& shardId : conflictingShards) {
+      const BlockHash microBlockHash =
+          m_stateDeltaExclusiveUpdates.at(shardId).first;
+      LOG_GENERAL(WARNING, "Dropping microblock " << microBlockHash
+                                                  << " of shard " << shardId);
+      auto microBlock =
+          find_if(microBlocksAtEpoch.begin(), microBlocksAtEpoch.end(),
+                  [&microBlockHash](const MicroBlock& mb) -> bool {
+                    return mb.GetBlockHash() == microBlockHash;
+                  });
+      if (microBlock != microBlocksAtEpoch.end()) {
+        microBlocksAtEpoch.erase(microBlock);
+      }
+      stateDeltasAtEpoch.erase(microBlockHash);
+      m_stateDeltaExclusiveUpdates.erase(shardId);
+    }
+  }
+
+  if (shards == m_stateDeltaMergedShards) {
+    return true;
+  }
+
+  return MergeStateDeltas(shards);
+}
+
+bool DirectoryService::MergeStateDeltas(const set<uint32_t>& shards) {
+  // Caller holds m_mutexMicroBlocks
+
+  const auto& stateDeltasAtEpoch =
+      m_microBlockStateDeltas[m_mediator.m_currentEpochNum];
+
+  // Merge the deltas again, by ascending shard ID
+  AccountStore::GetInstance().InitTemp();
+  m_stateDeltaMergedShards.clear();
+  for (const auto& shard : m_stateDeltaExclusiveUpdates) {
+    if (shards.find(shard.first) == shards.end()) {
+      continue;
+    }
+    const auto& stateDelta = stateDeltasAtEpoch.find(shard.second.first);
+    if (stateDelta == stateDeltasAtEpoch.end()) {
+      LOG_GENERAL(WARNING, "State delta of shard " << shard.first
+                                                   << " not found");
+      return false;
+    }
+    if (!AccountStore::GetInstance().DeserializeDeltaTemp(stateDelta->second,
+                                                          0)) {
+      LOG_GENERAL(WARNING, "AccountStore::DeserializeDeltaTemp failed.");
+      return false;
+    }
+    m_stateDeltaMergedShards.emplace(shard.first);
+  }
+
+  m_stateDeltaFromShardsDirty = true;
+
+  return true;
+}
+
+bool DirectoryService::AlignStateDeltasWithFinalBlock(bool& changed) {
+  LOG_MARKER();
+
+  lock_guard<mutex> g(m_mutexMicroBlocks);
+
+  changed = false;
+
+  // The shard microblocks of the final block decide which state deltas are
+  // merged, as the leader may have received a different set
+  StateDeltaExclusiveUpdates announced;
+  for (const auto& info : m_finalBlock->GetMicroBlockInfos()) {
+    if (info.m_shardId == m_shards.size()) {
+      continue;
+    }
+    const auto& shard = m_stateDeltaExclusiveUpdates.find(info.m_shardId);
+    if (shard != m_stateDeltaExclusiveUpdates.end() &&
+        shard->second.first == info.m_microBlockHash) {
+      announced.emplace(*shard);
+    }
+  }
+
+  if (!GetConflictingShards(announced).empty()) {
+    LOG_GENERAL(WARNING, "Final block includes conflicting shard state deltas");
+    return false;
+  }
+
+  set<uint32_t> shards;
+  for (const auto& shard : announced) {
+    shards.emplace(shard.first);
+  }
+
+  if (shards == m_stateDeltaMergedShards) {
+    return true;
+  }
+
+  LOG_GENERAL(INFO, "Merging the shard state deltas of the final block");
+
+  if (!MergeStateDeltas(shards)) {
+    return false;
+  }
+
   if (!AccountStore::GetInstance().SerializeDelta()) {
     LOG_GENERAL(WARNING, "AccountStore::SerializeDelta failed.");
     return false;
   }
 
   AccountStore::GetInstance().GetSerializedDelta(m_stateDeltaFromShards);
+  m_stateDeltaFromShardsDirty = false;
+  changed = true;
 
-  m_microBlockStateDeltas[m_mediator.m_currentEpochNum].emplace(microBlockHash,
-                                                                stateDelta);
+  return true;
+}
+
+bool DirectoryService::SerializeStateDeltaFromShards() {
+  LOG_MARKER();
+
+  lock_guard<mutex> g(m_mutexMicroBlocks);
+
+  if (!m_stateDeltaFromShardsDirty) {
+    return true;
+  }
+
+  if (!ResolveStateDeltaConflicts()) {
+    LOG_GENERAL(WARNING, "ResolveStateDeltaConflicts failed.");
+    return false;
+  }
+
+  if (!AccountStore::GetInstance().SerializeDelta()) {
+    LOG_GENERAL(WARNING, "AccountStore::SerializeDelta failed.");
+    return false;
+  }
+
+  AccountStore::GetInstance().GetSerializedDelta(m_stateDeltaFromShards);
+  m_stateDeltaFromShardsDirty = false;
 
   return true;
 }
@@ -280,6 +492,16 @@ bool DirectoryService::ProcessMicroblockSubmissionFromShardCore(
                         << endl
                         << microBlock.GetHeader().GetHashes());
 
+  // Hash check and decoding run before taking m_mutexMicroBlocks so that
+  // submissions from different shards are verified in parallel
+  vector<Address> exclusiveUpdates;
+  if (!m_mediator.GetIsVacuousEpoch() &&
+      !VerifyStateDelta(stateDelta, microBlock.GetHeader().GetStateDeltaHash(),
+                        exclusiveUpdates)) {
+    LOG_GENERAL(WARNING, "State delta attached to the microblock is invalid");
+    return false;
+  }
+
   lock_guard<mutex> g(m_mutexMicroBlocks);
 
   if (m_stopRecvNewMBSubmission) {
@@ -316,9 +538,9 @@ bool DirectoryService::ProcessMicroblockSubmissionFromShardCore(
   }
 
   if (!m_mediator.GetIsVacuousEpoch()) {
-    if (!ProcessStateDelta(stateDelta,
-                           microBlock.GetHeader().GetStateDeltaHash(),
-                           microBlock.GetBlockHash())) {
+    if (!ProcessStateDelta(
+            stateDelta, microBlock.GetHeader().GetStateDeltaHash(),
+            microBlock.GetBlockHash(), shardId, exclusiveUpdates)) {
       LOG_GENERAL(WARNING, "State delta attached to the microblock is invalid");
       return false;
     }
@@ -528,6 +750,30 @@ bool DirectoryService::ProcessMissingMicroblockSubmission(
                   << " , local: " << m_mediator.m_currentEpochNum);
   }
 
+  // Verify the fetched state deltas in parallel before merging them
+  vector<vector<Address>> exclusiveUpdates(stateDeltas.size());
+  vector<unsigned char> stateDeltaValid(stateDeltas.size(), 0);
+  if (!m_mediator.GetIsVacuousEpoch(epochNumber) &&
+      microBlocks.size() == stateDeltas.size()) {
+    atomic<unsigned int> next{0};
+    auto verifyFunc = [this, &next, &microBlocks, &stateDeltas,
+                       &exclusiveUpdates,
+                       &stateDeltaValid]() mutable -> void {
+      for (unsigned int i = next++; i < stateDeltas.size(); i = next++) {
+        stateDeltaValid.at(i) = VerifyStateDelta(
+            stateDeltas.at(i),
+            microBlocks.at(i).GetHeader().GetStateDeltaHash(),
+            exclusiveUpdates.at(i));
+      }
+    };
+    // hardware_concurrency() may return 0, always start at least one worker
+    const unsigned int numVerifiers = max<unsigned int>(
+        1, min<unsigned int>(stateDeltas.size(),
+                             thread::hardware_concurrency()));
+    JoinableFunction verifiers(numVerifiers, verifyFunc);
+    verifiers.join();
+  }
+
   {
     lock_guard<mutex> g(m_mutexMicroBlocks);
     auto& microBlocksAtEpoch = m_microBlocks[epochNumber];
@@ -561,14 +807,7 @@ bool DirectoryService::ProcessMissingMicroblockSubmission(
       // Check public key - shard ID mapping
       if (shardId == m_shards.size()) {
         // DS shard
-        bool found = false;
-        for (const auto& ds : *m_mediator.m_DSCommittee) {
-          if (ds.first == pubKey) {
-            found = true;
-            break;
-          }
-        }
-        if (!found) {
+        if (!m_mediator.GetCommitteeView()->IsDSNode(pubKey)) {
           LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
                     "Cannot find the miner key in DS committee: " << pubKey);
           continue;
@@ -643,10 +882,12 @@ bool DirectoryService::ProcessMissingMicroblockSubmission(
       }
 
       if (!m_mediator.GetIsVacuousEpoch(epochNumber)) {
-        if (!ProcessStateDelta(
+        if (!stateDeltaValid.at(i) ||
+            !ProcessStateDelta(
                 stateDeltas.at(i),
                 microBlocks.at(i).GetHeader().GetStateDeltaHash(),
-                microBlocks.at(i).GetBlockHash())) {
+                microBlocks.at(i).GetBlockHash(), shardId,
+                exclusiveUpdates.at(i))) {
           LOG_GENERAL(WARNING,
                       "State delta attached to the microblock is invalid");
           continue;
@@ -671,6 +912,11 @@ bool DirectoryService::ProcessMissingMicroblockSubmission(
     }
   }
 
+  if (!SerializeStateDeltaFromShards()) {
+    LOG_GENERAL(WARNING, "SerializeStateDeltaFromShards failed");
+    return false;
+  }
+
   bytes errorMsg;
   if (!CheckMicroBlocks(errorMsg, false, false)) {
     LOG_GENERAL(WARNING,
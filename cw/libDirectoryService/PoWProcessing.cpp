@@ -381,8 +381,8 @@ bool DirectoryService::VerifyPoWSubmission(const DSPowSolution& sol) {
 
       uint8_t expectedDSDiff = DS_POW_DIFFICULTY;
       if (blockNumber > 1) {
-        expectedDSDiff = m_mediator.m_dsBlockChain.GetLastBlock()
-                             .GetHeader()
+        expectedDSDiff = m_mediator.m_dsBlockChain.GetLastBlockPtr()
+                             ->GetHeader()
                              .GetDSDifficulty();
       }
 
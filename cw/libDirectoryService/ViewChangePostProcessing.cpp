@@ -252,6 +252,8 @@ void DirectoryService::ProcessViewChangeConsensusWhenDone() {
     }
   }
 
+  m_mediator.UpdateCommitteeView();
+
   switch (viewChangeState) {
     case DSBLOCK_CONSENSUS:
     case DSBLOCK_CONSENSUS_PREP:
@@ -340,7 +342,7 @@ void DirectoryService::ProcessViewChangeConsensusWhenDone() {
         *m_pendingVCBlock, tmpDSCommittee,
         t_shards.empty() ? m_shards : t_shards, t_microBlocks,
         m_mediator.m_lookup->GetLookupNodes(),
-        m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash(),
+        m_mediator.m_txBlockChain.GetLastBlockPtr()->GetBlockHash(),
         m_consensusMyID, composeVCBlockForSender, m_forceMulticast.load(),
         t_sendDataToLookupFunc);
   }
@@ -273,9 +273,9 @@ void DirectoryService::RunConsensusOnViewChange() {
   SetState(VIEWCHANGE_CONSENSUS_PREP);
 
   uint64_t dsCurBlockNum =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
   uint64_t txCurBlockNum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
 
   // Note: Special check as 0 and 1 have special usage when fetching ds block
   // and final block No need check for 1 as
@@ -498,7 +498,7 @@ uint16_t DirectoryService::CalculateNewLeaderIndex() {
     LOG_GENERAL(
         INFO, "Using hash of last final block for computing candidate leader");
     sha2.Update(
-        m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes());
+        m_mediator.m_txBlockChain.GetLastBlockPtr()->GetBlockHash().asBytes());
   }
 
   bytes vcCounterBytes;
@@ -635,7 +635,7 @@ bool DirectoryService::RunConsensusOnViewChangeWhenCandidateLeader(
   uint32_t consensusID = m_viewChangeCounter;
   // Create new consensus object
   m_consensusBlockHash =
-      m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes();
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetBlockHash().asBytes();
 
   m_consensusObject.reset(new ConsensusLeader(
       consensusID, m_mediator.m_currentEpochNum, m_consensusBlockHash,
@@ -696,7 +696,7 @@ bool DirectoryService::RunConsensusOnViewChangeWhenNotCandidateLeader(
                 << m_mediator.m_DSCommittee->at(candidateLeaderIndex).second);
 
   m_consensusBlockHash =
-      m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes();
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetBlockHash().asBytes();
 
   auto func = [this](const bytes& input, unsigned int offset, bytes& errorMsg,
                      const uint32_t consensusID, const uint64_t blockNumber,
@@ -21,6 +21,7 @@
 #include <stdint.h>
 #include <sys/socket.h>
 #include <unistd.h>
+#include <algorithm>
 #include <cstring>
 #include <exception>
 #include <fstream>
@@ -55,6 +56,74 @@
 using namespace std;
 using namespace boost::multiprecision;
 
+namespace {
+// Upper bound of the tag and length encoded before each txn of a packet
+const unsigned int TXN_PACKET_TXN_PREFIX_SIZE = 6;
+
+// Packets are gossiped whole within the shard, so they must fit in a single
+// gossip message as well. A gossip limit below the header size leaves no room
+// for txns.
+unsigned int GetTxnPacketSizeLimit() {
+  const unsigned int gossipLimit =
+      MAX_GOSSIP_MSG_SIZE_IN_BYTES > TXN_PACKET_HEADER_SIZE_IN_BYTES
+          ? MAX_GOSSIP_MSG_SIZE_IN_BYTES - TXN_PACKET_HEADER_SIZE_IN_BYTES
+          : 0;
+  return min(PACKET_BYTESIZE_LIMIT, gossipLimit);
+}
+
+// Returns whether a txn of txnSize bytes can be added to the packet. The
+// txns of a packet stay within PACKET_BYTESIZE_LIMIT, so shard nodes that
+// re-gossip it with Messenger::SetNodeForwardTxnBlock keep every txn and
+// the lookup signature stays valid.
+bool FitsInTxnPacket(const EncodedTxnPacket& packet, const size_t txnSize) {
+  const size_t packetSize =
+      packet.m_encodedTxns.size() +
+      (packet.m_encodedTxnSizes.size() + 1) * TXN_PACKET_TXN_PREFIX_SIZE;
+  return packetSize + txnSize <= GetTxnPacketSizeLimit();
+}
+
+// Starts a new packet with the next unique ID
+void AddTxnPacket(deque<EncodedTxnPacket>& packets, uint64_t& nextPacketId) {
+  packets.emplace_back();
+  packets.back().m_id = nextPacketId++;
+}
+
+// Appends an encoded txn to the last packet, or to a new packet if the last
+// one would go over the packet size limit
+void AppendToTxnPackets(deque<EncodedTxnPacket>& packets,
+                        uint64_t& nextPacketId, bytes::const_iterator txnBegin,
+                        bytes::const_iterator txnEnd) {
+  const uint32_t txnSize = distance(txnBegin, txnEnd);
+  if (packets.empty()) {
+    AddTxnPacket(packets, nextPacketId);
+  }
+
+  if (!packets.back().m_encodedTxnSizes.empty() &&
+      !FitsInTxnPacket(packets.back(), txnSize)) {
+    AddTxnPacket(packets, nextPacketId);
+  }
+  packets.back().m_encodedTxns.insert(packets.back().m_encodedTxns.end(),
+                                      txnBegin, txnEnd);
+  packets.back().m_encodedTxnSizes.emplace_back(txnSize);
+}
+
+// Retrieves the blocks lowBlockNum to highBlockNum with getBlock, up to the
+// first one missing, and lowers highBlockNum to the last block retrieved
+void RetrieveBlockRange(const uint64_t& lowBlockNum, uint64_t& highBlockNum,
+                        const function<bool(const uint64_t&)>& getBlock) {
+  uint64_t blockNum;
+  for (blockNum = lowBlockNum; blockNum <= highBlockNum; blockNum++) {
+    if (!getBlock(blockNum)) {
+      break;
+    }
+  }
+
+  if (blockNum != highBlockNum + 1) {
+    highBlockNum = blockNum - 1;
+  }
+}
+}  // namespace
+
 Lookup::Lookup(Mediator& mediator, SyncType syncType) : m_mediator(mediator) {
   m_syncType.store(SyncType::NO_SYNC);
   vector<SyncType> ignorable_syncTypes = {NO_SYNC, RECOVERY_ALL_SYNC, DB_VERIF};
@@ -80,11 +149,13 @@ void Lookup::InitAsNewJoiner() {
   m_mediator.m_dsBlockChain.Reset();
   m_mediator.m_txBlockChain.Reset();
   m_mediator.m_blocklinkchain.Reset();
+  ClearBlockCaches();
   SetLookupNodes();
   {
     std::lock_guard<mutex> lock(m_mediator.m_mutexDSCommittee);
     m_mediator.m_DSCommittee->clear();
   }
+  m_mediator.UpdateCommitteeView();
   AccountStore::GetInstance().Init();
 
   Synchronizer tempSyncer;
@@ -120,19 +191,22 @@ void Lookup::InitSync() {
                   "TxBlockNum " << txBlockNum << " DSBlockNum: " << dsBlockNum);
       ComposeAndSendGetDirectoryBlocksFromSeed(
           m_mediator.m_blocklinkchain.GetLatestIndex() + 1);
-      GetTxBlockFromSeedNodes(txBlockNum, 0);
+      SyncTxBlocksFromSeedNodes(txBlockNum);
 
       this_thread::sleep_for(chrono::seconds(NEW_NODE_SYNC_INTERVAL));
     }
     // Ask for the sharding structure from lookup
-    ComposeAndSendGetShardingStructureFromSeed();
-    std::unique_lock<std::mutex> cv_lk(m_mutexShardStruct);
-    if (cv_shardStruct.wait_for(
-            cv_lk,
-            std::chrono::seconds(NEW_LOOKUP_GETSHARD_TIMEOUT_IN_SECONDS)) ==
-        std::cv_status::timeout) {
+    DequeOfShard shards;
+    if (!RequestShardingStructure(
+            true, chrono::seconds(NEW_LOOKUP_GETSHARD_TIMEOUT_IN_SECONDS),
+            shards)) {
       LOG_GENERAL(WARNING, "Didn't receive sharding structure!");
     } else {
+      {
+        lock_guard<mutex> g(m_mediator.m_ds->m_mutexShards);
+        m_mediator.m_ds->m_shards = move(shards);
+      }
+      m_mediator.UpdateCommitteeView();
       ProcessEntireShardingStructure();
     }
   };
@@ -577,6 +651,24 @@ bytes Lookup::ComposeGetStateMessage() {
   return getStateMessage;
 }
 
+bytes Lookup::ComposeGetStateSnapshotManifestMessage() {
+  LOG_MARKER();
+
+  bytes getManifestMessage = {
+      MessageType::LOOKUP,
+      LookupInstructionType::GETSTATESNAPSHOTMANIFESTFROMSEED};
+
+  if (!Messenger::SetLookupGetStateSnapshotManifestFromSeed(
+          getManifestMessage, MessageOffset::BODY,
+          m_mediator.m_selfPeer.m_listenPortHost)) {
+    LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
+              "Messenger::SetLookupGetStateSnapshotManifestFromSeed failed.");
+    return {};
+  }
+
+  return getManifestMessage;
+}
+
 bool Lookup::GetDSInfoFromSeedNodes() {
   LOG_MARKER();
   SendMessageToRandomSeedNode(ComposeGetDSInfoMessage());
@@ -590,10 +682,49 @@ bool Lookup::GetDSInfoFromLookupNodes(bool initialDS) {
 }
 
 bool Lookup::GetStateFromSeedNodes() {
-  SendMessageToRandomSeedNode(ComposeGetStateMessage());
+  {
+    lock_guard<mutex> g(m_mutexStateSnapshotImport);
+    m_stateSnapshotManifestPending = true;
+  }
+
+  SendMessageToRandomSeedNode(ComposeGetStateSnapshotManifestMessage());
+
+  // Seeds drop the request if they cannot export a snapshot, so do not wait
+  // for the manifest forever
+  DetachedFunction(1, [this]() {
+    {
+      unique_lock<mutex> lock(m_mutexStateSnapshotImport);
+      if (cv_stateSnapshotImport.wait_for(
+              lock, chrono::seconds(STATE_SNAPSHOT_CHUNK_TIMEOUT_IN_SECONDS),
+              [this] { return !m_stateSnapshotManifestPending; })) {
+        return;
+      }
+    }
+    LOG_GENERAL(WARNING, "No state snapshot manifest received");
+    FallBackToFullState();
+  });
+
   return true;
 }
 
+void Lookup::FallBackToFullState() {
+  {
+    lock_guard<mutex> g(m_mutexStateSnapshotImport);
+    if (!m_stateSnapshotManifestPending) {
+      return;
+    }
+    m_stateSnapshotManifestPending = false;
+    cv_stateSnapshotImport.notify_all();
+  }
+
+  if (AlreadyJoinedNetwork()) {
+    return;
+  }
+
+  LOG_GENERAL(INFO, "Requesting the full state");
+  SendMessageToRandomSeedNode(ComposeGetStateMessage());
+}
+
 bytes Lookup::ComposeGetDSBlockMessage(uint64_t lowBlockNum,
                                        uint64_t highBlockNum) {
   LOG_MARKER();
@@ -712,6 +843,212 @@ bool Lookup::GetTxBlockFromSeedNodes(uint64_t lowBlockNum,
   return true;
 }
 
+bool Lookup::SyncTxBlocksFromSeedNodes(uint64_t lowBlockNum) {
+  LOG_MARKER();
+
+  size_t numSeeds = 0;
+  {
+    lock_guard<mutex> lock(m_mutexSeedNodes);
+    numSeeds = m_seedNodes.size();
+  }
+
+  // Seed nodes only serve tx blocks of their current DS epoch, so the range
+  // can only be split once our directory blocks have caught up with it
+  const uint64_t dsEpochStart =
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetEpochNum();
+  if (numSeeds < 2 || m_mediator.m_dsBlockChain.GetBlockCount() <= 1 ||
+      lowBlockNum >= dsEpochStart + NUM_FINAL_BLOCK_PER_POW) {
+    return GetTxBlockFromSeedNodes(lowBlockNum, 0);
+  }
+
+  lowBlockNum = max(lowBlockNum, dsEpochStart);
+  const uint64_t highBlockNum = dsEpochStart + NUM_FINAL_BLOCK_PER_POW - 1;
+
+  vector<pair<uint64_t, unsigned int>> requests;
+  vector<unsigned int> seedFailures(numSeeds, 0);
+  {
+    lock_guard<mutex> g(m_mutexTxBlockSync);
+    m_txBlockSyncChunks.clear();
+    m_txBlockSyncStale = false;
+
+    unsigned int seedIndex = rand() % numSeeds;
+    const auto now = chrono::steady_clock::now();
+    for (uint64_t low = lowBlockNum; low <= highBlockNum;
+         low += TXBLOCK_SYNC_CHUNK_SIZE) {
+      uint64_t high = min(low + TXBLOCK_SYNC_CHUNK_SIZE - 1, highBlockNum);
+      m_txBlockSyncChunks.emplace(
+          low, TxBlockSyncChunk{high, seedIndex, 1, now, false, {}});
+      requests.emplace_back(low, seedIndex);
+      seedIndex = (seedIndex + 1) % numSeeds;
+    }
+  }
+
+  LOG_GENERAL(INFO, "Syncing txBlks " << lowBlockNum << "-" << highBlockNum
+                                      << " in " << requests.size()
+                                      << " chunks from " << numSeeds
+                                      << " seeds");
+
+  bool success = false;
+  bool stale = false;
+  vector<TxBlock> txBlocks;
+
+  // Joins the received chunks from the lowest one on. Each chunk was
+  // validated on arrival, only the links between them remain to be checked.
+  // Use m_mutexTxBlockSync with this function.
+  auto collectChunks = [this, &txBlocks]() -> bool {
+    for (auto& entry : m_txBlockSyncChunks) {
+      auto& chunk = entry.second;
+      if (!chunk.m_received) {
+        break;
+      }
+      if (!txBlocks.empty() &&
+          chunk.m_txBlocks.front().GetHeader().GetPrevHash() !=
+              txBlocks.back().GetHeader().GetMyHash()) {
+        LOG_GENERAL(WARNING, "TxBlk " << entry.first
+                                      << " does not link to its parent");
+        return false;
+      }
+      move(chunk.m_txBlocks.begin(), chunk.m_txBlocks.end(),
+           back_inserter(txBlocks));
+      if (txBlocks.back().GetHeader().GetBlockNum() < chunk.m_highBlockNum) {
+        break;
+      }
+    }
+    return true;
+  };
+
+  while (true) {
+    for (const auto& request : requests) {
+      uint64_t high;
+      {
+        lock_guard<mutex> g(m_mutexTxBlockSync);
+        high = m_txBlockSyncChunks.at(request.first).m_highBlockNum;
+      }
+      SendMessageToSeedNode(request.second,
+                            ComposeGetTxBlockMessage(request.first, high));
+    }
+    requests.clear();
+
+    unique_lock<mutex> lock(m_mutexTxBlockSync);
+    if (m_txBlockSyncStale) {
+      stale = collectChunks();
+      break;
+    }
+    if (AlreadyJoinedNetwork()) {
+      break;
+    }
+
+    // Chunks are complete once every chunk up to the one that ended short
+    // (the seeds' chain tip) has been received
+    bool complete = true;
+    bool exhausted = false;
+    const auto now = chrono::steady_clock::now();
+    for (auto& entry : m_txBlockSyncChunks) {
+      auto& chunk = entry.second;
+      if (chunk.m_received) {
+        if (chunk.m_txBlocks.back().GetHeader().GetBlockNum() <
+            chunk.m_highBlockNum) {
+          break;
+        }
+        continue;
+      }
+
+      if (now - chunk.m_requestedAt <
+          chrono::seconds(TXBLOCK_SYNC_CHUNK_TIMEOUT_IN_SECONDS)) {
+        complete = false;
+        continue;
+      }
+
+      if (chunk.m_attempts >= TXBLOCK_SYNC_CHUNK_MAX_ATTEMPTS) {
+        // If all the chunks before it were received in full, no seed has
+        // gone past them yet
+        if (complete && entry.first != m_txBlockSyncChunks.begin()->first) {
+          break;
+        }
+        LOG_GENERAL(WARNING, "Gave up on txBlks " << entry.first << "-"
+                                                  << chunk.m_highBlockNum);
+        exhausted = true;
+        break;
+      }
+
+      complete = false;
+
+      // Re-assign to the seed that has failed least often in this round
+      seedFailures[chunk.m_seedIndex]++;
+      unsigned int next = (chunk.m_seedIndex + 1) % numSeeds;
+      for (unsigned int i = 0; i < numSeeds; i++) {
+        if (i != chunk.m_seedIndex && seedFailures[i] < seedFailures[next]) {
+          next = i;
+        }
+      }
+      LOG_GENERAL(INFO, "Re-requesting txBlks "
+                            << entry.first << "-" << chunk.m_highBlockNum
+                            << " from seed " << next << " (was "
+                            << chunk.m_seedIndex << ")");
+      chunk.m_seedIndex = next;
+      chunk.m_attempts++;
+      chunk.m_requestedAt = now;
+      requests.emplace_back(entry.first, next);
+    }
+
+    if (exhausted) {
+      break;
+    }
+
+    if (complete) {
+      success = collectChunks();
+      break;
+    }
+
+    if (requests.empty()) {
+      cv_txBlockSync.wait_for(
+          lock, chrono::seconds(TXBLOCK_SYNC_CHUNK_TIMEOUT_IN_SECONDS));
+    }
+  }
+
+  {
+    lock_guard<mutex> g(m_mutexTxBlockSync);
+    m_txBlockSyncChunks.clear();
+  }
+
+  if (stale && !txBlocks.empty()) {
+    // Kept until the DS info catches up, as for a single range
+    LOG_GENERAL(INFO, "[TxBlockVerif]"
+                          << "Saved " << txBlocks.size() << " to buffer");
+    lock_guard<mutex> g(m_mutexSetTxBlockFromSeed);
+    m_txBlockBuffer = move(txBlocks);
+    return false;
+  }
+
+  if (!success || txBlocks.empty()) {
+    return false;
+  }
+
+  unique_lock<mutex> lock(m_mutexSetTxBlockFromSeed);
+
+  if (AlreadyJoinedNetwork()) {
+    return true;
+  }
+
+  // Blocks may have been committed by another path in the meantime
+  uint64_t latestSynBlockNum =
+      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1;
+  txBlocks.erase(
+      txBlocks.begin(),
+      find_if(txBlocks.begin(), txBlocks.end(),
+              [latestSynBlockNum](const TxBlock& txBlock) {
+                return txBlock.GetHeader().GetBlockNum() >= latestSynBlockNum;
+              }));
+  if (txBlocks.empty()) {
+    LOG_GENERAL(INFO, "I already have the blocks. latestSynBlockNum="
+                          << latestSynBlockNum);
+    return false;
+  }
+
+  CommitTxBlocks(txBlocks);
+  return true;
+}
+
 bool Lookup::GetStateDeltaFromSeedNodes(const uint64_t& blockNum)
 
 {
@@ -739,30 +1076,34 @@ bool Lookup::SetDSCommitteInfo(bool replaceMyPeerWithDefault) {
   ptree pt;
   read_xml("config.xml", pt);
 
-  lock_guard<mutex> g(m_mediator.m_mutexDSCommittee);
+  {
+    lock_guard<mutex> g(m_mediator.m_mutexDSCommittee);
 
-  for (ptree::value_type const& v : pt.get_child("nodes")) {
-    if (v.first == "peer") {
-      bytes pubkeyBytes;
-      if (!DataConversion::HexStrToUint8Vec(v.second.get<string>("pubk"),
-                                            pubkeyBytes)) {
-        continue;
-      }
-      PubKey key(pubkeyBytes, 0);
+    for (ptree::value_type const& v : pt.get_child("nodes")) {
+      if (v.first == "peer") {
+        bytes pubkeyBytes;
+        if (!DataConversion::HexStrToUint8Vec(v.second.get<string>("pubk"),
+                                              pubkeyBytes)) {
+          continue;
+        }
+        PubKey key(pubkeyBytes, 0);
 
-      struct in_addr ip_addr;
-      inet_pton(AF_INET, v.second.get<string>("ip").c_str(), &ip_addr);
-      Peer peer((uint128_t)ip_addr.s_addr, v.second.get<unsigned int>("port"));
+        struct in_addr ip_addr;
+        inet_pton(AF_INET, v.second.get<string>("ip").c_str(), &ip_addr);
+        Peer peer((uint128_t)ip_addr.s_addr,
+                  v.second.get<unsigned int>("port"));
 
-      if (replaceMyPeerWithDefault && (key == m_mediator.m_selfKey.second)) {
-        m_mediator.m_DSCommittee->emplace_back(make_pair(key, Peer()));
-        LOG_GENERAL(INFO, "Added self " << Peer());
-      } else {
-        m_mediator.m_DSCommittee->emplace_back(make_pair(key, peer));
-        LOG_GENERAL(INFO, "Added peer " << peer);
+        if (replaceMyPeerWithDefault && (key == m_mediator.m_selfKey.second)) {
+          m_mediator.m_DSCommittee->emplace_back(make_pair(key, Peer()));
+          LOG_GENERAL(INFO, "Added self " << Peer());
+        } else {
+          m_mediator.m_DSCommittee->emplace_back(make_pair(key, peer));
+          LOG_GENERAL(INFO, "Added peer " << peer);
+        }
       }
     }
   }
+  m_mediator.UpdateCommitteeView();
 
   return true;
 }
@@ -935,6 +1276,24 @@ void Lookup::SendMessageToRandomSeedNode(const bytes& message) const {
   P2PComm::GetInstance().SendMessage(tmpPeer, message);
 }
 
+void Lookup::SendMessageToSeedNode(unsigned int index,
+                                   const bytes& message) const {
+  lock_guard<mutex> lock(m_mutexSeedNodes);
+  if (index >= m_seedNodes.size()) {
+    LOG_GENERAL(WARNING, "Seed node index " << index << " out of range");
+    return;
+  }
+
+  auto resolved_ip = TryGettingResolvedIP(m_seedNodes[index].second);
+
+  Blacklist::GetInstance().Exclude(
+      resolved_ip);  // exclude this lookup ip from blacklisting
+
+  Peer tmpPeer(resolved_ip, m_seedNodes[index].second.GetListenPortHost());
+  LOG_GENERAL(INFO, "Sending message to " << tmpPeer);
+  P2PComm::GetInstance().SendMessage(tmpPeer, message);
+}
+
 // TODO: Refactor the code to remove the following assumption
 // lowBlockNum = 1 => Latest block number
 // lowBlockNum = 0 => lowBlockNum set to 1
@@ -961,27 +1320,36 @@ bool Lookup::ProcessGetDSBlockFromSeed(const bytes& message,
     return false;
   }
 
-  vector<DSBlock> dsBlocks;
-  RetrieveDSBlocks(dsBlocks, lowBlockNum, highBlockNum);
+  vector<shared_ptr<const bytes>> dsBlocks;
+  RetrieveSerializedDSBlocks(dsBlocks, lowBlockNum, highBlockNum);
   LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
             "ProcessGetDSBlockFromSeed requested by " << from << " for blocks "
                                                       << lowBlockNum << " to "
                                                       << highBlockNum);
 
-  bytes dsBlockMessage = {MessageType::LOOKUP,
-                          LookupInstructionType::SETDSBLOCKFROMSEED};
+  // A resolved range always maps to the same blocks, so the signed response
+  // can be reused for every node requesting it
+  auto dsBlockMessage = m_dsBlockRangeMsgCache.Get({lowBlockNum, highBlockNum});
+  if (dsBlockMessage == nullptr) {
+    bytes msg = {MessageType::LOOKUP, LookupInstructionType::SETDSBLOCKFROMSEED};
 
-  if (!Messenger::SetLookupSetDSBlockFromSeed(
-          dsBlockMessage, MessageOffset::BODY, lowBlockNum, highBlockNum,
-          m_mediator.m_selfKey, dsBlocks)) {
-    LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
-              "Messenger::SetLookupSetDSBlockFromSeed failed.");
-    return false;
+    if (!Messenger::SetLookupSetDSBlockFromSeed(
+            msg, MessageOffset::BODY, lowBlockNum, highBlockNum,
+            m_mediator.m_selfKey, dsBlocks)) {
+      LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
+                "Messenger::SetLookupSetDSBlockFromSeed failed.");
+      return false;
+    }
+
+    dsBlockMessage = make_shared<const bytes>(move(msg));
+    if (!dsBlocks.empty()) {
+      m_dsBlockRangeMsgCache.Put({lowBlockNum, highBlockNum}, dsBlockMessage);
+    }
   }
 
   Peer requestingNode(from.m_ipAddress, portNo);
   LOG_GENERAL(INFO, requestingNode);
-  P2PComm::GetInstance().SendMessage(requestingNode, dsBlockMessage);
+  P2PComm::GetInstance().SendMessage(requestingNode, *dsBlockMessage);
 
   return true;
 }
@@ -990,17 +1358,15 @@ bool Lookup::ProcessGetDSBlockFromSeed(const bytes& message,
 // lowBlockNum = 1 => Latest block number
 // lowBlockNum = 0 => lowBlockNum set to 1
 // highBlockNum = 0 => Latest block number
-void Lookup::RetrieveDSBlocks(vector<DSBlock>& dsBlocks, uint64_t& lowBlockNum,
-                              uint64_t& highBlockNum, bool partialRetrieve) {
-  lock_guard<mutex> g(m_mediator.m_node->m_mutexDSBlock);
-
+bool Lookup::GetDSBlockRange(uint64_t& lowBlockNum, uint64_t& highBlockNum,
+                             bool partialRetrieve) {
   uint64_t curBlockNum =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
 
   if (INIT_BLOCK_NUMBER == curBlockNum) {
     LOG_GENERAL(WARNING,
                 "Blockchain is still bootstraping, no ds blocks available.");
-    return;
+    return false;
   }
 
   uint64_t minBlockNum = (curBlockNum > MEAN_GAS_PRICE_DS_NUM)
@@ -1021,33 +1387,83 @@ void Lookup::RetrieveDSBlocks(vector<DSBlock>& dsBlocks, uint64_t& lowBlockNum,
     highBlockNum = curBlockNum;
   }
 
-  uint64_t blockNum;
-  for (blockNum = lowBlockNum; blockNum <= highBlockNum; blockNum++) {
-    try {
-      DSBlock dsblk = m_mediator.m_dsBlockChain.GetBlock(blockNum);
-      // TODO
-      // Workaround to identify dummy block as == comparator does not work on
-      // empty object for DSBlock and DSBlockheader().
-      if (dsblk.GetHeader().GetBlockNum() == INIT_BLOCK_NUMBER) {
-        LOG_GENERAL(WARNING,
-                    "Block Number " << blockNum << " does not exists.");
-        break;
-      }
+  return true;
+}
 
-      dsBlocks.emplace_back(m_mediator.m_dsBlockChain.GetBlock(blockNum));
-    } catch (const char* e) {
-      LOG_GENERAL(INFO, "Block Number " << blockNum
-                                        << " absent. Didn't include it in "
-                                           "response message. Reason: "
-                                        << e);
-      break;
-    }
+bool Lookup::GetDSBlockFromChain(const uint64_t& blockNum, DSBlock& dsBlock) {
+  try {
+    dsBlock = m_mediator.m_dsBlockChain.GetBlock(blockNum);
+  } catch (const char* e) {
+    LOG_GENERAL(INFO, "Block Number " << blockNum
+                                      << " absent. Didn't include it in "
+                                         "response message. Reason: "
+                                      << e);
+    return false;
   }
 
-  // Reset the highBlockNum value if retrieval failed
-  if (blockNum != highBlockNum + 1) {
-    highBlockNum = blockNum - 1;
+  // TODO
+  // Workaround to identify dummy block as == comparator does not work on
+  // empty object for DSBlock and DSBlockheader().
+  if (dsBlock.GetHeader().GetBlockNum() == INIT_BLOCK_NUMBER) {
+    LOG_GENERAL(WARNING, "Block Number " << blockNum << " does not exists.");
+    return false;
+  }
+
+  return true;
+}
+
+void Lookup::RetrieveDSBlocks(vector<DSBlock>& dsBlocks, uint64_t& lowBlockNum,
+                              uint64_t& highBlockNum, bool partialRetrieve) {
+  lock_guard<mutex> g(m_mediator.m_node->m_mutexDSBlock);
+
+  if (!GetDSBlockRange(lowBlockNum, highBlockNum, partialRetrieve)) {
+    return;
   }
+
+  RetrieveBlockRange(lowBlockNum, highBlockNum,
+                     [this, &dsBlocks](const uint64_t& blockNum) -> bool {
+                       DSBlock dsBlock;
+                       if (!GetDSBlockFromChain(blockNum, dsBlock)) {
+                         return false;
+                       }
+                       dsBlocks.emplace_back(move(dsBlock));
+                       return true;
+                     });
+}
+
+void Lookup::RetrieveSerializedDSBlocks(
+    vector<shared_ptr<const bytes>>& dsBlocks, uint64_t& lowBlockNum,
+    uint64_t& highBlockNum) {
+  lock_guard<mutex> g(m_mediator.m_node->m_mutexDSBlock);
+
+  if (!GetDSBlockRange(lowBlockNum, highBlockNum, false)) {
+    return;
+  }
+
+  RetrieveBlockRange(
+      lowBlockNum, highBlockNum,
+      [this, &dsBlocks](const uint64_t& blockNum) -> bool {
+        auto encodedBlock = m_serializedDSBlockCache.Get(blockNum);
+        if (encodedBlock == nullptr) {
+          bytes body;
+          if (!BlockStorage::GetBlockStorage().GetSerializedDSBlock(blockNum,
+                                                                   body)) {
+            DSBlock dsBlock;
+            if (!GetDSBlockFromChain(blockNum, dsBlock)) {
+              return false;
+            }
+            if (!dsBlock.Serialize(body, 0)) {
+              LOG_GENERAL(WARNING, "DSBlock " << blockNum
+                                              << " serialization failed");
+              return false;
+            }
+          }
+          encodedBlock = make_shared<const bytes>(move(body));
+          m_serializedDSBlockCache.Put(blockNum, encodedBlock);
+        }
+        dsBlocks.emplace_back(encodedBlock);
+        return true;
+      });
 }
 
 bool Lookup::ProcessGetStateFromSeed(const bytes& message, unsigned int offset,
@@ -1086,6 +1502,129 @@ bool Lookup::ProcessGetStateFromSeed(const bytes& message, unsigned int offset,
   return true;
 }
 
+shared_ptr<StateSnapshot> Lookup::GetStateSnapshot(const uint64_t& txBlockNum) {
+  lock_guard<mutex> g(m_mutexStateSnapshot);
+
+  for (const auto& stateSnapshot : {m_stateSnapshot, m_prevStateSnapshot}) {
+    if (stateSnapshot != nullptr &&
+        stateSnapshot->GetManifest().m_txBlockNum == txBlockNum) {
+      return stateSnapshot;
+    }
+  }
+
+  const TxBlock txBlock = m_mediator.m_txBlockChain.GetLastBlock();
+  if (txBlock.GetHeader().GetBlockNum() != txBlockNum) {
+    LOG_GENERAL(WARNING, "No state snapshot for TxBlock " << txBlockNum);
+    return nullptr;
+  }
+
+  auto stateSnapshot = make_shared<StateSnapshot>();
+  if (!stateSnapshot->Export(txBlockNum,
+                             txBlock.GetHeader().GetStateRootHash())) {
+    LOG_GENERAL(WARNING, "StateSnapshot::Export failed");
+    return nullptr;
+  }
+
+  m_prevStateSnapshot = move(m_stateSnapshot);
+  m_stateSnapshot = stateSnapshot;
+  return m_stateSnapshot;
+}
+
+bool Lookup::ProcessGetStateSnapshotManifestFromSeed(const bytes& message,
+                                                     unsigned int offset,
+                                                     const Peer& from) {
+  if (!LOOKUP_NODE_MODE) {
+    LOG_GENERAL(WARNING,
+                "Lookup::ProcessGetStateSnapshotManifestFromSeed not expected "
+                "to be called from other than the LookUp node.");
+    return true;
+  }
+
+  LOG_MARKER();
+
+  uint32_t portNo = 0;
+
+  if (!Messenger::GetLookupGetStateSnapshotManifestFromSeed(message, offset,
+                                                            portNo)) {
+    LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
+              "Messenger::GetLookupGetStateSnapshotManifestFromSeed failed.");
+    return false;
+  }
+
+  auto stateSnapshot = GetStateSnapshot(
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum());
+  if (stateSnapshot == nullptr) {
+    return false;
+  }
+
+  bytes setManifestMessage = {
+      MessageType::LOOKUP,
+      LookupInstructionType::SETSTATESNAPSHOTMANIFESTFROMSEED};
+
+  if (!Messenger::SetLookupSetStateSnapshotManifestFromSeed(
+          setManifestMessage, MessageOffset::BODY, m_mediator.m_selfKey,
+          stateSnapshot->GetManifest())) {
+    LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
+              "Messenger::SetLookupSetStateSnapshotManifestFromSeed failed.");
+    return false;
+  }
+
+  Peer requestingNode(from.m_ipAddress, portNo);
+  P2PComm::GetInstance().SendMessage(requestingNode, setManifestMessage);
+
+  return true;
+}
+
+bool Lookup::ProcessGetStateSnapshotChunkFromSeed(const bytes& message,
+                                                  unsigned int offset,
+                                                  const Peer& from) {
+  if (!LOOKUP_NODE_MODE) {
+    LOG_GENERAL(WARNING,
+                "Lookup::ProcessGetStateSnapshotChunkFromSeed not expected to "
+                "be called from other than the LookUp node.");
+    return true;
+  }
+
+  uint64_t txBlockNum = 0;
+  dev::h256 chunkHash;
+  uint32_t portNo = 0;
+
+  if (!Messenger::GetLookupGetStateSnapshotChunkFromSeed(
+          message, offset, txBlockNum, chunkHash, portNo)) {
+    LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
+              "Messenger::GetLookupGetStateSnapshotChunkFromSeed failed.");
+    return false;
+  }
+
+  auto stateSnapshot = GetStateSnapshot(txBlockNum);
+  if (stateSnapshot == nullptr) {
+    return false;
+  }
+
+  auto chunk = stateSnapshot->GetChunk(chunkHash);
+  if (chunk == nullptr) {
+    LOG_GENERAL(WARNING, "Chunk " << chunkHash << " not in state snapshot of "
+                                  << "TxBlock " << txBlockNum);
+    return false;
+  }
+
+  bytes setChunkMessage = {
+      MessageType::LOOKUP,
+      LookupInstructionType::SETSTATESNAPSHOTCHUNKFROMSEED};
+
+  if (!Messenger::SetLookupSetStateSnapshotChunkFromSeed(
+          setChunkMessage, MessageOffset::BODY, *chunk)) {
+    LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
+              "Messenger::SetLookupSetStateSnapshotChunkFromSeed failed.");
+    return false;
+  }
+
+  Peer requestingNode(from.m_ipAddress, portNo);
+  P2PComm::GetInstance().SendMessage(requestingNode, setChunkMessage);
+
+  return true;
+}
+
 // TODO: Refactor the code to remove the following assumption
 // lowBlockNum = 1 => Latest block number
 // lowBlockNum = 0 => lowBlockNum set to 1
@@ -1117,21 +1656,31 @@ bool Lookup::ProcessGetTxBlockFromSeed(const bytes& message,
                                                       << lowBlockNum << " to "
                                                       << highBlockNum);
 
-  vector<TxBlock> txBlocks;
-  RetrieveTxBlocks(txBlocks, lowBlockNum, highBlockNum);
+  vector<shared_ptr<const bytes>> txBlocks;
+  RetrieveSerializedTxBlocks(txBlocks, lowBlockNum, highBlockNum);
 
-  bytes txBlockMessage = {MessageType::LOOKUP,
-                          LookupInstructionType::SETTXBLOCKFROMSEED};
-  if (!Messenger::SetLookupSetTxBlockFromSeed(
-          txBlockMessage, MessageOffset::BODY, lowBlockNum, highBlockNum,
-          m_mediator.m_selfKey, txBlocks)) {
-    LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
-              "Messenger::SetLookupSetTxBlockFromSeed failed.");
-    return false;
+  // A resolved range always maps to the same blocks, so the signed response
+  // can be reused for every node requesting it
+  auto txBlockMessage = m_txBlockRangeMsgCache.Get({lowBlockNum, highBlockNum});
+  if (txBlockMessage == nullptr) {
+    bytes msg = {MessageType::LOOKUP, LookupInstructionType::SETTXBLOCKFROMSEED};
+
+    if (!Messenger::SetLookupSetTxBlockFromSeed(
+            msg, MessageOffset::BODY, lowBlockNum, highBlockNum,
+            m_mediator.m_selfKey, txBlocks)) {
+      LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
+                "Messenger::SetLookupSetTxBlockFromSeed failed.");
+      return false;
+    }
+
+    txBlockMessage = make_shared<const bytes>(move(msg));
+    if (!txBlocks.empty()) {
+      m_txBlockRangeMsgCache.Put({lowBlockNum, highBlockNum}, txBlockMessage);
+    }
   }
 
   Peer requestingNode(from.m_ipAddress, portNo);
-  P2PComm::GetInstance().SendMessage(requestingNode, txBlockMessage);
+  P2PComm::GetInstance().SendMessage(requestingNode, *txBlockMessage);
   LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
             "Sent Txblks " << lowBlockNum << " - " << highBlockNum);
   return true;
@@ -1141,16 +1690,13 @@ bool Lookup::ProcessGetTxBlockFromSeed(const bytes& message,
 // lowBlockNum = 1 => Latest block number
 // lowBlockNum = 0 => lowBlockNum set to 1
 // highBlockNum = 0 => Latest block number
-void Lookup::RetrieveTxBlocks(vector<TxBlock>& txBlocks, uint64_t& lowBlockNum,
-                              uint64_t& highBlockNum) {
-  lock_guard<mutex> g(m_mediator.m_node->m_mutexFinalBlock);
-
+bool Lookup::GetTxBlockRange(uint64_t& lowBlockNum, uint64_t& highBlockNum) {
   if (lowBlockNum == 0) {
     lowBlockNum = 1;
   }
 
   uint64_t lowestLimitNum =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetEpochNum();
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetEpochNum();
   if (lowBlockNum < lowestLimitNum) {
     LOG_GENERAL(WARNING,
                 "Requested number of txBlocks are beyond the current DS epoch "
@@ -1162,43 +1708,93 @@ void Lookup::RetrieveTxBlocks(vector<TxBlock>& txBlocks, uint64_t& lowBlockNum,
 
   if (highBlockNum == 0) {
     highBlockNum =
-        m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+        m_mediator.m_txBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
   }
 
   if (INIT_BLOCK_NUMBER == highBlockNum) {
     LOG_GENERAL(WARNING,
                 "Blockchain is still bootstraping, no tx blocks available.");
-    return;
+    return false;
   }
 
-  uint64_t blockNum;
-  for (blockNum = lowBlockNum; blockNum <= highBlockNum; blockNum++) {
-    try {
-      TxBlock txblk = m_mediator.m_txBlockChain.GetBlock(blockNum);
-      // TODO
-      // Workaround to identify dummy block as == comparator does not work on
-      // empty object for TxBlock and TxBlockheader().
-      if (txblk.GetHeader().GetBlockNum() == INIT_BLOCK_NUMBER &&
-          txblk.GetHeader().GetDSBlockNum() == INIT_BLOCK_NUMBER) {
-        LOG_GENERAL(WARNING,
-                    "Block Number " << blockNum << " does not exists.");
-        break;
-      }
-      txBlocks.emplace_back(txblk);
-    } catch (const char* e) {
-      LOG_GENERAL(INFO, "Block Number " << blockNum
-                                        << " absent. Didn't include it in "
-                                           "response message. Reason: "
-                                        << e);
-      break;
-    }
+  return true;
+}
+
+bool Lookup::GetTxBlockFromChain(const uint64_t& blockNum, TxBlock& txBlock) {
+  try {
+    txBlock = m_mediator.m_txBlockChain.GetBlock(blockNum);
+  } catch (const char* e) {
+    LOG_GENERAL(INFO, "Block Number " << blockNum
+                                      << " absent. Didn't include it in "
+                                         "response message. Reason: "
+                                      << e);
+    return false;
   }
 
-  // if serialization got interrupted in between, reset the highBlockNum value
-  // in msg
-  if (blockNum != highBlockNum + 1) {
-    highBlockNum = blockNum - 1;
+  // TODO
+  // Workaround to identify dummy block as == comparator does not work on
+  // empty object for TxBlock and TxBlockheader().
+  if (txBlock.GetHeader().GetBlockNum() == INIT_BLOCK_NUMBER &&
+      txBlock.GetHeader().GetDSBlockNum() == INIT_BLOCK_NUMBER) {
+    LOG_GENERAL(WARNING, "Block Number " << blockNum << " does not exists.");
+    return false;
   }
+
+  return true;
+}
+
+void Lookup::RetrieveTxBlocks(vector<TxBlock>& txBlocks, uint64_t& lowBlockNum,
+                              uint64_t& highBlockNum) {
+  lock_guard<mutex> g(m_mediator.m_node->m_mutexFinalBlock);
+
+  if (!GetTxBlockRange(lowBlockNum, highBlockNum)) {
+    return;
+  }
+
+  RetrieveBlockRange(lowBlockNum, highBlockNum,
+                     [this, &txBlocks](const uint64_t& blockNum) -> bool {
+                       TxBlock txBlock;
+                       if (!GetTxBlockFromChain(blockNum, txBlock)) {
+                         return false;
+                       }
+                       txBlocks.emplace_back(move(txBlock));
+                       return true;
+                     });
+}
+
+void Lookup::RetrieveSerializedTxBlocks(
+    vector<shared_ptr<const bytes>>& txBlocks, uint64_t& lowBlockNum,
+    uint64_t& highBlockNum) {
+  lock_guard<mutex> g(m_mediator.m_node->m_mutexFinalBlock);
+
+  if (!GetTxBlockRange(lowBlockNum, highBlockNum)) {
+    return;
+  }
+
+  RetrieveBlockRange(
+      lowBlockNum, highBlockNum,
+      [this, &txBlocks](const uint64_t& blockNum) -> bool {
+        auto encodedBlock = m_serializedTxBlockCache.Get(blockNum);
+        if (encodedBlock == nullptr) {
+          bytes body;
+          if (!BlockStorage::GetBlockStorage().GetSerializedTxBlock(blockNum,
+                                                                   body)) {
+            TxBlock txBlock;
+            if (!GetTxBlockFromChain(blockNum, txBlock)) {
+              return false;
+            }
+            if (!txBlock.Serialize(body, 0)) {
+              LOG_GENERAL(WARNING, "TxBlock " << blockNum
+                                              << " serialization failed");
+              return false;
+            }
+          }
+          encodedBlock = make_shared<const bytes>(move(body));
+          m_serializedTxBlockCache.Put(blockNum, encodedBlock);
+        }
+        txBlocks.emplace_back(encodedBlock);
+        return true;
+      });
 }
 
 bool Lookup::ProcessGetStateDeltaFromSeed(const bytes& message,
@@ -1319,8 +1915,10 @@ bool Lookup::ProcessGetShardFromSeed([[gnu::unused]] const bytes& message,
   LOG_MARKER();
 
   uint32_t portNo = 0;
+  uint64_t requestId = 0;
 
-  if (!Messenger::GetLookupGetShardsFromSeed(message, offset, portNo)) {
+  if (!Messenger::GetLookupGetShardsFromSeed(message, offset, portNo,
+                                             requestId)) {
     LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
               "Messenger::GetLookupGetShardsFromSeed failed.");
     return false;
@@ -1333,7 +1931,7 @@ bool Lookup::ProcessGetShardFromSeed([[gnu::unused]] const bytes& message,
 
   if (!Messenger::SetLookupSetShardsFromSeed(
           msg, MessageOffset::BODY, m_mediator.m_selfKey,
-          SHARDINGSTRUCTURE_VERSION, m_mediator.m_ds->m_shards)) {
+          SHARDINGSTRUCTURE_VERSION, m_mediator.m_ds->m_shards, requestId)) {
     LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
               "Messenger::SetLookupSetShardsFromSeed failed.");
     return false;
@@ -1353,8 +1951,10 @@ bool Lookup::ProcessSetShardFromSeed([[gnu::unused]] const bytes& message,
   DequeOfShard shards;
   PubKey lookupPubKey;
   uint32_t shardingStructureVersion = 0;
-  if (!Messenger::GetLookupSetShardsFromSeed(
-          message, offset, lookupPubKey, shardingStructureVersion, shards)) {
+  uint64_t requestId = 0;
+  if (!Messenger::GetLookupSetShardsFromSeed(message, offset, lookupPubKey,
+                                             shardingStructureVersion, shards,
+                                             requestId)) {
     LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
               "Messenger::GetLookupSetShardsFromSeed failed.");
     return false;
@@ -1380,23 +1980,70 @@ bool Lookup::ProcessSetShardFromSeed([[gnu::unused]] const bytes& message,
     LOG_GENERAL(INFO, "Size of shard " << i << " " << shard.size());
     i++;
   }
-  lock_guard<mutex> g(m_mediator.m_ds->m_mutexShards);
-
-  m_mediator.m_ds->m_shards = move(shards);
 
+  // Only the requester uses the structure, as it is not verified yet
+  {
+    lock_guard<mutex> g(m_mutexShardStruct);
+    if (m_shardStructReady || requestId != m_shardStructRequestId) {
+      LOG_GENERAL(WARNING, "Ignoring sharding structure for request "
+                               << requestId << ", expecting "
+                               << m_shardStructRequestId);
+      return false;
+    }
+    m_shardStructReply = move(shards);
+    m_shardStructReady = true;
+  }
   cv_shardStruct.notify_all();
 
   return true;
 }
 
-// UNUSED
-bool Lookup::GetShardFromLookup() {
+bool Lookup::RequestShardingStructure(const bool fromSeedNode,
+                                      const chrono::milliseconds& timeout,
+                                      DequeOfShard& shards) {
+  LOG_MARKER();
+
+  unique_lock<mutex> cv_lk(m_mutexShardStruct);
+
+  const uint64_t requestId = ++m_shardStructRequestId;
+  m_shardStructReady = false;
+  m_shardStructReply.clear();
+
+  if (!(fromSeedNode ? ComposeAndSendGetShardingStructureFromSeed(requestId)
+                     : GetShardFromLookup(requestId))) {
+    return false;
+  }
+
+  // Give up early if a newer request took over the slot
+  if (!cv_shardStruct.wait_for(cv_lk, timeout, [this, requestId]() {
+        return m_shardStructReady || m_shardStructRequestId != requestId;
+      }) ||
+      m_shardStructRequestId != requestId) {
+    LOG_GENERAL(WARNING, "Didn't receive sharding structure for request "
+                             << requestId);
+    return false;
+  }
+
+  shards = move(m_shardStructReply);
+  m_shardStructReply.clear();
+
+  return true;
+}
+
+bool Lookup::FetchShardingStructure(DequeOfShard& shards) {
+  return RequestShardingStructure(
+      false, chrono::milliseconds(SHARDINGSTRUCTURE_FETCH_TIMEOUT_IN_MS),
+      shards);
+}
+
+bool Lookup::GetShardFromLookup(const uint64_t& requestId) {
   LOG_MARKER();
 
   bytes msg = {MessageType::LOOKUP, LookupInstructionType::GETSHARDSFROMSEED};
 
   if (!Messenger::SetLookupGetShardsFromSeed(
-          msg, MessageOffset::BODY, m_mediator.m_selfPeer.m_listenPortHost)) {
+          msg, MessageOffset::BODY, m_mediator.m_selfPeer.m_listenPortHost,
+          requestId)) {
     LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
               "Messenger::SetLookupGetShardsFromSeed failed.");
     return false;
@@ -1672,12 +2319,15 @@ bool Lookup::ProcessSetDSInfoFromSeed(const bytes& message, unsigned int offset,
     LOG_GENERAL(INFO, "[DSINFOVERIF] Success");
   }
 
-  lock_guard<mutex> g(m_mediator.m_mutexDSCommittee);
-  *m_mediator.m_DSCommittee = move(dsNodes);
+  {
+    lock_guard<mutex> g(m_mediator.m_mutexDSCommittee);
+    *m_mediator.m_DSCommittee = move(dsNodes);
 
-  // Add ds guard to exclude list for lookup at bootstrap
-  Guard::GetInstance().AddDSGuardToBlacklistExcludeList(
-      *m_mediator.m_DSCommittee);
+    // Add ds guard to exclude list for lookup at bootstrap
+    Guard::GetInstance().AddDSGuardToBlacklistExcludeList(
+        *m_mediator.m_DSCommittee);
+  }
+  m_mediator.UpdateCommitteeView();
 
   //    Data::GetInstance().SetDSPeers(dsPeers);
   //#endif // IS_LOOKUP_NODE
@@ -1754,7 +2404,7 @@ bool Lookup::ProcessSetDSBlockFromSeed(const bytes& message,
       return true;
     }
     uint64_t dsblocknumbefore =
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+        m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
     uint64_t index_num = m_mediator.m_blocklinkchain.GetLatestIndex() + 1;
 
     DequeOfNode newDScomm;
@@ -1765,7 +2415,7 @@ bool Lookup::ProcessSetDSBlockFromSeed(const bytes& message,
     }
     m_mediator.m_blocklinkchain.SetBuiltDSComm(newDScomm);
     uint64_t dsblocknumafter =
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+        m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
 
     LOG_GENERAL(INFO, "DS epoch before" << dsblocknumbefore + 1
                                         << " DS epoch now "
@@ -1797,8 +2447,6 @@ bool Lookup::ProcessSetTxBlockFromSeed(const bytes& message,
     return true;
   }
 
-  unique_lock<mutex> lock(m_mutexSetTxBlockFromSeed);
-
   uint64_t lowBlockNum = 0;
   uint64_t highBlockNum = 0;
   std::vector<TxBlock> txBlocks;
@@ -1838,6 +2486,12 @@ bool Lookup::ProcessSetTxBlockFromSeed(const bytes& message,
     GetWorkServer::GetInstance().SetNextPoWTime(now + wait_seconds);
   }
 
+  if (ProcessTxBlockSyncChunk(lowBlockNum, highBlockNum, txBlocks)) {
+    return true;
+  }
+
+  unique_lock<mutex> lock(m_mutexSetTxBlockFromSeed);
+
   if (lowBlockNum > highBlockNum) {
     LOG_GENERAL(
         WARNING,
@@ -2013,8 +2667,8 @@ void Lookup::CommitTxBlocks(const vector<TxBlock>& txBlocks) {
     }
   }
 
-  m_mediator.m_currentEpochNum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+  m_mediator.SetEpochNum(
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum());
   // To trigger m_isVacuousEpoch calculation
   m_mediator.IncreaseEpochNum();
 
@@ -2060,6 +2714,70 @@ void Lookup::CommitTxBlocks(const vector<TxBlock>& txBlocks) {
   cv_waitJoined.notify_all();
 }
 
+bool Lookup::ProcessTxBlockSyncChunk(const uint64_t& lowBlockNum,
+                                     const uint64_t& highBlockNum,
+                                     vector<TxBlock>& txBlocks) {
+  {
+    lock_guard<mutex> g(m_mutexTxBlockSync);
+    auto it = m_txBlockSyncChunks.find(lowBlockNum);
+    // A seed raises lowBlockNum to the start of its DS epoch, and only ever
+    // lowers highBlockNum, so a reply for another range never lies within
+    // the chunk starting at lowBlockNum
+    if (it == m_txBlockSyncChunks.end() || (lowBlockNum > highBlockNum) ||
+        (highBlockNum > it->second.m_highBlockNum)) {
+      return false;
+    }
+    if (it->second.m_received) {
+      // Already delivered by a faster seed
+      return true;
+    }
+  }
+
+  // Validated outside of m_mutexTxBlockSync so that chunks arriving from
+  // different seeds are checked concurrently. An empty reply fails too, so
+  // that the chunk is asked of another seed.
+  auto res = ValidatorBase::TxBlockValidationMsg::INVALID;
+  if (txBlocks.empty()) {
+    LOG_GENERAL(WARNING, "No block actually sent");
+  } else if ((txBlocks.front().GetHeader().GetBlockNum() == lowBlockNum) &&
+             (txBlocks.back().GetHeader().GetBlockNum() == highBlockNum) &&
+             (txBlocks.size() == highBlockNum - lowBlockNum + 1)) {
+    res = m_mediator.m_validator->CheckTxBlocks(
+        txBlocks, m_mediator.m_blocklinkchain.GetBuiltDSComm(),
+        m_mediator.m_blocklinkchain.GetLatestBlockLink());
+  }
+
+  lock_guard<mutex> g(m_mutexTxBlockSync);
+  auto it = m_txBlockSyncChunks.find(lowBlockNum);
+  if (it == m_txBlockSyncChunks.end() || it->second.m_received) {
+    return true;
+  }
+
+  switch (res) {
+    case ValidatorBase::TxBlockValidationMsg::VALID:
+      it->second.m_received = true;
+      it->second.m_txBlocks = move(txBlocks);
+      break;
+    case ValidatorBase::TxBlockValidationMsg::STALEDSINFO:
+      LOG_GENERAL(INFO, "[TxBlockVerif]"
+                            << "Stale DS info, sync round aborted");
+      it->second.m_received = true;
+      it->second.m_txBlocks = move(txBlocks);
+      m_txBlockSyncStale = true;
+      break;
+    default:
+      // Let the chunk time out now so that it is re-assigned to another seed
+      LOG_GENERAL(WARNING, "[TxBlockVerif]"
+                               << "Invalid blocks " << lowBlockNum << "-"
+                               << highBlockNum);
+      it->second.m_requestedAt = chrono::steady_clock::time_point();
+      break;
+  }
+
+  cv_txBlockSync.notify_all();
+  return true;
+}
+
 const vector<Transaction>& Lookup::GetTxnFromShardMap(uint32_t index) {
   return m_txnShardMap[index];
 }
@@ -2104,8 +2822,8 @@ bool Lookup::ProcessSetStateDeltaFromSeed(const bytes& message,
   }
 
   m_mediator.m_ds->SaveCoinbase(
-      m_mediator.m_txBlockChain.GetLastBlock().GetB1(),
-      m_mediator.m_txBlockChain.GetLastBlock().GetB2(),
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetB1(),
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetB2(),
       CoinbaseReward::FINALBLOCK_REWARD, m_mediator.m_currentEpochNum);
   cv_setStateDeltaFromSeed.notify_all();
   return true;
@@ -2148,41 +2866,79 @@ bool Lookup::ProcessSetStateDeltasFromSeed(const bytes& message,
                 << from << " for blocks: " << lowBlockNum << " to "
                 << highBlockNum);
 
-  if (stateDeltas.size() != (highBlockNum - lowBlockNum + 1)) {
-    LOG_GENERAL(WARNING,
-                "StateDeltas recvd:" << stateDeltas.size() << " , Expected: "
-                                     << highBlockNum - lowBlockNum + 1);
-    return false;
-  }
+  if (stateDeltas.size() != (highBlockNum - lowBlockNum + 1)) {
+    LOG_GENERAL(WARNING,
+                "StateDeltas recvd:" << stateDeltas.size() << " , Expected: "
+                                     << highBlockNum - lowBlockNum + 1);
+    return false;
+  }
+
+  // Deltas not applied yet are coalesced and written to the state trie once,
+  // before each flush of the state to disk
+  vector<uint64_t> pendingBlockNums;
+  vector<bytes> pendingDeltas;
+  auto applyPendingDeltas = [this, &pendingBlockNums,
+                             &pendingDeltas]() -> bool {
+    if (pendingDeltas.empty()) {
+      return true;
+    }
+
+    bytes mergedDelta;
+    if (pendingDeltas.size() > 1 &&
+        !Messenger::MergeAccountStoreDeltas(pendingDeltas, mergedDelta, 0)) {
+      LOG_GENERAL(WARNING, "Messenger::MergeAccountStoreDeltas failed");
+      return false;
+    }
+
+    if (!AccountStore::GetInstance().DeserializeDelta(
+            pendingDeltas.size() > 1 ? mergedDelta : pendingDeltas.front(),
+            0)) {
+      LOG_GENERAL(WARNING,
+                  "AccountStore::GetInstance().DeserializeDelta failed");
+      return false;
+    }
+    m_prevStateRootHashTemp = AccountStore::GetInstance().GetStateRootHash();
+
+    for (unsigned int i = 0; i < pendingDeltas.size(); i++) {
+      if (!BlockStorage::GetBlockStorage().PutStateDelta(pendingBlockNums[i],
+                                                         pendingDeltas[i])) {
+        LOG_GENERAL(WARNING, "BlockStorage::PutStateDelta failed");
+        return false;
+      }
+    }
+
+    pendingBlockNums.clear();
+    pendingDeltas.clear();
+    return true;
+  };
 
   int txBlkNum = lowBlockNum;
   bytes tmp;
   for (const auto& delta : stateDeltas) {
     // TBD - To verify state delta hash against one from TxBlk.
     // But not crucial right now since we do verify sender i.e lookup and trust
-    // it.
+    // it. The merged state is checked against the last TxBlk in
+    // CommitTxBlocks.
 
     if (!BlockStorage::GetBlockStorage().GetStateDelta(txBlkNum, tmp)) {
-      if (!AccountStore::GetInstance().DeserializeDelta(delta, 0)) {
-        LOG_GENERAL(WARNING,
-                    "AccountStore::GetInstance().DeserializeDelta failed");
-        return false;
-      }
-      if (!BlockStorage::GetBlockStorage().PutStateDelta(txBlkNum, delta)) {
-        LOG_GENERAL(WARNING, "BlockStorage::PutStateDelta failed");
-        return false;
-      }
-      m_prevStateRootHashTemp = AccountStore::GetInstance().GetStateRootHash();
+      pendingBlockNums.emplace_back(txBlkNum);
+      pendingDeltas.emplace_back(delta);
     }
     if ((txBlkNum + 1) % NUM_FINAL_BLOCK_PER_POW == 0) {
       if (ENABLE_REPOPULATE && ((txBlkNum + 1) % (NUM_FINAL_BLOCK_PER_POW *
                                                   REPOPULATE_STATE_PER_N_DS) ==
                                 REPOPULATE_STATE_IN_DS)) {
+        if (!applyPendingDeltas()) {
+          return false;
+        }
         if (!AccountStore::GetInstance().MoveUpdatesToDisk(true)) {
           LOG_GENERAL(WARNING, "AccountStore::MoveUpdatesToDisk(true) failed");
           return false;
         }
       } else if (txBlkNum + NUM_FINAL_BLOCK_PER_POW > highBlockNum) {
+        if (!applyPendingDeltas()) {
+          return false;
+        }
         if (!AccountStore::GetInstance().MoveUpdatesToDisk(false)) {
           LOG_GENERAL(WARNING, "AccountStore::MoveUpdatesToDisk(false) failed");
           return false;
@@ -2192,6 +2948,10 @@ bool Lookup::ProcessSetStateDeltasFromSeed(const bytes& message,
     txBlkNum++;
   }
 
+  if (!applyPendingDeltas()) {
+    return false;
+  }
+
   cv_setStateDeltasFromSeed.notify_all();
   return true;
 }
@@ -2226,6 +2986,191 @@ bool Lookup::ProcessSetStateFromSeed(const bytes& message, unsigned int offset,
     return false;
   }
 
+  return FinishStateSync();
+}
+
+bool Lookup::ProcessSetStateSnapshotManifestFromSeed(
+    const bytes& message, unsigned int offset,
+    [[gnu::unused]] const Peer& from) {
+  LOG_MARKER();
+
+  if (AlreadyJoinedNetwork()) {
+    return true;
+  }
+
+  PubKey lookupPubKey;
+  StateSnapshotManifest manifest;
+  if (!Messenger::GetLookupSetStateSnapshotManifestFromSeed(
+          message, offset, lookupPubKey, manifest)) {
+    LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
+              "Messenger::GetLookupSetStateSnapshotManifestFromSeed failed.");
+    return false;
+  }
+
+  if (!VerifySenderNode(GetSeedNodes(), lookupPubKey)) {
+    LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
+              "The message sender pubkey: "
+                  << lookupPubKey << " is not in my lookup node list.");
+    return false;
+  }
+
+  // The snapshot must match the state committed by a TxBlock that has
+  // already been validated. The seed may be ahead of this node, in which
+  // case the full state is requested instead.
+  const TxBlock txBlock =
+      m_mediator.m_txBlockChain.GetBlock(manifest.m_txBlockNum);
+  if (txBlock.GetHeader().GetBlockNum() != manifest.m_txBlockNum) {
+    LOG_GENERAL(WARNING, "Missing TxBlock " << manifest.m_txBlockNum
+                                            << " for state snapshot");
+    FallBackToFullState();
+    return false;
+  }
+  if (txBlock.GetHeader().GetStateRootHash() != manifest.m_stateRoot) {
+    LOG_CHECK_FAIL("Snapshot state root", manifest.m_stateRoot,
+                   txBlock.GetHeader().GetStateRootHash());
+    FallBackToFullState();
+    return false;
+  }
+
+  {
+    lock_guard<mutex> g(m_mutexStateSnapshotImport);
+    if (!m_stateSnapshotManifestPending || m_stateSnapshotImportRunning) {
+      return true;
+    }
+    m_stateSnapshotManifestPending = false;
+    cv_stateSnapshotImport.notify_all();
+
+    // Chunks imported by an earlier attempt on the same state are kept
+    if (m_stateSnapshotImport == nullptr ||
+        m_stateSnapshotImport->GetManifest().m_stateRoot !=
+            manifest.m_stateRoot) {
+      m_stateSnapshotImport = make_shared<StateSnapshot>();
+      m_stateSnapshotImport->StartImport(manifest);
+    }
+    m_stateSnapshotImportRunning = true;
+  }
+
+  LOG_GENERAL(INFO, "Importing state snapshot of TxBlock "
+                        << manifest.m_txBlockNum << " in "
+                        << manifest.m_chunkHashes.size() << " chunks");
+
+  DetachedFunction(1, [this]() { DownloadStateSnapshot(); });
+
+  return true;
+}
+
+bool Lookup::ProcessSetStateSnapshotChunkFromSeed(
+    const bytes& message, unsigned int offset,
+    [[gnu::unused]] const Peer& from) {
+  bytes chunk;
+  if (!Messenger::GetLookupSetStateSnapshotChunkFromSeed(message, offset,
+                                                         chunk)) {
+    LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
+              "Messenger::GetLookupSetStateSnapshotChunkFromSeed failed.");
+    return false;
+  }
+
+  shared_ptr<StateSnapshot> stateSnapshot;
+  {
+    lock_guard<mutex> g(m_mutexStateSnapshotImport);
+    if (!m_stateSnapshotImportRunning) {
+      return true;
+    }
+    stateSnapshot = m_stateSnapshotImport;
+  }
+
+  // Chunks are content-addressed, so the manifest alone authenticates them
+  if (!stateSnapshot->ImportChunk(chunk)) {
+    LOG_GENERAL(WARNING, "StateSnapshot::ImportChunk failed");
+    return false;
+  }
+
+  lock_guard<mutex> g(m_mutexStateSnapshotImport);
+  cv_stateSnapshotImport.notify_all();
+
+  return true;
+}
+
+void Lookup::DownloadStateSnapshot() {
+  LOG_MARKER();
+
+  shared_ptr<StateSnapshot> stateSnapshot;
+  {
+    lock_guard<mutex> g(m_mutexStateSnapshotImport);
+    stateSnapshot = m_stateSnapshotImport;
+  }
+
+  const StateSnapshotManifest manifest = stateSnapshot->GetManifest();
+  const size_t numSeeds = GetSeedNodes().size();
+
+  bool success = false;
+  unsigned int retry = 0;
+  while (numSeeds > 0 && retry <= STATE_SNAPSHOT_MAX_RETRIES &&
+         !AlreadyJoinedNetwork()) {
+    const vector<dev::h256> missingChunks = stateSnapshot->GetMissingChunks();
+    if (missingChunks.empty()) {
+      success = stateSnapshot->FinishImport();
+      break;
+    }
+
+    // Spread the missing chunks over the seeds, moving each chunk to another
+    // seed on every retry
+    for (unsigned int i = 0; i < missingChunks.size(); i++) {
+      bytes getChunkMessage = {
+          MessageType::LOOKUP,
+          LookupInstructionType::GETSTATESNAPSHOTCHUNKFROMSEED};
+      if (!Messenger::SetLookupGetStateSnapshotChunkFromSeed(
+              getChunkMessage, MessageOffset::BODY, manifest.m_txBlockNum,
+              missingChunks[i], m_mediator.m_selfPeer.m_listenPortHost)) {
+        LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
+                  "Messenger::SetLookupGetStateSnapshotChunkFromSeed failed.");
+        continue;
+      }
+      SendMessageToSeedNode((i + retry) % numSeeds, getChunkMessage);
+    }
+
+    // Keep waiting as long as chunks keep arriving
+    const auto timeout =
+        chrono::seconds(STATE_SNAPSHOT_CHUNK_TIMEOUT_IN_SECONDS);
+    unique_lock<mutex> lock(m_mutexStateSnapshotImport);
+    while (!stateSnapshot->IsImportComplete() &&
+           cv_stateSnapshotImport.wait_for(lock, timeout) ==
+               cv_status::no_timeout) {
+    }
+
+    if (!stateSnapshot->IsImportComplete()) {
+      retry++;
+      LOG_GENERAL(WARNING, "[Retry: " << retry << "] "
+                                      << missingChunks.size()
+                                      << " state snapshot chunks requested, "
+                                      << "some still missing");
+    }
+  }
+
+  {
+    lock_guard<mutex> g(m_mutexStateSnapshotImport);
+    m_stateSnapshotImportRunning = false;
+    if (!success) {
+      m_stateSnapshotImport.reset();
+    }
+  }
+
+  if (AlreadyJoinedNetwork()) {
+    return;
+  }
+
+  if (!success) {
+    LOG_GENERAL(WARNING,
+                "State snapshot import failed, requesting the full state");
+    SendMessageToRandomSeedNode(ComposeGetStateMessage());
+    return;
+  }
+
+  unique_lock<mutex> lock(m_mutexSetState);
+  FinishStateSync();
+}
+
+bool Lookup::FinishStateSync() {
   if (!LOOKUP_NODE_MODE) {
     if (m_syncType == SyncType::NEW_SYNC ||
         m_syncType == SyncType::NORMAL_SYNC) {
@@ -2265,8 +3210,8 @@ bool Lookup::ProcessSetStateFromSeed(const bytes& message, unsigned int offset,
       if (!Messenger::SetLookupGetStartPoWFromSeed(
               getpowsubmission_message, MessageOffset::BODY,
               m_mediator.m_selfPeer.m_listenPortHost,
-              m_mediator.m_dsBlockChain.GetLastBlock()
-                  .GetHeader()
+              m_mediator.m_dsBlockChain.GetLastBlockPtr()
+                  ->GetHeader()
                   .GetBlockNum(),
               m_mediator.m_selfKey)) {
         LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
@@ -2466,7 +3411,7 @@ bool Lookup::InitMining(uint32_t lookupIndex) {
   }
 
   uint64_t curDsBlockNum =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
 
   m_mediator.UpdateDSBlockRand();
   auto dsBlockRand = m_mediator.m_dsBlockRand;
@@ -2490,7 +3435,7 @@ bool Lookup::InitMining(uint32_t lookupIndex) {
   m_mediator.m_node->StartPoW(
       curDsBlockNum + 1,
       m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDSDifficulty(),
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDifficulty(),
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetDifficulty(),
       dsBlockRand, txBlockRand, lookupIndex);
   //} else {
   //  LOG_GENERAL(WARNING, "State root check failed");
@@ -2498,14 +3443,14 @@ bool Lookup::InitMining(uint32_t lookupIndex) {
   //}
 
   uint64_t lastTxBlockNum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
 
   unique_lock<mutex> lk(m_mutexCVJoined);
   cv_waitJoined.wait(lk);
 
   m_startedPoW = false;
 
-  if (m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() >
+  if (m_mediator.m_txBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum() >
       lastTxBlockNum) {
     if (GetSyncType() != SyncType::NO_SYNC) {
       LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
@@ -2827,13 +3772,13 @@ bool Lookup::ProcessGetStartPoWFromSeed(const bytes& message,
   }
 
   if (blockNumber !=
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum()) {
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum()) {
     LOG_EPOCH(
         WARNING, m_mediator.m_currentEpochNum,
         "DS block " << blockNumber
                     << " in GetStartPoWFromSeed not equal to current DS block "
-                    << m_mediator.m_dsBlockChain.GetLastBlock()
-                           .GetHeader()
+                    << m_mediator.m_dsBlockChain.GetLastBlockPtr()
+                           ->GetHeader()
                            .GetBlockNum());
     return false;
   }
@@ -3194,15 +4139,24 @@ bool Lookup::CleanVariables() {
     std::lock_guard<mutex> lock(m_mediator.m_ds->m_mutexShards);
     m_mediator.m_ds->m_shards.clear();
   }
+  m_mediator.UpdateCommitteeView();
   {
     std::lock_guard<mutex> lock(m_mutexNodesInNetwork);
     m_nodesInNetwork.clear();
     l_nodesInNetwork.clear();
   }
+  ClearBlockCaches();
 
   return true;
 }
 
+void Lookup::ClearBlockCaches() {
+  m_serializedDSBlockCache.Clear();
+  m_serializedTxBlockCache.Clear();
+  m_dsBlockRangeMsgCache.Clear();
+  m_txBlockRangeMsgCache.Clear();
+}
+
 bool Lookup::ToBlockMessage(unsigned char ins_byte) {
   if (!LOOKUP_NODE_MODE) {
     LOG_GENERAL(WARNING,
@@ -3216,6 +4170,8 @@ bool Lookup::ToBlockMessage(unsigned char ins_byte) {
           ins_byte != LookupInstructionType::SETDSINFOFROMSEED &&
           ins_byte != LookupInstructionType::SETTXBLOCKFROMSEED &&
           ins_byte != LookupInstructionType::SETSTATEFROMSEED &&
+          ins_byte != LookupInstructionType::SETSTATESNAPSHOTMANIFESTFROMSEED &&
+          ins_byte != LookupInstructionType::SETSTATESNAPSHOTCHUNKFROMSEED &&
           ins_byte != LookupInstructionType::SETLOOKUPOFFLINE &&
           ins_byte != LookupInstructionType::SETLOOKUPONLINE &&
           ins_byte != LookupInstructionType::SETSTATEDELTAFROMSEED &&
@@ -3391,7 +4347,7 @@ bool Lookup::ProcessSetDirectoryBlocksFromSeed(
   DequeOfNode newDScomm;
 
   uint64_t dsblocknumbefore =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
   LOG_GENERAL(INFO, "[DSINFOVERIF]"
                         << "Recvd " << dirBlocks.size() << " from lookup");
   {
@@ -3412,7 +4368,7 @@ bool Lookup::ProcessSetDirectoryBlocksFromSeed(
     m_mediator.m_blocklinkchain.SetBuiltDSComm(newDScomm);
   }
   uint64_t dsblocknumafter =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
 
   if (dsblocknumafter > dsblocknumbefore) {
     if (m_syncType == SyncType::NO_SYNC &&
@@ -3488,19 +4444,22 @@ void Lookup::ComposeAndSendGetDirectoryBlocksFromSeed(const uint64_t& index_num,
   }
 }
 
-void Lookup::ComposeAndSendGetShardingStructureFromSeed() {
+bool Lookup::ComposeAndSendGetShardingStructureFromSeed(
+    const uint64_t& requestId) {
   LOG_MARKER();
   bytes message = {MessageType::LOOKUP,
                    LookupInstructionType::GETSHARDSFROMSEED};
 
   if (!Messenger::SetLookupGetShardsFromSeed(
-          message, MessageOffset::BODY,
-          m_mediator.m_selfPeer.m_listenPortHost)) {
+          message, MessageOffset::BODY, m_mediator.m_selfPeer.m_listenPortHost,
+          requestId)) {
     LOG_GENERAL(WARNING, "Messenger::SetLookupGetShardsFromSeed");
-    return;
+    return false;
   }
 
   SendMessageToRandomSeedNode(message);
+
+  return true;
 }
 
 bool Lookup::Execute(const bytes& message, unsigned int offset,
@@ -3528,8 +4487,8 @@ bool Lookup::Execute(const bytes& message, unsigned int offset,
       &Lookup::ProcessRaiseStartPoW,
       &Lookup::ProcessGetStartPoWFromSeed,
       &Lookup::ProcessSetStartPoWFromSeed,
-      &Lookup::ProcessGetShardFromSeed,         // UNUSED
-      &Lookup::ProcessSetShardFromSeed,         // UNUSED
+      &Lookup::ProcessGetShardFromSeed,
+      &Lookup::ProcessSetShardFromSeed,
       &Lookup::ProcessGetMicroBlockFromLookup,  // UNUSED
       &Lookup::ProcessSetMicroBlockFromLookup,  // UNUSED
       &Lookup::ProcessGetTxnsFromLookup,        // UNUSED
@@ -3543,7 +4502,11 @@ bool Lookup::Execute(const bytes& message, unsigned int offset,
       &Lookup::ProcessVCGetLatestDSTxBlockFromSeed,
       &Lookup::ProcessForwardTxn,
       &Lookup::ProcessGetDSGuardNetworkInfo,
-      &Lookup::ProcessSetHistoricalDB};
+      &Lookup::ProcessSetHistoricalDB,
+      &Lookup::ProcessGetStateSnapshotManifestFromSeed,
+      &Lookup::ProcessSetStateSnapshotManifestFromSeed,
+      &Lookup::ProcessGetStateSnapshotChunkFromSeed,
+      &Lookup::ProcessSetStateSnapshotChunkFromSeed};
 
   const unsigned char ins_byte = message.at(offset);
   const unsigned int ins_handlers_count =
@@ -3573,6 +4536,56 @@ bool Lookup::Execute(const bytes& message, unsigned int offset,
 
 bool Lookup::AlreadyJoinedNetwork() { return m_syncType == SyncType::NO_SYNC; }
 
+bool Lookup::InsertIntoTxnShardMap(const Transaction& tx, uint32_t shardId,
+                                   const bytes& encodedTxn) {
+  if (m_txnShardMapHashes.size() >= TXN_STORAGE_LIMIT) {
+    LOG_GENERAL(INFO, "Number of txns exceeded limit");
+    return false;
+  }
+
+  // case where txn already exist
+  if (!m_txnShardMapHashes.emplace(tx.GetTranID()).second) {
+    LOG_GENERAL(WARNING, "Same hash present " << tx.GetTranID());
+    return false;
+  }
+
+  m_txnShardMap[shardId].push_back(tx);
+
+  if (!ARCHIVAL_LOOKUP) {
+    AppendToTxnPackets(m_txnPackets[shardId], m_nextTxnPacketId,
+                       encodedTxn.begin(), encodedTxn.end());
+  }
+
+  return true;
+}
+
+void Lookup::DeleteFirstTxnPacket(uint32_t shardId, uint64_t packetId) {
+  // The shard map may have been shuffled since the packet was sent, which
+  // rebuilds all the packets
+  auto it = m_txnPackets.find(shardId);
+  if (it == m_txnPackets.end() || it->second.empty() ||
+      it->second.front().m_id != packetId) {
+    LOG_GENERAL(WARNING, "Packet " << packetId << " of shard " << shardId
+                                   << " no longer first, not deleted");
+    return;
+  }
+
+  const unsigned int numTxns = it->second.front().m_encodedTxnSizes.size();
+  auto& txns = m_txnShardMap[shardId];
+  if (txns.size() < numTxns) {
+    LOG_GENERAL(WARNING, "Packet " << packetId << " of shard " << shardId
+                                   << " has more txns than the shard");
+    return;
+  }
+
+  for (size_t i = 0; i < numTxns; i++) {
+    m_txnShardMapHashes.erase(txns[i].GetTranID());
+  }
+  txns.erase(txns.begin(), txns.begin() + numTxns);
+
+  it->second.pop_front();
+}
+
 bool Lookup::AddToTxnShardMap(const Transaction& tx, uint32_t shardId) {
   if (!LOOKUP_NODE_MODE) {
     LOG_GENERAL(WARNING,
@@ -3581,31 +4594,48 @@ bool Lookup::AddToTxnShardMap(const Transaction& tx, uint32_t shardId) {
     return true;
   }
 
+  // Encode before taking the lock, so that sending only needs to sign
+  bytes encodedTxn;
+  if (!ARCHIVAL_LOOKUP && !Messenger::SetTransaction(encodedTxn, 0, tx)) {
+    LOG_GENERAL(WARNING, "Messenger::SetTransaction failed");
+    return false;
+  }
+
   lock_guard<mutex> g(m_txnShardMapMutex);
 
-  uint32_t size = 0;
+  return InsertIntoTxnShardMap(tx, shardId, encodedTxn);
+}
 
-  for (const auto& x : m_txnShardMap) {
-    size += x.second.size();
+void Lookup::AddToTxnShardMap(const vector<pair<Transaction, uint32_t>>& txns,
+                              vector<bool>& added) {
+  if (!LOOKUP_NODE_MODE) {
+    LOG_GENERAL(WARNING,
+                "Lookup::AddToTxnShardMap not expected to be called from "
+                "other than the LookUp node.");
+    return;
   }
 
-  if (size >= TXN_STORAGE_LIMIT) {
-    LOG_GENERAL(INFO, "Number of txns exceeded limit");
-    return false;
-  }
+  added.assign(txns.size(), false);
 
-  // case where txn already exist
-  if (find_if(m_txnShardMap[shardId].begin(), m_txnShardMap[shardId].end(),
-              [tx](const Transaction& txn) {
-                return tx.GetTranID() == txn.GetTranID();
-              }) != m_txnShardMap[shardId].end()) {
-    LOG_GENERAL(WARNING, "Same hash present " << tx.GetTranID());
-    return false;
+  vector<bytes> encodedTxns(txns.size());
+  vector<bool> encoded(txns.size(), true);
+  if (!ARCHIVAL_LOOKUP) {
+    for (unsigned int i = 0; i < txns.size(); i++) {
+      if (!Messenger::SetTransaction(encodedTxns[i], 0, txns[i].first)) {
+        LOG_GENERAL(WARNING, "Messenger::SetTransaction failed");
+        encoded[i] = false;
+      }
+    }
   }
 
-  m_txnShardMap[shardId].push_back(tx);
+  lock_guard<mutex> g(m_txnShardMapMutex);
 
-  return true;
+  for (unsigned int i = 0; i < txns.size(); i++) {
+    if (encoded[i]) {
+      added[i] =
+          InsertIntoTxnShardMap(txns[i].first, txns[i].second, encodedTxns[i]);
+    }
+  }
 }
 
 bool Lookup::DeleteTxnShardMap(uint32_t shardId) {
@@ -3618,7 +4648,11 @@ bool Lookup::DeleteTxnShardMap(uint32_t shardId) {
 
   lock_guard<mutex> g(m_txnShardMapMutex);
 
+  for (const auto& tx : m_txnShardMap[shardId]) {
+    m_txnShardMapHashes.erase(tx.GetTranID());
+  }
   m_txnShardMap[shardId].clear();
+  m_txnPackets.erase(shardId);
 
   return true;
 }
@@ -3664,6 +4698,7 @@ void Lookup::RectifyTxnShardMap(const uint32_t oldNumShards,
   auto t_start = std::chrono::high_resolution_clock::now();
 
   map<uint, vector<Transaction>> tempTxnShardMap;
+  EncodedTxnPacketMap tempTxnPackets;
 
   lock_guard<mutex> g(m_txnShardMapMutex);
 
@@ -3675,28 +4710,62 @@ void Lookup::RectifyTxnShardMap(const uint32_t oldNumShards,
       // ds txns
       continue;
     }
+
+    // The encoded txns are moved along with the txns, in the same order
+    const auto& packets = m_txnPackets[shard.first];
+    auto packetIt = packets.begin();
+    unsigned int txnIndex = 0;
+    size_t txnOffset = 0;
+
     for (const auto& tx : shard.second) {
       unsigned int fromShard = tx.GetShardIndex(newNumShards);
+      bool toDS = false;
 
       if (Transaction::GetTransactionType(tx) == Transaction::CONTRACT_CALL) {
         // if shard do not match directly send to ds
         unsigned int toShard =
             Transaction::GetShardIndex(tx.GetToAddr(), newNumShards);
-        if (toShard != fromShard) {
-          // later would be placed in the new ds shard
-          m_txnShardMap[oldNumShards].emplace_back(move(tx));
-          continue;
-        }
+        // later would be placed in the new ds shard
+        toDS = toShard != fromShard;
       }
 
-      tempTxnShardMap[fromShard].emplace_back(move(tx));
+      if (toDS) {
+        m_txnShardMap[oldNumShards].emplace_back(tx);
+      } else {
+        tempTxnShardMap[fromShard].emplace_back(tx);
+      }
+
+      if (ARCHIVAL_LOOKUP) {
+        continue;
+      }
+
+      while (packetIt != packets.end() &&
+             txnIndex == packetIt->m_encodedTxnSizes.size()) {
+        packetIt++;
+        txnIndex = 0;
+        txnOffset = 0;
+      }
+      if (packetIt == packets.end()) {
+        LOG_GENERAL(WARNING, "Encoded txn missing for " << tx.GetTranID());
+        continue;
+      }
+
+      const auto txnBegin = packetIt->m_encodedTxns.begin() + txnOffset;
+      const uint32_t txnSize = packetIt->m_encodedTxnSizes[txnIndex];
+      AppendToTxnPackets(
+          toDS ? m_txnPackets[oldNumShards] : tempTxnPackets[fromShard],
+          m_nextTxnPacketId, txnBegin, txnBegin + txnSize);
+      txnOffset += txnSize;
+      txnIndex++;
     }
   }
   tempTxnShardMap[newNumShards] = move(m_txnShardMap[oldNumShards]);
+  tempTxnPackets[newNumShards] = move(m_txnPackets[oldNumShards]);
 
   m_txnShardMap.clear();
 
   m_txnShardMap = move(tempTxnShardMap);
+  m_txnPackets = move(tempTxnPackets);
 
   auto t_end = std::chrono::high_resolution_clock::now();
 
@@ -3736,104 +4805,169 @@ void Lookup::SendTxnPacketToNodes(const uint32_t oldNumShards,
   this_thread::sleep_for(
       chrono::milliseconds(LOOKUP_DELAY_SEND_TXNPACKET_IN_MS));
 
+  // Recipients of each shard, and of the DS committee at index numShards
+  vector<vector<Peer>> recipients(numShards + 1);
   for (unsigned int i = 0; i < numShards + 1; i++) {
-    bytes msg = {MessageType::NODE, NodeInstructionType::FORWARDTXNPACKET};
-    bool result = false;
-
-    {
-      lock_guard<mutex> g(m_txnShardMapMutex);
-      auto transactionNumber = mp[i].size();
+    recipients[i] = GetTxnPacketRecipients(i, numShards);
+  }
 
-      LOG_GENERAL(INFO, "Txn number generated: " << transactionNumber);
+  // Packets are streamed until the txn distribution window of the epoch is
+  // over, so that txns accepted in the meantime are delivered as well
+  const uint64_t epochNum = m_mediator.m_currentEpochNum;
+  const auto streamEnd = chrono::steady_clock::now() +
+                         chrono::milliseconds(TX_DISTRIBUTE_TIME_IN_MS);
 
-      if (GetTxnFromShardMap(i).empty() && mp[i].empty()) {
-        LOG_GENERAL(INFO, "No txns to send to shard " << i);
-        continue;
+  while (true) {
+    bool sentAny = false;
+    for (unsigned int i = 0; i < numShards + 1; i++) {
+      if (SendFirstTxnPacket(i, mp[i], recipients[i])) {
+        sentAny = true;
       }
+      // Generated txns only go in the first packet
+      mp[i].clear();
+    }
 
-      result = Messenger::SetNodeForwardTxnBlock(
-          msg, MessageOffset::BODY, m_mediator.m_currentEpochNum,
-          m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum(), i,
-          m_mediator.m_selfKey, GetTxnFromShardMap(i), mp[i]);
+    if (m_mediator.m_currentEpochNum != epochNum ||
+        m_mediator.GetIsVacuousEpoch() ||
+        chrono::steady_clock::now() >= streamEnd) {
+      break;
     }
 
-    if (!result) {
-      LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
-                "Messenger::SetNodeForwardTxnBlock failed.");
-      LOG_GENERAL(WARNING, "Cannot create packet for " << i << " shard");
-      continue;
+    if (!sentAny) {
+      this_thread::sleep_for(
+          chrono::milliseconds(LOOKUP_TXNPACKET_STREAM_INTERVAL_IN_MS));
     }
-    vector<Peer> toSend;
-    if (i < numShards) {
-      {
-        lock_guard<mutex> g(m_mediator.m_ds->m_mutexShards);
-        uint16_t lastBlockHash = DataConversion::charArrTo16Bits(
-            m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes());
-        uint32_t leader_id = m_mediator.m_node->CalculateShardLeaderFromShard(
-            lastBlockHash, m_mediator.m_ds->m_shards.at(i).size(),
-            m_mediator.m_ds->m_shards.at(i));
-        LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
-                  "Shard leader id " << leader_id);
-
-        auto it = m_mediator.m_ds->m_shards.at(i).begin();
-        // Lookup sends to NUM_NODES_TO_SEND_LOOKUP + Leader
-        unsigned int num_node_to_send = NUM_NODES_TO_SEND_LOOKUP;
-        for (unsigned int j = 0; j < num_node_to_send &&
-                                 it != m_mediator.m_ds->m_shards.at(i).end();
-             j++, it++) {
-          if (distance(m_mediator.m_ds->m_shards.at(i).begin(), it) ==
-              leader_id) {
-            num_node_to_send++;
-          } else {
-            toSend.push_back(std::get<SHARD_NODE_PEER>(*it));
-            LOG_GENERAL(INFO, "Sent to node " << get<SHARD_NODE_PEER>(*it));
-          }
-        }
-        if (m_mediator.m_ds->m_shards.at(i).empty()) {
-          continue;
-        }
-      }
+  }
+}
 
-      P2PComm::GetInstance().SendBroadcastMessage(toSend, msg);
+vector<Peer> Lookup::GetTxnPacketRecipients(const uint32_t shardId,
+                                            const uint32_t numShards) {
+  vector<Peer> toSend;
 
-      DeleteTxnShardMap(i);
-    } else if (i == numShards) {
-      // To send DS
-      {
-        lock_guard<mutex> g(m_mediator.m_mutexDSCommittee);
+  if (shardId < numShards) {
+    lock_guard<mutex> g(m_mediator.m_ds->m_mutexShards);
 
-        if (m_mediator.m_DSCommittee->empty()) {
-          continue;
-        }
+    const auto& shard = m_mediator.m_ds->m_shards.at(shardId);
+    if (shard.empty()) {
+      return toSend;
+    }
 
-        // Send to NUM_NODES_TO_SEND_LOOKUP which including DS leader
-        PairOfNode dsLeader;
-        if (Node::GetDSLeader(m_mediator.m_blocklinkchain.GetLatestBlockLink(),
-                              m_mediator.m_dsBlockChain.GetLastBlock(),
-                              *m_mediator.m_DSCommittee, dsLeader)) {
-          toSend.push_back(dsLeader.second);
-        }
+    uint16_t lastBlockHash = DataConversion::charArrTo16Bits(
+        m_mediator.m_txBlockChain.GetLastBlockPtr()->GetBlockHash().asBytes());
+    uint32_t leader_id = m_mediator.m_node->CalculateShardLeaderFromShard(
+        lastBlockHash, shard.size(), shard);
+    LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
+              "Shard leader id " << leader_id);
+
+    auto it = shard.begin();
+    // Lookup sends to NUM_NODES_TO_SEND_LOOKUP + Leader
+    unsigned int num_node_to_send = NUM_NODES_TO_SEND_LOOKUP;
+    for (unsigned int j = 0; j < num_node_to_send && it != shard.end();
+         j++, it++) {
+      if (distance(shard.begin(), it) == leader_id) {
+        num_node_to_send++;
+      } else {
+        toSend.push_back(std::get<SHARD_NODE_PEER>(*it));
+        LOG_GENERAL(INFO, "Sent to node " << get<SHARD_NODE_PEER>(*it));
+      }
+    }
+  } else if (shardId == numShards) {
+    // To send DS
+    lock_guard<mutex> g(m_mediator.m_mutexDSCommittee);
 
-        for (auto const& i : *m_mediator.m_DSCommittee) {
-          if (toSend.size() < NUM_NODES_TO_SEND_LOOKUP &&
-              i.second != dsLeader.second) {
-            toSend.push_back(i.second);
-          }
+    if (m_mediator.m_DSCommittee->empty()) {
+      return toSend;
+    }
 
-          if (toSend.size() >= NUM_NODES_TO_SEND_LOOKUP) {
-            break;
-          }
-        }
+    // Send to NUM_NODES_TO_SEND_LOOKUP which including DS leader
+    PairOfNode dsLeader;
+    if (Node::GetDSLeader(m_mediator.m_blocklinkchain.GetLatestBlockLink(),
+                          m_mediator.m_dsBlockChain.GetLastBlock(),
+                          *m_mediator.m_DSCommittee, dsLeader)) {
+      toSend.push_back(dsLeader.second);
+    }
+
+    for (auto const& i : *m_mediator.m_DSCommittee) {
+      if (toSend.size() < NUM_NODES_TO_SEND_LOOKUP &&
+          i.second != dsLeader.second) {
+        toSend.push_back(i.second);
+      }
+
+      if (toSend.size() >= NUM_NODES_TO_SEND_LOOKUP) {
+        break;
       }
+    }
+  }
+
+  return toSend;
+}
+
+bool Lookup::SendFirstTxnPacket(const uint32_t shardId,
+                                const vector<Transaction>& generatedTxns,
+                                const vector<Peer>& toSend) {
+  if (toSend.empty()) {
+    return false;
+  }
 
-      P2PComm::GetInstance().SendBroadcastMessage(toSend, msg);
+  // Txns were encoded when accepted, only copy the first packet here. If it
+  // is the last one, txns accepted from now on go to a new packet, so that
+  // the one being sent is deleted as is.
+  EncodedTxnPacket packet;
+  {
+    lock_guard<mutex> g(m_txnShardMapMutex);
+    auto it = m_txnPackets.find(shardId);
+    if (it != m_txnPackets.end() && !it->second.empty()) {
+      packet = it->second.front();
+      if (it->second.size() == 1 && !packet.m_encodedTxnSizes.empty()) {
+        AddTxnPacket(it->second, m_nextTxnPacketId);
+      }
+    }
+  }
 
-      LOG_GENERAL(INFO, "[DSMB]"
-                            << " Sent DS the txns");
+  const unsigned int numShardTxns = packet.m_encodedTxnSizes.size();
 
-      DeleteTxnShardMap(i);
+  for (const auto& tx : generatedTxns) {
+    bytes encodedTxn;
+    if (!Messenger::SetTransaction(encodedTxn, 0, tx)) {
+      LOG_GENERAL(WARNING, "Messenger::SetTransaction failed");
+      continue;
+    }
+    if (!FitsInTxnPacket(packet, encodedTxn.size())) {
+      break;
     }
+    packet.m_encodedTxns.insert(packet.m_encodedTxns.end(),
+                                encodedTxn.begin(), encodedTxn.end());
+    packet.m_encodedTxnSizes.emplace_back(encodedTxn.size());
+  }
+
+  if (packet.m_encodedTxnSizes.empty()) {
+    return false;
+  }
+
+  bytes msg = {MessageType::NODE, NodeInstructionType::FORWARDTXNPACKET};
+  if (!Messenger::SetNodeForwardTxnBlock(
+          msg, MessageOffset::BODY, m_mediator.m_currentEpochNum,
+          m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum(),
+          shardId, m_mediator.m_selfKey, packet.m_encodedTxns,
+          packet.m_encodedTxnSizes)) {
+    LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
+              "Messenger::SetNodeForwardTxnBlock failed.");
+    LOG_GENERAL(WARNING, "Cannot create packet for " << shardId << " shard");
+    return false;
   }
+
+  P2PComm::GetInstance().SendBroadcastMessage(toSend, msg);
+
+  LOG_GENERAL(INFO, "Sent " << packet.m_encodedTxnSizes.size()
+                            << " txns to shard " << shardId << " ("
+                            << msg.size() << " bytes)");
+
+  if (numShardTxns > 0) {
+    lock_guard<mutex> g(m_txnShardMapMutex);
+    DeleteFirstTxnPacket(shardId, packet.m_id);
+  }
+
+  return true;
 }
 
 void Lookup::SetServerTrue() {
@@ -3886,6 +5020,9 @@ bool Lookup::ProcessForwardTxn(const bytes& message, unsigned int offset,
 
   LOG_GENERAL(INFO, "Recvd from " << from);
 
+  vector<pair<Transaction, uint32_t>> txns;
+  txns.reserve(txnsShard.size() + txnsDS.size());
+
   if (!ARCHIVAL_LOOKUP) {
     uint32_t shard_size = m_mediator.m_ds->GetNumShards();
 
@@ -3894,22 +5031,25 @@ bool Lookup::ProcessForwardTxn(const bytes& message, unsigned int offset,
       return false;
     }
 
-    for (const auto& txn : txnsShard) {
+    for (auto& txn : txnsShard) {
       unsigned int shard = txn.GetShardIndex(shard_size);
-      AddToTxnShardMap(txn, shard);
+      txns.emplace_back(move(txn), shard);
     }
-    for (const auto& txn : txnsDS) {
-      AddToTxnShardMap(txn, shard_size);
+    for (auto& txn : txnsDS) {
+      txns.emplace_back(move(txn), shard_size);
     }
   } else {
-    for (const auto& txn : txnsShard) {
-      AddToTxnShardMap(txn, SEND_TYPE::ARCHIVAL_SEND_SHARD);
+    for (auto& txn : txnsShard) {
+      txns.emplace_back(move(txn), SEND_TYPE::ARCHIVAL_SEND_SHARD);
     }
-    for (const auto& txn : txnsDS) {
-      AddToTxnShardMap(txn, SEND_TYPE::ARCHIVAL_SEND_DS);
+    for (auto& txn : txnsDS) {
+      txns.emplace_back(move(txn), SEND_TYPE::ARCHIVAL_SEND_DS);
     }
   }
 
+  vector<bool> added;
+  AddToTxnShardMap(txns, added);
+
   return true;
 }
 
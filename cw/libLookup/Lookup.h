@@ -22,19 +22,23 @@
 #include <chrono>
 #include <condition_variable>
 #include <cstdlib>
+#include <deque>
 #include <map>
 #include <mutex>
 #include <unordered_set>
 #include <vector>
 
+#include "common/Constants.h"
 #include "common/Executable.h"
 #include "libCrypto/Schnorr.h"
 #include "libData/AccountData/Transaction.h"
 #include "libData/BlockData/Block/DSBlock.h"
 #include "libData/BlockData/Block/MicroBlock.h"
 #include "libData/BlockData/Block/TxBlock.h"
+#include "libData/DataStructures/BytesCache.h"
 #include "libNetwork/Peer.h"
 #include "libNetwork/ShardStruct.h"
+#include "libPersistence/StateSnapshot.h"
 #include "libUtils/IPConverter.h"
 #include "libUtils/Logger.h"
 
@@ -51,6 +55,20 @@ class Synchronizer;
 // the whole map
 using TxnShardMap = std::map<uint32_t, std::vector<Transaction>>;
 
+/// Consecutive txns of a shard in m_txnShardMap, already encoded as
+/// ProtoTransaction and ready to be sent in a single FORWARDTXNPACKET
+struct EncodedTxnPacket {
+  /// Unique among the packets of a lookup, so that a packet is only deleted
+  /// after sending if it was not rebuilt meanwhile
+  uint64_t m_id = 0;
+  bytes m_encodedTxns;
+  std::vector<uint32_t> m_encodedTxnSizes;
+};
+
+// Per shard, the txns of m_txnShardMap split into packets of at most
+// PACKET_BYTESIZE_LIMIT bytes, in the same order
+using EncodedTxnPacketMap = std::map<uint32_t, std::deque<EncodedTxnPacket>>;
+
 // Enum used to tell send type to seed node
 enum SEND_TYPE { ARCHIVAL_SEND_SHARD = 0, ARCHIVAL_SEND_DS };
 
@@ -120,10 +138,41 @@ class Lookup : public Executable {
   std::mutex m_mutexCheckDirBlocks;
   std::mutex m_mutexMicroBlocksBuffer;
 
+  /// Reply slot of the outstanding sharding structure request. A reply is
+  /// only taken if it answers m_shardStructRequestId and the slot is empty.
   std::mutex m_mutexShardStruct;
   std::condition_variable cv_shardStruct;
+  uint64_t m_shardStructRequestId = 0;
+  bool m_shardStructReady = false;
+  DequeOfShard m_shardStructReply;
 
   TxnShardMap m_txnShardMap;
+  /// Hashes of all txns in m_txnShardMap, for constant time duplicate checks
+  std::unordered_set<TxnHash> m_txnShardMapHashes;
+
+  /// Packets of m_txnShardMap, filled as txns are accepted so that sending
+  /// only needs to sign them. Not used by archival lookups.
+  EncodedTxnPacketMap m_txnPackets;
+  uint64_t m_nextTxnPacketId = 0;
+
+  /// Use m_txnShardMapMutex with this function
+  bool InsertIntoTxnShardMap(const Transaction& tx, uint32_t shardId,
+                             const bytes& encodedTxn);
+
+  /// Removes the first packet of the shard and its txns from m_txnShardMap,
+  /// if it is still packetId. Use m_txnShardMapMutex with this function
+  void DeleteFirstTxnPacket(uint32_t shardId, uint64_t packetId);
+
+  /// Returns the nodes a lookup sends the txn packets of a shard to, or of
+  /// the DS committee if shardId is numShards
+  std::vector<Peer> GetTxnPacketRecipients(const uint32_t shardId,
+                                           const uint32_t numShards);
+
+  /// Sends the first packet of the shard, together with generatedTxns.
+  /// Returns false if there was nothing to send.
+  bool SendFirstTxnPacket(const uint32_t shardId,
+                          const std::vector<Transaction>& generatedTxns,
+                          const std::vector<Peer>& toSend);
 
   // Get StateDeltas from seed
   std::mutex m_mutexSetStateDeltasFromSeed;
@@ -132,8 +181,62 @@ class Lookup : public Executable {
   // TxBlockBuffer
   std::vector<TxBlock> m_txBlockBuffer;
 
+  /// Tx block range requested from one seed during parallel synchronization
+  struct TxBlockSyncChunk {
+    uint64_t m_highBlockNum;
+    unsigned int m_seedIndex;
+    unsigned int m_attempts;
+    std::chrono::steady_clock::time_point m_requestedAt;
+    bool m_received;
+    std::vector<TxBlock> m_txBlocks;
+  };
+
+  // Outstanding chunks of the current sync round, keyed by lowBlockNum
+  std::mutex m_mutexTxBlockSync;
+  std::condition_variable cv_txBlockSync;
+  std::map<uint64_t, TxBlockSyncChunk> m_txBlockSyncChunks;
+  bool m_txBlockSyncStale = false;
+
+  // Encoded blocks and signed block range responses served to syncing nodes
+  BytesCache<uint64_t> m_serializedDSBlockCache{SEED_BLOCK_CACHE_SIZE_IN_BYTES};
+  BytesCache<uint64_t> m_serializedTxBlockCache{SEED_BLOCK_CACHE_SIZE_IN_BYTES};
+  BytesCache<std::pair<uint64_t, uint64_t>> m_dsBlockRangeMsgCache{
+      SEED_BLOCK_RANGE_CACHE_SIZE_IN_BYTES};
+  BytesCache<std::pair<uint64_t, uint64_t>> m_txBlockRangeMsgCache{
+      SEED_BLOCK_RANGE_CACHE_SIZE_IN_BYTES};
+
+  // State snapshot served to bootstrapping nodes, exported once per TxBlock.
+  // The previous one is kept for nodes still fetching its chunks.
+  std::mutex m_mutexStateSnapshot;
+  std::shared_ptr<StateSnapshot> m_stateSnapshot;
+  std::shared_ptr<StateSnapshot> m_prevStateSnapshot;
+
+  // State snapshot being imported while bootstrapping
+  std::mutex m_mutexStateSnapshotImport;
+  std::condition_variable cv_stateSnapshotImport;
+  std::shared_ptr<StateSnapshot> m_stateSnapshotImport;
+  bool m_stateSnapshotImportRunning = false;
+  bool m_stateSnapshotManifestPending = false;
+
   bytes ComposeGetDSInfoMessage(bool initialDS = false);
   bytes ComposeGetStateMessage();
+  bytes ComposeGetStateSnapshotManifestMessage();
+
+  /// Returns the snapshot of the state committed by TxBlock txBlockNum,
+  /// exporting it if txBlockNum is the latest TxBlock. Only the latest and
+  /// the previous snapshots are available.
+  std::shared_ptr<StateSnapshot> GetStateSnapshot(const uint64_t& txBlockNum);
+
+  /// Fetches the missing chunks of the snapshot being imported from the seed
+  /// nodes, falling back to the full state if it cannot be completed
+  void DownloadStateSnapshot();
+
+  /// Gives up on the pending state snapshot manifest request and requests
+  /// the full state instead. Does nothing if no manifest is pending.
+  void FallBackToFullState();
+
+  /// Post processing after the account states have been received
+  bool FinishStateSync();
 
   bytes ComposeGetDSBlockMessage(uint64_t lowBlockNum, uint64_t highBlockNum);
   bytes ComposeGetTxBlockMessage(uint64_t lowBlockNum, uint64_t highBlockNum);
@@ -146,13 +249,35 @@ class Lookup : public Executable {
 
   bytes ComposeGetOfflineLookupNodes();
 
-  void ComposeAndSendGetShardingStructureFromSeed();
+  bool ComposeAndSendGetShardingStructureFromSeed(const uint64_t& requestId);
+
+  /// Requests the current sharding structure from a random seed node or
+  /// lookup and waits for the reply to that request
+  bool RequestShardingStructure(const bool fromSeedNode,
+                                const std::chrono::milliseconds& timeout,
+                                DequeOfShard& shards);
+
+  bool GetDSBlockRange(uint64_t& lowBlockNum, uint64_t& highBlockNum,
+                       bool partialRetrieve);
+  bool GetTxBlockRange(uint64_t& lowBlockNum, uint64_t& highBlockNum);
+
+  /// Retrieve a block from the chain, or return false if it is absent
+  bool GetDSBlockFromChain(const uint64_t& blockNum, DSBlock& dsBlock);
+  bool GetTxBlockFromChain(const uint64_t& blockNum, TxBlock& txBlock);
 
   void RetrieveDSBlocks(std::vector<DSBlock>& dsBlocks, uint64_t& lowBlockNum,
                         uint64_t& highBlockNum, bool partialRetrieve = false);
   void RetrieveTxBlocks(std::vector<TxBlock>& txBlocks, uint64_t& lowBlockNum,
                         uint64_t& highBlockNum);
 
+  void RetrieveSerializedDSBlocks(
+      std::vector<std::shared_ptr<const bytes>>& dsBlocks,
+      uint64_t& lowBlockNum, uint64_t& highBlockNum);
+  void RetrieveSerializedTxBlocks(
+      std::vector<std::shared_ptr<const bytes>>& txBlocks,
+      uint64_t& lowBlockNum, uint64_t& highBlockNum);
+  void ClearBlockCaches();
+
  public:
   /// Constructor.
   Lookup(Mediator& mediator, SyncType syncType);
@@ -212,6 +337,9 @@ class Lookup : public Executable {
 
   void SendMessageToRandomSeedNode(const bytes& message) const;
 
+  // Calls P2PComm::SendMessage to the Seed peer at index
+  void SendMessageToSeedNode(unsigned int index, const bytes& message) const;
+
   void RectifyTxnShardMap(const uint32_t, const uint32_t);
 
   // TODO: move the Get and ProcessSet functions to Synchronizer
@@ -221,21 +349,25 @@ class Lookup : public Executable {
   bool GetDSBlockFromLookupNodes(uint64_t lowBlockNum, uint64_t highBlockNum);
   bool GetTxBlockFromLookupNodes(uint64_t lowBlockNum, uint64_t highBlockNum);
   bool GetTxBlockFromSeedNodes(uint64_t lowBlockNum, uint64_t highBlockNum);
+  /// Fetches the tx blocks of the current DS epoch from lowBlockNum onwards
+  /// in chunks spread across the seed nodes, and commits them in order
+  bool SyncTxBlocksFromSeedNodes(uint64_t lowBlockNum);
   bool GetStateDeltaFromSeedNodes(const uint64_t& blockNum);
   bool GetStateDeltasFromSeedNodes(uint64_t lowBlockNum, uint64_t highBlockNum);
 
   bool GetStateFromSeedNodes();
-  // UNUSED
   bool ProcessGetShardFromSeed([[gnu::unused]] const bytes& message,
                                [[gnu::unused]] unsigned int offset,
                                [[gnu::unused]] const Peer& from);
-  // UNUSED
   bool ProcessSetShardFromSeed([[gnu::unused]] const bytes& message,
                                [[gnu::unused]] unsigned int offset,
                                [[gnu::unused]] const Peer& from);
   bool GetDSBlockFromSeedNodes(uint64_t lowBlockNum, uint64_t highblocknum);
-  // UNUSED
-  bool GetShardFromLookup();
+  bool GetShardFromLookup(const uint64_t& requestId);
+
+  /// Requests the current sharding structure from a random lookup and waits
+  /// for it
+  bool FetchShardingStructure(DequeOfShard& shards);
   // Get the offline lookup nodes from lookup nodes
   bool GetOfflineLookupNodes();
 
@@ -262,6 +394,12 @@ class Lookup : public Executable {
 
   bool AddToTxnShardMap(const Transaction& tx, uint32_t shardId);
 
+  /// Adds (txn, shardId) pairs under a single lock of m_txnShardMapMutex.
+  /// added[i] tells whether txns[i] was accepted.
+  void AddToTxnShardMap(
+      const std::vector<std::pair<Transaction, uint32_t>>& txns,
+      std::vector<bool>& added);
+
   void CheckBufferTxBlocks();
 
   bool DeleteTxnShardMap(uint32_t shardId);
@@ -286,6 +424,12 @@ class Lookup : public Executable {
                                      const Peer& from);
   bool ProcessGetStateFromSeed(const bytes& message, unsigned int offset,
                                const Peer& from);
+  bool ProcessGetStateSnapshotManifestFromSeed(const bytes& message,
+                                               unsigned int offset,
+                                               const Peer& from);
+  bool ProcessGetStateSnapshotChunkFromSeed(const bytes& message,
+                                            unsigned int offset,
+                                            const Peer& from);
   // UNUSED
   bool ProcessGetTxnsFromLookup([[gnu::unused]] const bytes& message,
                                 [[gnu::unused]] unsigned int offset,
@@ -319,6 +463,10 @@ class Lookup : public Executable {
   bool ProcessSetTxBlockFromSeed(const bytes& message, unsigned int offset,
                                  const Peer& from);
   void CommitTxBlocks(const std::vector<TxBlock>& txBlocks);
+  /// Returns false if the range is not part of an ongoing parallel sync
+  bool ProcessTxBlockSyncChunk(const uint64_t& lowBlockNum,
+                               const uint64_t& highBlockNum,
+                               std::vector<TxBlock>& txBlocks);
   void PrepareForStartPow();
   bool GetDSInfo();
   bool ProcessSetStateDeltaFromSeed(const bytes& message, unsigned int offset,
@@ -327,6 +475,12 @@ class Lookup : public Executable {
                                      const Peer& from);
   bool ProcessSetStateFromSeed(const bytes& message, unsigned int offset,
                                const Peer& from);
+  bool ProcessSetStateSnapshotManifestFromSeed(const bytes& message,
+                                               unsigned int offset,
+                                               const Peer& from);
+  bool ProcessSetStateSnapshotChunkFromSeed(const bytes& message,
+                                            unsigned int offset,
+                                            const Peer& from);
 
   bool ProcessSetLookupOffline(const bytes& message, unsigned int offset,
                                const Peer& from);
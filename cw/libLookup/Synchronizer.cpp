@@ -168,7 +168,7 @@ bool Synchronizer::FetchLatestTxBlockSeed(Lookup* lookup,
     return true;
   }
 
-  return lookup->GetTxBlockFromSeedNodes(currentBlockChainSize, 0);
+  return lookup->SyncTxBlocksFromSeedNodes(currentBlockChainSize);
 }
 
 bool Synchronizer::AttemptPoW(Lookup* lookup) {
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CHAINTIP_H__
+#define __CHAINTIP_H__
+
+#include <array>
+#include <memory>
+
+#include "CommitteeView.h"
+#include "common/Constants.h"
+#include "libData/BlockData/Block/DSBlock.h"
+#include "libData/BlockData/Block/TxBlock.h"
+
+/// Immutable snapshot of the latest DS and Tx blocks, epoch, committee and
+/// randomness, rebuilt by the Mediator whenever any of them changes. Readers
+/// need no blockchain or committee mutex. The values are updated one at a
+/// time, so a snapshot can pair a new block with the epoch or randomness
+/// from before it, until those are updated as well.
+class ChainTip {
+  std::shared_ptr<const DSBlock> m_dsBlock;
+  std::shared_ptr<const TxBlock> m_txBlock;
+  uint64_t m_epochNum;
+  std::shared_ptr<const CommitteeView> m_committeeView;
+  std::array<unsigned char, POW_SIZE> m_dsBlockRand;
+  std::array<unsigned char, POW_SIZE> m_txBlockRand;
+
+ public:
+  /// Constructor.
+  ChainTip(const std::shared_ptr<const DSBlock>& dsBlock,
+           const std::shared_ptr<const TxBlock>& txBlock,
+           const uint64_t& epochNum,
+           const std::shared_ptr<const CommitteeView>& committeeView,
+           const std::array<unsigned char, POW_SIZE>& dsBlockRand,
+           const std::array<unsigned char, POW_SIZE>& txBlockRand)
+      : m_dsBlock(dsBlock),
+        m_txBlock(txBlock),
+        m_epochNum(epochNum),
+        m_committeeView(committeeView),
+        m_dsBlockRand(dsBlockRand),
+        m_txBlockRand(txBlockRand) {}
+
+  ChainTip(const ChainTip&) = delete;
+
+  ChainTip& operator=(const ChainTip&) = delete;
+
+  /// Returns the latest DS block, a dummy one before the first is stored
+  const DSBlock& GetDSBlock() const { return *m_dsBlock; }
+
+  /// Returns the latest Tx block, a dummy one before the first is stored
+  const TxBlock& GetTxBlock() const { return *m_txBlock; }
+
+  const DSBlockHeader& GetDSBlockHeader() const {
+    return m_dsBlock->GetHeader();
+  }
+
+  const TxBlockHeader& GetTxBlockHeader() const {
+    return m_txBlock->GetHeader();
+  }
+
+  uint64_t GetDSBlockNum() const { return GetDSBlockHeader().GetBlockNum(); }
+
+  uint64_t GetTxBlockNum() const { return GetTxBlockHeader().GetBlockNum(); }
+
+  const BlockHash& GetDSBlockHash() const { return m_dsBlock->GetBlockHash(); }
+
+  const BlockHash& GetTxBlockHash() const { return m_txBlock->GetBlockHash(); }
+
+  uint64_t GetEpochNum() const { return m_epochNum; }
+
+  /// Returns the committee view current at the tip, never nullptr
+  const std::shared_ptr<const CommitteeView>& GetCommitteeView() const {
+    return m_committeeView;
+  }
+
+  const std::array<unsigned char, POW_SIZE>& GetDSBlockRand() const {
+    return m_dsBlockRand;
+  }
+
+  const std::array<unsigned char, POW_SIZE>& GetTxBlockRand() const {
+    return m_txBlockRand;
+  }
+};
+
+#endif  // __CHAINTIP_H__
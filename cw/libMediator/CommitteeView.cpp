@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "CommitteeView.h"
+#include "common/Constants.h"
+#include "libNetwork/Guard.h"
+
+using namespace std;
+
+CommitteeView::CommitteeView(const DequeOfNode& dsCommittee,
+                             const DequeOfShard& shards)
+    : m_dsCommittee(dsCommittee) {
+  m_dsGuards.reserve(m_dsCommittee.size());
+  m_dsIndexes.reserve(m_dsCommittee.size());
+
+  uint32_t index = 0;
+  for (const auto& dsMember : m_dsCommittee) {
+    m_dsGuards.emplace_back(
+        GUARD_MODE && Guard::GetInstance().IsNodeInDSGuardList(dsMember.first));
+    m_dsIndexes.emplace(dsMember.first, index++);
+    m_peerPubKeys.emplace(dsMember.second, dsMember.first);
+  }
+
+  m_shardMembers.reserve(shards.size());
+
+  uint32_t shardId = 0;
+  for (const auto& shard : shards) {
+    m_shardMembers.emplace_back();
+    m_shardMembers.back().reserve(shard.size());
+    for (const auto& shardNode : shard) {
+      const PubKey& pubKey = get<SHARD_NODE_PUBKEY>(shardNode);
+      m_shardMembers.back().emplace_back(pubKey);
+      m_shardIds.emplace(pubKey, shardId);
+      m_peerPubKeys.emplace(get<SHARD_NODE_PEER>(shardNode), pubKey);
+    }
+    shardId++;
+  }
+}
+
+bool CommitteeView::IsDSNode(const PubKey& pubKey) const {
+  return m_dsIndexes.find(pubKey) != m_dsIndexes.end();
+}
+
+bool CommitteeView::GetDSIndex(const PubKey& pubKey, uint32_t& index) const {
+  auto it = m_dsIndexes.find(pubKey);
+  if (it == m_dsIndexes.end()) {
+    return false;
+  }
+
+  index = it->second;
+  return true;
+}
+
+bool CommitteeView::IsDSGuard(uint32_t index) const {
+  return index < m_dsGuards.size() && m_dsGuards.at(index);
+}
+
+bool CommitteeView::IsShardNode(const PubKey& pubKey) const {
+  return m_shardIds.find(pubKey) != m_shardIds.end();
+}
+
+bool CommitteeView::GetShardId(const PubKey& pubKey, uint32_t& shardId) const {
+  auto it = m_shardIds.find(pubKey);
+  if (it == m_shardIds.end()) {
+    return false;
+  }
+
+  shardId = it->second;
+  return true;
+}
+
+const vector<PubKey>& CommitteeView::GetShardMembers(uint32_t shardId) const {
+  static const vector<PubKey> noMembers;
+
+  if (shardId >= m_shardMembers.size()) {
+    return noMembers;
+  }
+
+  return m_shardMembers.at(shardId);
+}
+
+bool CommitteeView::GetPubKey(const Peer& peer, PubKey& pubKey) const {
+  auto it = m_peerPubKeys.find(peer);
+  if (it == m_peerPubKeys.end()) {
+    return false;
+  }
+
+  pubKey = it->second;
+  return true;
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __COMMITTEEVIEW_H__
+#define __COMMITTEEVIEW_H__
+
+#include <unordered_map>
+#include <vector>
+
+#include "libCrypto/Schnorr.h"
+#include "libNetwork/Peer.h"
+#include "libNetwork/ShardStruct.h"
+
+/// Immutable snapshot of the DS committee and sharding structure, built
+/// once whenever either is committed and shared by all readers, so that
+/// membership checks need neither a scan nor the committee mutexes.
+class CommitteeView {
+  DequeOfNode m_dsCommittee;
+  std::vector<bool> m_dsGuards;
+  std::unordered_map<PubKey, uint32_t> m_dsIndexes;
+  std::vector<std::vector<PubKey>> m_shardMembers;
+  std::unordered_map<PubKey, uint32_t> m_shardIds;
+  std::unordered_map<Peer, PubKey> m_peerPubKeys;
+
+ public:
+  /// Constructor.
+  CommitteeView(const DequeOfNode& dsCommittee, const DequeOfShard& shards);
+
+  CommitteeView(const CommitteeView&) = delete;
+
+  CommitteeView& operator=(const CommitteeView&) = delete;
+
+  /// Returns the DS committee in consensus order
+  const DequeOfNode& GetDSCommittee() const { return m_dsCommittee; }
+
+  bool IsDSNode(const PubKey& pubKey) const;
+
+  /// Returns the position of the node in the DS committee
+  bool GetDSIndex(const PubKey& pubKey, uint32_t& index) const;
+
+  /// Returns whether the DS committee member at index is a DS guard
+  bool IsDSGuard(uint32_t index) const;
+
+  bool IsShardNode(const PubKey& pubKey) const;
+
+  /// Returns the ID of the shard the node belongs to
+  bool GetShardId(const PubKey& pubKey, uint32_t& shardId) const;
+
+  uint32_t GetNumShards() const { return m_shardMembers.size(); }
+
+  /// Returns the public keys of the members of a shard in consensus order
+  const std::vector<PubKey>& GetShardMembers(uint32_t shardId) const;
+
+  /// Returns the public key of the DS committee or shard member at peer
+  bool GetPubKey(const Peer& peer, PubKey& pubKey) const;
+};
+
+#endif  // __COMMITTEEVIEW_H__
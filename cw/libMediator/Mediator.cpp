@@ -41,8 +41,13 @@ Mediator::Mediator(const PairOfKey& key, const Peer& peer)
       m_consensusID(0),
       m_DSCommittee(make_shared<DequeOfNode>()),
       m_initialDSCommittee(make_shared<vector<PubKey>>()),
+      m_committeeView(
+          make_shared<const CommitteeView>(DequeOfNode(), DequeOfShard())),
       m_dsBlockRand({{0}}),
       m_txBlockRand({{0}}),
+      m_chainTip(make_shared<const ChainTip>(
+          m_dsBlockChain.GetLastBlockPtr(), m_txBlockChain.GetLastBlockPtr(),
+          m_currentEpochNum, m_committeeView, m_dsBlockRand, m_txBlockRand)),
       m_isRetrievedHistory(false),
       m_isVacuousEpoch(false),
       m_curSWInfo() {
@@ -62,57 +67,62 @@ void Mediator::RegisterColleagues(DirectoryService* ds, Node* node,
 void Mediator::UpdateDSBlockRand(bool isGenesis) {
   LOG_MARKER();
 
+  array<unsigned char, POW_SIZE> dsBlockRand{};
   if (isGenesis) {
     // genesis block
     LOG_GENERAL(INFO, "Genesis DSBlockchain")
     array<unsigned char, UINT256_SIZE> rand1;
     DataConversion::HexStrToStdArray(RAND1_GENESIS, rand1);
-    copy(rand1.begin(), rand1.end(), m_dsBlockRand.begin());
+    copy(rand1.begin(), rand1.end(), dsBlockRand.begin());
   } else {
-    DSBlock lastBlock = m_dsBlockChain.GetLastBlock();
+    const auto lastBlock = m_dsBlockChain.GetLastBlockPtr();
     SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
     bytes vec;
-    lastBlock.GetHeader().Serialize(vec, 0);
+    lastBlock->GetHeader().Serialize(vec, 0);
     sha2.Update(vec);
     bytes randVec;
     randVec = sha2.Finalize();
-    copy(randVec.begin(), randVec.end(), m_dsBlockRand.begin());
+    copy(randVec.begin(), randVec.end(), dsBlockRand.begin());
   }
+
+  lock_guard<mutex> g(m_mutexChainTip);
+  m_dsBlockRand = dsBlockRand;
+  PublishChainTip();
 }
 
 void Mediator::UpdateTxBlockRand(bool isGenesis) {
   LOG_MARKER();
 
+  array<unsigned char, POW_SIZE> txBlockRand{};
   if (isGenesis) {
     LOG_GENERAL(INFO, "Genesis txBlockchain")
     array<unsigned char, UINT256_SIZE> rand2;
     DataConversion::HexStrToStdArray(RAND2_GENESIS, rand2);
-    copy(rand2.begin(), rand2.end(), m_txBlockRand.begin());
+    copy(rand2.begin(), rand2.end(), txBlockRand.begin());
   } else {
-    TxBlock lastBlock = m_txBlockChain.GetLastBlock();
+    const auto lastBlock = m_txBlockChain.GetLastBlockPtr();
     SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
     bytes vec;
-    lastBlock.GetHeader().Serialize(vec, 0);
+    lastBlock->GetHeader().Serialize(vec, 0);
     sha2.Update(vec);
     bytes randVec;
     randVec = sha2.Finalize();
-    copy(randVec.begin(), randVec.end(), m_txBlockRand.begin());
+    copy(randVec.begin(), randVec.end(), txBlockRand.begin());
   }
+
+  lock_guard<mutex> g(m_mutexChainTip);
+  m_txBlockRand = txBlockRand;
+  PublishChainTip();
 }
 
 std::string Mediator::GetNodeMode(const Peer& peer) {
-  std::lock_guard<mutex> lock(m_mutexDSCommittee);
-  bool bFound = false;
-
-  for (auto const& i : *m_DSCommittee) {
-    if (i.second == peer) {
-      bFound = true;
-      break;
-    }
-  }
+  const auto committeeView = GetChainTip()->GetCommitteeView();
+  PubKey pubKey;
+  uint32_t dsIndex = 0;
 
-  if (bFound) {
-    if (peer == (*m_DSCommittee)[0].second) {
+  if (committeeView->GetPubKey(peer, pubKey) &&
+      committeeView->GetDSIndex(pubKey, dsIndex)) {
+    if (dsIndex == 0) {
       return "DSLD";
     } else {
       return "DSBU";
@@ -124,7 +134,11 @@ std::string Mediator::GetNodeMode(const Peer& peer) {
 
 void Mediator::IncreaseEpochNum() {
   std::lock_guard<mutex> lock(m_mutexVacuousEpoch);
-  m_currentEpochNum++;
+  {
+    lock_guard<mutex> g(m_mutexChainTip);
+    m_currentEpochNum++;
+    PublishChainTip();
+  }
   if ((m_currentEpochNum + NUM_VACUOUS_EPOCHS) % NUM_FINAL_BLOCK_PER_POW == 0) {
     m_isVacuousEpoch = true;
   } else {
@@ -175,12 +189,59 @@ uint32_t Mediator::GetShardSize(const bool& useShardStructure) const {
   return ShardSizeCalculator::CalculateShardSize(shardNodeNum);
 }
 
+void Mediator::UpdateCommitteeView() {
+  DequeOfNode dsCommittee;
+  {
+    lock_guard<mutex> g(m_mutexDSCommittee);
+    dsCommittee = *m_DSCommittee;
+  }
+
+  DequeOfShard shards;
+  {
+    lock_guard<mutex> g(m_ds->m_mutexShards);
+    shards = m_ds->m_shards;
+  }
+
+  shared_ptr<const CommitteeView> committeeView =
+      make_shared<CommitteeView>(dsCommittee, shards);
+  atomic_store(&m_committeeView, committeeView);
+
+  UpdateChainTip();
+}
+
+shared_ptr<const CommitteeView> Mediator::GetCommitteeView() const {
+  return atomic_load(&m_committeeView);
+}
+
+void Mediator::UpdateChainTip() {
+  // Serialized so that the last snapshot published is also the latest built
+  lock_guard<mutex> g(m_mutexChainTip);
+  PublishChainTip();
+}
+
+void Mediator::PublishChainTip() {
+  shared_ptr<const ChainTip> chainTip = make_shared<ChainTip>(
+      m_dsBlockChain.GetLastBlockPtr(), m_txBlockChain.GetLastBlockPtr(),
+      m_currentEpochNum, GetCommitteeView(), m_dsBlockRand, m_txBlockRand);
+  atomic_store(&m_chainTip, chainTip);
+}
+
+void Mediator::SetEpochNum(const uint64_t& epochNum) {
+  lock_guard<mutex> g(m_mutexChainTip);
+  m_currentEpochNum = epochNum;
+  PublishChainTip();
+}
+
+shared_ptr<const ChainTip> Mediator::GetChainTip() const {
+  return atomic_load(&m_chainTip);
+}
+
 bool Mediator::CheckWhetherBlockIsLatest(const uint64_t& dsblockNum,
                                          const uint64_t& epochNum) {
   LOG_MARKER();
 
   uint64_t latestDSBlockNumInBlockchain =
-      m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
 
   if (dsblockNum < (latestDSBlockNumInBlockchain + 1)) {
     LOG_EPOCH(WARNING, m_currentEpochNum,
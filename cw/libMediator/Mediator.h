@@ -20,6 +20,8 @@
 
 #include <deque>
 
+#include "ChainTip.h"
+#include "CommitteeView.h"
 #include "libCrypto/Schnorr.h"
 #include "libData/BlockChainData/BlockChain.h"
 #include "libData/BlockChainData/BlockLinkChain.h"
@@ -77,12 +79,21 @@ class Mediator {
   std::shared_ptr<std::vector<PubKey>> m_initialDSCommittee;
   std::mutex m_mutexInitialDSCommittee;
 
+  /// Snapshot of m_DSCommittee and the sharding structure, swapped atomically
+  /// by UpdateCommitteeView. Use GetCommitteeView to read it.
+  std::shared_ptr<const CommitteeView> m_committeeView;
+
   /// The current epoch randomness from the DS blockchain.
   std::array<unsigned char, POW_SIZE> m_dsBlockRand;
 
   /// The current epoch randomness from the Tx blockchain.
   std::array<unsigned char, POW_SIZE> m_txBlockRand;
 
+  /// Snapshot of the latest blocks, epoch, committee and randomness, swapped
+  /// atomically by UpdateChainTip. Use GetChainTip to read it.
+  std::shared_ptr<const ChainTip> m_chainTip;
+  std::mutex m_mutexChainTip;
+
   /// To determine if the node successfully recovered from persistence
   bool m_isRetrievedHistory;
 
@@ -119,6 +130,26 @@ class Mediator {
 
   uint32_t GetShardSize(const bool& useShardStructure) const;
 
+  /// Rebuilds and publishes the committee view from the current DS committee
+  /// and sharding structure. Call after committing changes to either.
+  void UpdateCommitteeView();
+
+  /// Returns the latest committee view, never nullptr
+  std::shared_ptr<const CommitteeView> GetCommitteeView() const;
+
+  /// Rebuilds and publishes the chain tip. Called by the updaters of the
+  /// epoch, randomness and committee view, i.e. once per committed block.
+  void UpdateChainTip();
+
+  /// Use m_mutexChainTip with this function
+  void PublishChainTip();
+
+  /// Sets the current epoch and publishes it in the chain tip
+  void SetEpochNum(const uint64_t& epochNum);
+
+  /// Returns the latest chain tip, never nullptr
+  std::shared_ptr<const ChainTip> GetChainTip() const;
+
   bool CheckWhetherBlockIsLatest(const uint64_t& dsblockNum,
                                  const uint64_t& epochNum);
 
@@ -22,6 +22,7 @@
 #include "libDirectoryService/DirectoryService.h"
 #include "libMessage/ZilliqaMessage.pb.h"
 #include "libUtils/Logger.h"
+#include "libUtils/Uint128.h"
 
 #include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/io/zero_copy_stream_impl_lite.h>
@@ -82,6 +83,26 @@ void ProtobufByteArrayToNumber(const ByteArray& byteArray, T& number) {
   number = Serializable::GetNumber<T>(tmp, 0, S);
 }
 
+// Balances, amounts and gas prices are converted natively
+template <>
+void NumberToProtobufByteArray<uint128_t, UINT128_SIZE>(
+    const uint128_t& number, ByteArray& byteArray) {
+  uint8_t tmp[UINT128_SIZE];
+  Uint128ToBigEndian(number, tmp);
+  byteArray.set_data(tmp, UINT128_SIZE);
+}
+
+template <>
+void ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(
+    const ByteArray& byteArray, uint128_t& number) {
+  if (byteArray.data().size() < UINT128_SIZE) {
+    number = 0;
+    return;
+  }
+  number = Uint128FromBigEndian(
+      reinterpret_cast<const uint8_t*>(byteArray.data().data()));
+}
+
 template <class T>
 bool SerializeToArray(const T& protoMessage, bytes& dst,
                       const unsigned int offset) {
@@ -116,6 +137,56 @@ void NumberToArray(const T& number, bytes& dst, const unsigned int offset) {
   Serializable::SetNumber<T>(dst, offset, number, S);
 }
 
+// Builds a LookupSetDSBlockFromSeed / LookupSetTxBlockFromSeed message from
+// already encoded ProtoDSBlock / ProtoTxBlock bytes. These are the canonical
+// serialization, so the receiver's re-serialization of the parsed Data
+// matches the signed bytes.
+bool EncodedBlocksToLookupSetBlockFromSeed(
+    bytes& dst, const unsigned int offset, const uint64_t lowBlockNum,
+    const uint64_t highBlockNum, const PairOfKey& lookupKey,
+    const vector<shared_ptr<const bytes>>& encodedBlocks) {
+  LookupSetEncodedBlocksFromSeed result;
+
+  result.mutable_data()->set_lowblocknum(lowBlockNum);
+  result.mutable_data()->set_highblocknum(highBlockNum);
+
+  for (const auto& encodedBlock : encodedBlocks) {
+    if (encodedBlock == nullptr) {
+      LOG_GENERAL(WARNING, "Encoded block missing");
+      return false;
+    }
+    result.mutable_data()->add_blocks(encodedBlock->data(),
+                                      encodedBlock->size());
+  }
+
+  SerializableToProtobufByteArray(lookupKey.second, *result.mutable_pubkey());
+
+  if (!result.data().IsInitialized()) {
+    LOG_GENERAL(WARNING,
+                "LookupSetEncodedBlocksFromSeed.Data initialization failed");
+    return false;
+  }
+  bytes tmp(result.data().ByteSize());
+  result.data().SerializeToArray(tmp.data(), tmp.size());
+
+  Signature signature;
+  if (!Schnorr::GetInstance().Sign(tmp, lookupKey.first, lookupKey.second,
+                                   signature)) {
+    LOG_GENERAL(WARNING, "Failed to sign blocks");
+    return false;
+  }
+
+  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+
+  if (!result.IsInitialized()) {
+    LOG_GENERAL(WARNING,
+                "LookupSetEncodedBlocksFromSeed initialization failed");
+    return false;
+  }
+
+  return SerializeToArray(result, dst, offset);
+}
+
 // ============================================================================
 // Functions to check for fields in primitives that are used for persistent
 // storage. Remove fields from the checks once they are deprecated.
@@ -455,15 +526,24 @@ bool ProtobufToAccount(const ProtoAccount& protoAccount, Account& account,
                            DataConversion::StringToCharArray(entry.data()));
     }
 
+    // Build the storage root from the received states only
+    account.SetStorageRoot(dev::h256());
     if (!account.SetStorage(addr, entries, false)) {
       return false;
     }
 
     if (account.GetStorageRoot() != tmpStorageRoot) {
-      LOG_GENERAL(WARNING, "Storage root mismatch. Expected: "
-                               << account.GetStorageRoot().hex()
-                               << " Actual: " << tmpStorageRoot.hex());
-      return false;
+      // Senders not yet migrated send the root of the previous format, with
+      // the states in the order that root hashed them
+      if (Contract::GetLegacyStorageRoot(entries) != tmpStorageRoot) {
+        LOG_GENERAL(WARNING, "Storage root mismatch. Expected: "
+                                 << account.GetStorageRoot().hex()
+                                 << " Actual: " << tmpStorageRoot.hex());
+        return false;
+      }
+      LOG_GENERAL(INFO, "Storage root " << tmpStorageRoot << " of contract "
+                                        << addr << " migrated to "
+                                        << account.GetStorageRoot());
     }
   }
 
@@ -915,6 +995,124 @@ bool ProtobufToShardingStructure(
   return true;
 }
 
+bool ShardingStructureDeltaToProtobuf(
+    const uint32_t& version, const DequeOfShard& shards,
+    const DequeOfShard& baseShards,
+    ProtoShardingStructureDelta& protoShardingStructureDelta) {
+  ShardingHash baseHash;
+  if (!Messenger::GetShardingStructureHash(version, baseShards, baseHash)) {
+    LOG_GENERAL(WARNING, "Messenger::GetShardingStructureHash failed");
+    return false;
+  }
+
+  protoShardingStructureDelta.set_version(version);
+  protoShardingStructureDelta.set_basehash(baseHash.data(), baseHash.size);
+
+  // Members of the base are referred to by their position across all shards
+  unordered_map<PubKey, uint32_t> basePositions;
+  vector<const Peer*> basePeers;
+  for (const auto& shard : baseShards) {
+    for (const auto& node : shard) {
+      basePeers.emplace_back(&std::get<SHARD_NODE_PEER>(node));
+      basePositions.emplace(std::get<SHARD_NODE_PUBKEY>(node),
+                            basePeers.size());
+    }
+  }
+
+  for (const auto& shard : shards) {
+    ProtoShardingStructureDelta::Shard* proto_shard =
+        protoShardingStructureDelta.add_shards();
+
+    for (const auto& node : shard) {
+      ProtoShardingStructureDelta::Member* proto_member =
+          proto_shard->add_members();
+
+      const PubKey& key = std::get<SHARD_NODE_PUBKEY>(node);
+      const Peer& peer = std::get<SHARD_NODE_PEER>(node);
+
+      auto basePosition = basePositions.find(key);
+      if (basePosition != basePositions.end()) {
+        proto_member->set_baseindex(basePosition->second);
+        if (*basePeers.at(basePosition->second - 1) != peer) {
+          SerializableToProtobufByteArray(peer,
+                                          *proto_member->mutable_peerinfo());
+        }
+      } else {
+        SerializableToProtobufByteArray(key, *proto_member->mutable_pubkey());
+        SerializableToProtobufByteArray(peer,
+                                        *proto_member->mutable_peerinfo());
+      }
+      proto_member->set_reputation(std::get<SHARD_NODE_REP>(node));
+    }
+  }
+
+  return true;
+}
+
+bool ProtobufToShardingStructureDelta(
+    const ProtoShardingStructureDelta& protoShardingStructureDelta,
+    const DequeOfShard& baseShards, uint32_t& version, DequeOfShard& shards,
+    bool& missingBase) {
+  missingBase = false;
+  version = protoShardingStructureDelta.version();
+
+  ShardingHash baseHash;
+  if (!Messenger::GetShardingStructureHash(version, baseShards, baseHash)) {
+    LOG_GENERAL(WARNING, "Messenger::GetShardingStructureHash failed");
+    return false;
+  }
+
+  const string& protoBaseHash = protoShardingStructureDelta.basehash();
+  if (protoBaseHash.size() != baseHash.size ||
+      !equal(protoBaseHash.begin(), protoBaseHash.end(), baseHash.begin())) {
+    LOG_GENERAL(INFO, "Sharding structure delta is not based on "
+                          << baseHash);
+    missingBase = true;
+    return false;
+  }
+
+  vector<const Shard::value_type*> baseNodes;
+  for (const auto& shard : baseShards) {
+    for (const auto& node : shard) {
+      baseNodes.emplace_back(&node);
+    }
+  }
+
+  for (const auto& proto_shard : protoShardingStructureDelta.shards()) {
+    shards.emplace_back();
+
+    for (const auto& proto_member : proto_shard.members()) {
+      PubKey key;
+      Peer peer;
+
+      if (proto_member.baseindex() > 0) {
+        if (proto_member.baseindex() > baseNodes.size()) {
+          LOG_GENERAL(WARNING, "Invalid base index "
+                                   << proto_member.baseindex() << " of "
+                                   << baseNodes.size());
+          return false;
+        }
+        const auto& baseNode = *baseNodes.at(proto_member.baseindex() - 1);
+        key = std::get<SHARD_NODE_PUBKEY>(baseNode);
+        peer = std::get<SHARD_NODE_PEER>(baseNode);
+      } else if (!proto_member.has_pubkey() || !proto_member.has_peerinfo()) {
+        LOG_GENERAL(WARNING, "New sharding structure member is incomplete");
+        return false;
+      } else {
+        PROTOBUFBYTEARRAYTOSERIALIZABLE(proto_member.pubkey(), key);
+      }
+
+      if (proto_member.has_peerinfo()) {
+        PROTOBUFBYTEARRAYTOSERIALIZABLE(proto_member.peerinfo(), peer);
+      }
+
+      shards.back().emplace_back(key, peer, proto_member.reputation());
+    }
+  }
+
+  return true;
+}
+
 void AnnouncementShardingStructureToProtobuf(
     const DequeOfShard& shards, const MapOfPubKeyPoW& allPoWs,
     ProtoShardingStructureWithPoWSolns& protoShardingStructure) {
@@ -2537,6 +2735,43 @@ bool Messenger::StateDeltaToAddressMap(
   return true;
 }
 
+bool Messenger::StateDeltaToExclusiveUpdates(const bytes& src,
+                                         const unsigned int offset,
+                                         vector<Address>& addresses) {
+  if (offset >= src.size()) {
+    LOG_GENERAL(WARNING, "Invalid data and offset, data size "
+                             << src.size() << ", offset " << offset);
+    return false;
+  }
+
+  ProtoAccountStore result;
+  result.ParseFromArray(src.data() + offset, src.size() - offset);
+
+  if (!result.IsInitialized()) {
+    LOG_GENERAL(WARNING, "ProtoAccountStore initialization failed");
+    return false;
+  }
+
+  for (const auto& entry : result.entries()) {
+    // Balance changes from several shards add up, but a nonce, code or
+    // storage change can only come from one
+    const ProtoAccount& account = entry.account();
+    if (account.base().nonce() == 0 && !account.base().has_codehash() &&
+        !account.base().has_storageroot() && account.storage().empty()) {
+      continue;
+    }
+
+    Address address;
+    if (!CopyWithSizeCheck(entry.address(), address.asArray())) {
+      return false;
+    }
+
+    addresses.emplace_back(address);
+  }
+
+  return true;
+}
+
 bool Messenger::GetAccountStoreDelta(const bytes& src,
                                      const unsigned int offset,
                                      AccountStore& accountStore,
@@ -2648,6 +2883,112 @@ bool Messenger::GetAccountStoreDelta(const bytes& src,
   return true;
 }
 
+bool Messenger::MergeAccountStoreDeltas(const vector<bytes>& deltas,
+                                        bytes& dst, const unsigned int offset) {
+  LOG_MARKER();
+
+  struct MergedAccount {
+    ProtoAccount account;
+    int256_t balanceDelta = 0;
+    uint64_t nonceDelta = 0;
+    map<string, string> storage;
+  };
+
+  // Keep the accounts in the order they first appear in
+  vector<string> addresses;
+  unordered_map<string, MergedAccount> mergedAccounts;
+
+  for (const auto& delta : deltas) {
+    ProtoAccountStore result;
+    result.ParseFromArray(delta.data(), delta.size());
+
+    if (!result.IsInitialized()) {
+      LOG_GENERAL(WARNING, "ProtoAccountStore initialization failed");
+      return false;
+    }
+
+    for (const auto& entry : result.entries()) {
+      const ProtoAccount& protoAccount = entry.account();
+      if (!CheckRequiredFieldsProtoAccount(protoAccount) ||
+          !protoAccount.has_numbersign()) {
+        LOG_GENERAL(WARNING, "Invalid account delta for " << entry.address());
+        return false;
+      }
+
+      auto it = mergedAccounts.find(entry.address());
+      if (it == mergedAccounts.end()) {
+        addresses.emplace_back(entry.address());
+        it = mergedAccounts.emplace(entry.address(), MergedAccount()).first;
+      }
+      MergedAccount& merged = it->second;
+      ProtoAccountBase& mergedBase = *merged.account.mutable_base();
+
+      // Balance and nonce are deltas and add up
+      uint128_t balance;
+      ProtobufByteArrayToNumber<uint128_t, UINT128_SIZE>(
+          protoAccount.base().balance(), balance);
+      merged.balanceDelta += protoAccount.numbersign()
+                                 ? balance.convert_to<int256_t>()
+                                 : 0 - balance.convert_to<int256_t>();
+
+      if (!SafeMath<uint64_t>::add(merged.nonceDelta,
+                                   protoAccount.base().nonce(),
+                                   merged.nonceDelta)) {
+        return false;
+      }
+
+      mergedBase.set_version(protoAccount.base().version());
+
+      // Code is only sent when the account is created
+      if (protoAccount.has_code() && !merged.account.has_code()) {
+        merged.account.set_code(protoAccount.code());
+        mergedBase.set_codehash(protoAccount.base().codehash());
+      }
+
+      // Storage is last-writer-wins per key, with the latest storage root
+      if (protoAccount.base().has_storageroot()) {
+        mergedBase.set_storageroot(protoAccount.base().storageroot());
+      }
+      for (const auto& storageData : protoAccount.storage()) {
+        merged.storage[storageData.keyhash()] = storageData.data();
+      }
+    }
+  }
+
+  ProtoAccountStore result;
+
+  for (const auto& address : addresses) {
+    MergedAccount& merged = mergedAccounts.at(address);
+
+    ProtoAccountStore::AddressAccount* protoEntry = result.add_entries();
+    protoEntry->set_address(address);
+    ProtoAccount* protoEntryAccount = protoEntry->mutable_account();
+    protoEntryAccount->Swap(&merged.account);
+
+    protoEntryAccount->set_numbersign(merged.balanceDelta > 0);
+    NumberToProtobufByteArray<uint128_t, UINT128_SIZE>(
+        uint128_t(abs(merged.balanceDelta)),
+        *protoEntryAccount->mutable_base()->mutable_balance());
+    protoEntryAccount->mutable_base()->set_nonce(merged.nonceDelta);
+
+    for (const auto& storageData : merged.storage) {
+      ProtoAccount::StorageData* entry = protoEntryAccount->add_storage();
+      entry->set_keyhash(storageData.first);
+      entry->set_data(storageData.second);
+    }
+  }
+
+  if (!result.IsInitialized()) {
+    LOG_GENERAL(WARNING, "ProtoAccountStore initialization failed");
+    return false;
+  }
+
+  LOG_GENERAL(INFO, "Merged " << deltas.size() << " state deltas into "
+                              << addresses.size() << " account deltas");
+
+  return SerializeToArray(result, dst, offset);
+}
+
 bool Messenger::GetMbInfoHash(const std::vector<MicroBlockInfo>& mbInfos,
                               MBInfoHash& dst) {
   bytes tmp;
@@ -4344,14 +4685,45 @@ bool Messenger::SetNodeVCDSBlocksMessage(
   return SerializeToArray(result, dst, offset);
 }
 
-bool Messenger::GetNodeVCDSBlocksMessage(const bytes& src,
-                                         const unsigned int offset,
-                                         uint32_t& shardId, DSBlock& dsBlock,
-                                         std::vector<VCBlock>& vcBlocks,
-                                         uint32_t& shardingStructureVersion,
-                                         DequeOfShard& shards) {
+bool Messenger::SetNodeVCDSBlocksMessage(
+    bytes& dst, const unsigned int offset, const uint32_t shardId,
+    const DSBlock& dsBlock, const std::vector<VCBlock>& vcBlocks,
+    const uint32_t& shardingStructureVersion, const DequeOfShard& shards,
+    const DequeOfShard& baseShards) {
   LOG_MARKER();
 
+  NodeDSBlock result;
+
+  result.set_shardid(shardId);
+  DSBlockToProtobuf(dsBlock, *result.mutable_dsblock());
+
+  for (const auto& vcblock : vcBlocks) {
+    VCBlockToProtobuf(vcblock, *result.add_vcblocks());
+  }
+  if (!ShardingStructureDeltaToProtobuf(shardingStructureVersion, shards,
+                                        baseShards,
+                                        *result.mutable_shardingdelta())) {
+    LOG_GENERAL(WARNING, "ShardingStructureDeltaToProtobuf failed");
+    return false;
+  }
+
+  if (!result.IsInitialized()) {
+    LOG_GENERAL(WARNING, "NodeDSBlock initialization failed");
+    return false;
+  }
+
+  return SerializeToArray(result, dst, offset);
+}
+
+bool Messenger::GetNodeVCDSBlocksMessage(
+    const bytes& src, const unsigned int offset, uint32_t& shardId,
+    DSBlock& dsBlock, std::vector<VCBlock>& vcBlocks,
+    uint32_t& shardingStructureVersion, DequeOfShard& shards,
+    const DequeOfShard& baseShards, bool& missingBase) {
+  LOG_MARKER();
+
+  missingBase = false;
+
   if (offset >= src.size()) {
     LOG_GENERAL(WARNING, "Invalid data and offset, data size "
                              << src.size() << ", offset " << offset);
@@ -4380,6 +4752,17 @@ bool Messenger::GetNodeVCDSBlocksMessage(const bytes& src,
     vcBlocks.emplace_back(move(vcblock));
   }
 
+  if (result.has_shardingdelta()) {
+    return ProtobufToShardingStructureDelta(result.shardingdelta(), baseShards,
+                                            shardingStructureVersion, shards,
+                                            missingBase);
+  }
+
+  if (!result.has_sharding()) {
+    LOG_GENERAL(WARNING, "NodeDSBlock has no sharding structure");
+    return false;
+  }
+
   return ProtobufToShardingStructure(result.sharding(),
                                      shardingStructureVersion, shards);
 }
@@ -4493,6 +4876,10 @@ bool Messenger::GetNodeMBnForwardTransaction(const bytes& src,
     TransactionWithReceipt txr;
     PROTOBUFBYTEARRAYTOSERIALIZABLE(txn, txr);
     entry.m_transactions.emplace_back(txr);
+    if (LOOKUP_NODE_MODE) {
+      entry.m_serializedTransactions.emplace_back(txn.data().begin(),
+                                                  txn.data().end());
+    }
     txnsCount++;
   }
 
@@ -4541,10 +4928,16 @@ bool Messenger::GetNodeVCBlock(const bytes& src, const unsigned int offset,
 bool Messenger::SetNodeForwardTxnBlock(
     bytes& dst, const unsigned int offset, const uint64_t& epochNumber,
     const uint64_t& dsBlockNum, const uint32_t& shardId,
-    const PairOfKey& lookupKey, const std::vector<Transaction>& txnsCurrent,
-    const std::vector<Transaction>& txnsGenerated) {
+    const PairOfKey& lookupKey, const bytes& encodedTxns,
+    const vector<uint32_t>& encodedTxnSizes) {
   LOG_MARKER();
 
+  using google::protobuf::io::ArrayOutputStream;
+  using google::protobuf::io::CodedOutputStream;
+
+  // NodeForwardTxnBlock { ...; repeated ProtoTransaction transactions = 5; }
+  const uint32_t TRANSACTIONS_TAG = (5 << 3) | 2;
+
   NodeForwardTxnBlock result;
 
   result.set_epochnumber(epochNumber);
@@ -4552,69 +4945,62 @@ bool Messenger::SetNodeForwardTxnBlock(
   result.set_shardid(shardId);
   SerializableToProtobufByteArray(lookupKey.second, *result.mutable_pubkey());
 
-  unsigned int txnsCurrentCount = 0;
-  unsigned int txnsGeneratedCount = 0;
+  // The signature covers the concatenated txns, same as RepeatableToArray on
+  // the receiving side
+  Signature signature;
+  if (!encodedTxnSizes.empty() &&
+      !Schnorr::GetInstance().Sign(encodedTxns, lookupKey.first,
+                                   lookupKey.second, signature)) {
+    LOG_GENERAL(WARNING, "Failed to sign transactions");
+    return false;
+  }
 
-  unsigned int msg_size = 0;
+  SerializableToProtobufByteArray(signature, *result.mutable_signature());
 
-  for (const auto& txn : txnsCurrent) {
-    if (msg_size >= PACKET_BYTESIZE_LIMIT) {
-      break;
-    }
-    ProtoTransaction* protoTxn = new ProtoTransaction();
-    TransactionToProtobuf(txn, *protoTxn);
-    unsigned txn_size = protoTxn->ByteSize();
-    if ((msg_size + txn_size) > PACKET_BYTESIZE_LIMIT &&
-        txn_size >= SMALL_TXN_SIZE) {
-      continue;
-    }
-    *result.add_transactions() = *protoTxn;
-    txnsCurrentCount++;
-    msg_size += protoTxn->ByteSize();
+  if (!result.IsInitialized()) {
+    LOG_GENERAL(WARNING, "NodeForwardTxnBlock initialization failed");
+    return false;
   }
 
-  for (const auto& txn : txnsGenerated) {
-    if (msg_size >= PACKET_BYTESIZE_LIMIT) {
-      break;
-    }
-    ProtoTransaction* protoTxn = new ProtoTransaction();
-    TransactionToProtobuf(txn, *protoTxn);
-    unsigned txn_size = protoTxn->ByteSize();
-    if ((msg_size + txn_size) > PACKET_BYTESIZE_LIMIT &&
-        txn_size >= SMALL_TXN_SIZE) {
-      continue;
-    }
-    *result.add_transactions() = *protoTxn;
-    txnsGeneratedCount++;
-    msg_size += txn_size;
+  // Header fields are written first, the txns are appended as is since
+  // protobuf accepts fields in any order
+  size_t txnsFieldSize = 0;
+  for (const auto& txnSize : encodedTxnSizes) {
+    txnsFieldSize += CodedOutputStream::VarintSize32(TRANSACTIONS_TAG) +
+                     CodedOutputStream::VarintSize32(txnSize) + txnSize;
   }
 
-  Signature signature;
-  if (result.transactions().size() > 0) {
-    bytes tmp;
-    if (!RepeatableToArray(result.transactions(), tmp, 0)) {
-      LOG_GENERAL(WARNING, "Failed to serialize transactions");
-      return false;
-    }
-    if (!Schnorr::GetInstance().Sign(tmp, lookupKey.first, lookupKey.second,
-                                     signature)) {
-      LOG_GENERAL(WARNING, "Failed to sign transactions");
+  const unsigned int headerSize = result.ByteSize();
+  dst.resize(offset + headerSize + txnsFieldSize);
+  if (!result.SerializeToArray(dst.data() + offset, headerSize)) {
+    LOG_GENERAL(WARNING, "Failed to serialize NodeForwardTxnBlock header");
+    return false;
+  }
+
+  ArrayOutputStream txnsStream(dst.data() + offset + headerSize,
+                               txnsFieldSize);
+  CodedOutputStream codedOut(&txnsStream);
+  size_t txnOffset = 0;
+  for (const auto& txnSize : encodedTxnSizes) {
+    if (txnOffset + txnSize > encodedTxns.size()) {
+      LOG_GENERAL(WARNING, "Encoded txn sizes exceed encoded txns");
       return false;
     }
+    codedOut.WriteTag(TRANSACTIONS_TAG);
+    codedOut.WriteVarint32(txnSize);
+    codedOut.WriteRaw(encodedTxns.data() + txnOffset, txnSize);
+    txnOffset += txnSize;
   }
 
-  SerializableToProtobufByteArray(signature, *result.mutable_signature());
-
-  if (!result.IsInitialized()) {
-    LOG_GENERAL(WARNING, "NodeForwardTxnBlock initialization failed");
+  if (codedOut.HadError()) {
+    LOG_GENERAL(WARNING, "Failed to encode transactions");
     return false;
   }
 
   LOG_GENERAL(INFO, "Epoch: " << epochNumber << " shardId: " << shardId
-                              << " Current txns: " << txnsCurrentCount
-                              << " Generated txns: " << txnsGeneratedCount);
+                              << " Txns: " << encodedTxnSizes.size());
 
-  return SerializeToArray(result, dst, offset);
+  return true;
 }
 
 bool Messenger::SetNodeForwardTxnBlock(bytes& dst, const unsigned int offset,
@@ -4641,14 +5027,14 @@ bool Messenger::SetNodeForwardTxnBlock(bytes& dst, const unsigned int offset,
     if (msg_size >= PACKET_BYTESIZE_LIMIT) {
       break;
     }
-    ProtoTransaction* protoTxn = new ProtoTransaction();
-    TransactionToProtobuf(txn, *protoTxn);
-    unsigned txn_size = protoTxn->ByteSize();
+    ProtoTransaction protoTxn;
+    TransactionToProtobuf(txn, protoTxn);
+    unsigned txn_size = protoTxn.ByteSize();
     if ((msg_size + txn_size) > PACKET_BYTESIZE_LIMIT &&
         txn_size >= SMALL_TXN_SIZE) {
       continue;
     }
-    *result.add_transactions() = *protoTxn;
+    *result.add_transactions() = move(protoTxn);
     txnsCount++;
     msg_size += txn_size;
   }
@@ -5039,6 +5425,56 @@ bool Messenger::GetNodeMissingTxnsErrorMsg(const bytes& src,
   return true;
 }
 
+bool Messenger::SetNodeMempoolSummary(bytes& dst, const unsigned int offset,
+                                      const uint64_t epochNum,
+                                      const uint32_t listenPort,
+                                      const vector<uint64_t>& shortTxnIds) {
+  LOG_MARKER();
+
+  NodeMempoolSummary result;
+
+  result.set_epochnum(epochNum);
+  result.set_listenport(listenPort);
+  result.mutable_shorttxnids()->Reserve(shortTxnIds.size());
+  for (const auto& shortTxnId : shortTxnIds) {
+    result.add_shorttxnids(shortTxnId);
+  }
+
+  if (!result.IsInitialized()) {
+    LOG_GENERAL(WARNING, "NodeMempoolSummary initialization failed");
+    return false;
+  }
+
+  return SerializeToArray(result, dst, offset);
+}
+
+bool Messenger::GetNodeMempoolSummary(const bytes& src,
+                                      const unsigned int offset,
+                                      uint64_t& epochNum, uint32_t& listenPort,
+                                      vector<uint64_t>& shortTxnIds) {
+  LOG_MARKER();
+
+  if (offset >= src.size()) {
+    LOG_GENERAL(WARNING, "Invalid data and offset, data size "
+                             << src.size() << ", offset " << offset);
+    return false;
+  }
+
+  NodeMempoolSummary result;
+  result.ParseFromArray(src.data() + offset, src.size() - offset);
+
+  if (!result.IsInitialized()) {
+    LOG_GENERAL(WARNING, "NodeMempoolSummary initialization failed");
+    return false;
+  }
+
+  epochNum = result.epochnum();
+  listenPort = result.listenport();
+  shortTxnIds.assign(result.shorttxnids().begin(), result.shorttxnids().end());
+
+  return true;
+}
+
 // ============================================================================
 // Lookup messages
 // ============================================================================
@@ -5402,6 +5838,16 @@ bool Messenger::SetLookupSetDSBlockFromSeed(bytes& dst,
   return SerializeToArray(result, dst, offset);
 }
 
+bool Messenger::SetLookupSetDSBlockFromSeed(
+    bytes& dst, const unsigned int offset, const uint64_t lowBlockNum,
+    const uint64_t highBlockNum, const PairOfKey& lookupKey,
+    const vector<shared_ptr<const bytes>>& dsBlocks) {
+  LOG_MARKER();
+
+  return EncodedBlocksToLookupSetBlockFromSeed(
+      dst, offset, lowBlockNum, highBlockNum, lookupKey, dsBlocks);
+}
+
 bool Messenger::GetLookupSetDSBlockFromSeed(
     const bytes& src, const unsigned int offset, uint64_t& lowBlockNum,
     uint64_t& highBlockNum, PubKey& lookupPubKey, vector<DSBlock>& dsBlocks) {
@@ -5541,6 +5987,16 @@ bool Messenger::SetLookupSetTxBlockFromSeed(bytes& dst,
   return SerializeToArray(result, dst, offset);
 }
 
+bool Messenger::SetLookupSetTxBlockFromSeed(
+    bytes& dst, const unsigned int offset, const uint64_t lowBlockNum,
+    const uint64_t highBlockNum, const PairOfKey& lookupKey,
+    const vector<shared_ptr<const bytes>>& txBlocks) {
+  LOG_MARKER();
+
+  return EncodedBlocksToLookupSetBlockFromSeed(
+      dst, offset, lowBlockNum, highBlockNum, lookupKey, txBlocks);
+}
+
 bool Messenger::GetLookupSetTxBlockFromSeed(
     const bytes& src, const unsigned int offset, uint64_t& lowBlockNum,
     uint64_t& highBlockNum, PubKey& lookupPubKey, vector<TxBlock>& txBlocks) {
@@ -5959,6 +6415,230 @@ bool Messenger::GetLookupSetStateFromSeed(const bytes& src,
   return true;
 }
 
+void StateSnapshotManifestToProtobuf(
+    const StateSnapshotManifest& manifest,
+    ProtoStateSnapshotManifest& protoManifest) {
+  protoManifest.set_txblocknum(manifest.m_txBlockNum);
+  protoManifest.set_stateroot(manifest.m_stateRoot.data(),
+                              manifest.m_stateRoot.size);
+  for (const auto& chunkHash : manifest.m_chunkHashes) {
+    protoManifest.add_chunkhashes(chunkHash.data(), chunkHash.size);
+  }
+}
+
+bool ProtobufToStateSnapshotManifest(
+    const ProtoStateSnapshotManifest& protoManifest,
+    StateSnapshotManifest& manifest) {
+  manifest.m_txBlockNum = protoManifest.txblocknum();
+
+  if (!Messenger::CopyWithSizeCheck(protoManifest.stateroot(),
+                                    manifest.m_stateRoot.asArray())) {
+    return false;
+  }
+
+  manifest.m_chunkHashes.clear();
+  for (const auto& protoChunkHash : protoManifest.chunkhashes()) {
+    dev::h256 chunkHash;
+    if (!Messenger::CopyWithSizeCheck(protoChunkHash, chunkHash.asArray())) {
+      return false;
+    }
+    manifest.m_chunkHashes.emplace_back(chunkHash);
+  }
+
+  return true;
+}
+
+bool Messenger::SetLookupGetStateSnapshotManifestFromSeed(
+    bytes& dst, const unsigned int offset, const uint32_t listenPort) {
+  LOG_MARKER();
+
+  LookupGetStateSnapshotManifestFromSeed result;
+
+  result.set_listenport(listenPort);
+
+  if (!result.IsInitialized()) {
+    LOG_GENERAL(WARNING,
+                "LookupGetStateSnapshotManifestFromSeed initialization failed");
+    return false;
+  }
+
+  return SerializeToArray(result, dst, offset);
+}
+
+bool Messenger::GetLookupGetStateSnapshotManifestFromSeed(
+    const bytes& src, const unsigned int offset, uint32_t& listenPort) {
+  LOG_MARKER();
+
+  if (offset >= src.size()) {
+    LOG_GENERAL(WARNING, "Invalid data and offset, data size "
+                             << src.size() << ", offset " << offset);
+    return false;
+  }
+
+  LookupGetStateSnapshotManifestFromSeed result;
+  result.ParseFromArray(src.data() + offset, src.size() - offset);
+
+  if (!result.IsInitialized()) {
+    LOG_GENERAL(WARNING,
+                "LookupGetStateSnapshotManifestFromSeed initialization failed");
+    return false;
+  }
+
+  listenPort = result.listenport();
+
+  return true;
+}
+
+bool Messenger::SetLookupSetStateSnapshotManifestFromSeed(
+    bytes& dst, const unsigned int offset, const PairOfKey& lookupKey,
+    const StateSnapshotManifest& manifest) {
+  LOG_MARKER();
+
+  LookupSetStateSnapshotManifestFromSeed result;
+
+  StateSnapshotManifestToProtobuf(manifest, *result.mutable_manifest());
+
+  SerializableToProtobufByteArray(lookupKey.second, *result.mutable_pubkey());
+
+  Signature signature;
+  if (!result.manifest().IsInitialized()) {
+    LOG_GENERAL(WARNING, "ProtoStateSnapshotManifest initialization failed");
+    return false;
+  }
+  bytes tmp(result.manifest().ByteSize());
+  result.manifest().SerializeToArray(tmp.data(), tmp.size());
+
+  if (!Schnorr::GetInstance().Sign(tmp, lookupKey.first, lookupKey.second,
+                                   signature)) {
+    LOG_GENERAL(WARNING, "Failed to sign state snapshot manifest");
+    return false;
+  }
+
+  SerializableToProtobufByteArray(signature, *result.mutable_signature());
+
+  if (!result.IsInitialized()) {
+    LOG_GENERAL(WARNING,
+                "LookupSetStateSnapshotManifestFromSeed initialization failed");
+    return false;
+  }
+
+  return SerializeToArray(result, dst, offset);
+}
+
+bool Messenger::GetLookupSetStateSnapshotManifestFromSeed(
+    const bytes& src, const unsigned int offset, PubKey& lookupPubKey,
+    StateSnapshotManifest& manifest) {
+  LOG_MARKER();
+
+  if (offset >= src.size()) {
+    LOG_GENERAL(WARNING, "Invalid data and offset, data size "
+                             << src.size() << ", offset " << offset);
+    return false;
+  }
+
+  LookupSetStateSnapshotManifestFromSeed result;
+  result.ParseFromArray(src.data() + offset, src.size() - offset);
+
+  if (!result.IsInitialized()) {
+    LOG_GENERAL(WARNING,
+                "LookupSetStateSnapshotManifestFromSeed initialization failed");
+    return false;
+  }
+
+  bytes tmp(result.manifest().ByteSize());
+  result.manifest().SerializeToArray(tmp.data(), tmp.size());
+
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.pubkey(), lookupPubKey);
+  Signature signature;
+  PROTOBUFBYTEARRAYTOSERIALIZABLE(result.signature(), signature);
+
+  if (!Schnorr::GetInstance().Verify(tmp, signature, lookupPubKey)) {
+    LOG_GENERAL(WARNING, "Invalid signature in state snapshot manifest");
+    return false;
+  }
+
+  return ProtobufToStateSnapshotManifest(result.manifest(), manifest);
+}
+
+bool Messenger::SetLookupGetStateSnapshotChunkFromSeed(
+    bytes& dst, const unsigned int offset, const uint64_t txBlockNum,
+    const dev::h256& chunkHash, const uint32_t listenPort) {
+  LookupGetStateSnapshotChunkFromSeed result;
+
+  result.set_txblocknum(txBlockNum);
+  result.set_chunkhash(chunkHash.data(), chunkHash.size);
+  result.set_listenport(listenPort);
+
+  if (!result.IsInitialized()) {
+    LOG_GENERAL(WARNING,
+                "LookupGetStateSnapshotChunkFromSeed initialization failed");
+    return false;
+  }
+
+  return SerializeToArray(result, dst, offset);
+}
+
+bool Messenger::GetLookupGetStateSnapshotChunkFromSeed(
+    const bytes& src, const unsigned int offset, uint64_t& txBlockNum,
+    dev::h256& chunkHash, uint32_t& listenPort) {
+  if (offset >= src.size()) {
+    LOG_GENERAL(WARNING, "Invalid data and offset, data size "
+                             << src.size() << ", offset " << offset);
+    return false;
+  }
+
+  LookupGetStateSnapshotChunkFromSeed result;
+  result.ParseFromArray(src.data() + offset, src.size() - offset);
+
+  if (!result.IsInitialized()) {
+    LOG_GENERAL(WARNING,
+                "LookupGetStateSnapshotChunkFromSeed initialization failed");
+    return false;
+  }
+
+  txBlockNum = result.txblocknum();
+  listenPort = result.listenport();
+
+  return CopyWithSizeCheck(result.chunkhash(), chunkHash.asArray());
+}
+
+bool Messenger::SetLookupSetStateSnapshotChunkFromSeed(
+    bytes& dst, const unsigned int offset, const bytes& chunk) {
+  LookupSetStateSnapshotChunkFromSeed result;
+
+  result.set_chunk(chunk.data(), chunk.size());
+
+  if (!result.IsInitialized()) {
+    LOG_GENERAL(WARNING,
+                "LookupSetStateSnapshotChunkFromSeed initialization failed");
+    return false;
+  }
+
+  return SerializeToArray(result, dst, offset);
+}
+
+bool Messenger::GetLookupSetStateSnapshotChunkFromSeed(
+    const bytes& src, const unsigned int offset, bytes& chunk) {
+  if (offset >= src.size()) {
+    LOG_GENERAL(WARNING, "Invalid data and offset, data size "
+                             << src.size() << ", offset " << offset);
+    return false;
+  }
+
+  LookupSetStateSnapshotChunkFromSeed result;
+  result.ParseFromArray(src.data() + offset, src.size() - offset);
+
+  if (!result.IsInitialized()) {
+    LOG_GENERAL(WARNING,
+                "LookupSetStateSnapshotChunkFromSeed initialization failed");
+    return false;
+  }
+
+  chunk.assign(result.chunk().begin(), result.chunk().end());
+
+  return true;
+}
+
 bool Messenger::SetLookupSetLookupOffline(bytes& dst, const unsigned int offset,
                                           const uint8_t msgType,
                                           const uint32_t listenPort,
@@ -6499,12 +7179,14 @@ bool Messenger::GetForwardTxnBlockFromSeed(
 // UNUSED
 bool Messenger::SetLookupGetShardsFromSeed(bytes& dst,
                                            const unsigned int offset,
-                                           const uint32_t listenPort) {
+                                           const uint32_t listenPort,
+                                           const uint64_t requestId) {
   LOG_MARKER();
 
   LookupGetShardsFromSeed result;
 
   result.set_listenport(listenPort);
+  result.set_requestid(requestId);
 
   if (!result.IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupGetShardsFromSeed initialization failed");
@@ -6517,7 +7199,8 @@ bool Messenger::SetLookupGetShardsFromSeed(bytes& dst,
 // UNUSED
 bool Messenger::GetLookupGetShardsFromSeed(const bytes& src,
                                            const unsigned int offset,
-                                           uint32_t& listenPort) {
+                                           uint32_t& listenPort,
+                                           uint64_t& requestId) {
   LOG_MARKER();
 
   if (offset >= src.size()) {
@@ -6535,6 +7218,7 @@ bool Messenger::GetLookupGetShardsFromSeed(const bytes& src,
   }
 
   listenPort = result.listenport();
+  requestId = result.requestid();
 
   return true;
 }
@@ -6542,7 +7226,8 @@ bool Messenger::GetLookupGetShardsFromSeed(const bytes& src,
 // UNUSED
 bool Messenger::SetLookupSetShardsFromSeed(
     bytes& dst, const unsigned int offset, const PairOfKey& lookupKey,
-    const uint32_t& shardingStructureVersion, const DequeOfShard& shards) {
+    const uint32_t& shardingStructureVersion, const DequeOfShard& shards,
+    const uint64_t requestId) {
   LOG_MARKER();
 
   LookupSetShardsFromSeed result;
@@ -6565,6 +7250,7 @@ bool Messenger::SetLookupSetShardsFromSeed(
   }
 
   SerializableToProtobufByteArray(signature, *result.mutable_signature());
+  result.set_requestid(requestId);
 
   if (!result.IsInitialized()) {
     LOG_GENERAL(WARNING, "LookupSetShardsFromSeed initialization failed");
@@ -6578,7 +7264,8 @@ bool Messenger::GetLookupSetShardsFromSeed(const bytes& src,
                                            const unsigned int offset,
                                            PubKey& lookupPubKey,
                                            uint32_t& shardingStructureVersion,
-                                           DequeOfShard& shards) {
+                                           DequeOfShard& shards,
+                                           uint64_t& requestId) {
   LOG_MARKER();
 
   if (offset >= src.size()) {
@@ -6616,6 +7303,8 @@ bool Messenger::GetLookupSetShardsFromSeed(const bytes& src,
     return false;
   }
 
+  requestId = result.requestid();
+
   return true;
 }
 
@@ -28,6 +28,7 @@
 #include "libDirectoryService/DirectoryService.h"
 #include "libNetwork/Peer.h"
 #include "libNetwork/ShardStruct.h"
+#include "libPersistence/StateSnapshot.h"
 
 #define PROTOBUFBYTEARRAYTOSERIALIZABLE(ba, s)                       \
   if (!ProtobufByteArrayToSerializable(ba, s)) {                     \
@@ -102,6 +103,10 @@ class Messenger {
   static bool GetAccountStoreDelta(const bytes& src, const unsigned int offset,
                                    AccountStoreTemp& accountStoreTemp,
                                    bool temp);
+  /// Coalesces consecutive state deltas into a single delta: balance and
+  /// nonce changes are summed, storage entries are last-writer-wins per key
+  static bool MergeAccountStoreDeltas(const std::vector<bytes>& deltas,
+                                      bytes& dst, const unsigned int offset);
 
   static bool GetMbInfoHash(const std::vector<MicroBlockInfo>& mbInfos,
                             MBInfoHash& dst);
@@ -199,6 +204,10 @@ class Messenger {
   static bool StateDeltaToAddressMap(
       const bytes& src, const unsigned int offset,
       std::unordered_map<Address, boost::multiprecision::int256_t>& accountMap);
+  /// Gets the accounts whose nonce, code or storage the state delta changes
+  static bool StateDeltaToExclusiveUpdates(const bytes& src,
+                                           const unsigned int offset,
+                                           std::vector<Address>& addresses);
 
   static bool SetBlockLink(bytes& dst, const unsigned int offset,
                            const std::tuple<uint32_t, uint64_t, uint64_t,
@@ -340,12 +349,26 @@ class Messenger {
                                        const uint32_t& shardingStructureVersion,
                                        const DequeOfShard& shards);
 
+  /// Encodes the sharding structure relative to baseShards, the structure of
+  /// the previous DS block
+  static bool SetNodeVCDSBlocksMessage(bytes& dst, const unsigned int offset,
+                                       const uint32_t shardId,
+                                       const DSBlock& dsBlock,
+                                       const std::vector<VCBlock>& vcBlocks,
+                                       const uint32_t& shardingStructureVersion,
+                                       const DequeOfShard& shards,
+                                       const DequeOfShard& baseShards);
+
+  /// missingBase is set if the sharding structure is relative to a structure
+  /// other than baseShards. dsBlock and vcBlocks are still read in that case.
   static bool GetNodeVCDSBlocksMessage(const bytes& src,
                                        const unsigned int offset,
                                        uint32_t& shardId, DSBlock& dsBlock,
                                        std::vector<VCBlock>& vcBlocks,
                                        uint32_t& shardingStructureVersion,
-                                       DequeOfShard& shards);
+                                       DequeOfShard& shards,
+                                       const DequeOfShard& baseShards,
+                                       bool& missingBase);
 
   static bool SetNodeFinalBlock(bytes& dst, const unsigned int offset,
                                 const uint64_t dsBlockNumber,
@@ -369,11 +392,14 @@ class Messenger {
                                            const unsigned int offset,
                                            MBnForwardedTxnEntry& entry);
 
+  /// Finalizes a NodeForwardTxnBlock from txns already encoded as
+  /// ProtoTransaction (concatenated in encodedTxns, with the size of each in
+  /// encodedTxnSizes). Only the header and signature are encoded here.
   static bool SetNodeForwardTxnBlock(
       bytes& dst, const unsigned int offset, const uint64_t& epochNumber,
       const uint64_t& dsBlockNum, const uint32_t& shardId,
-      const PairOfKey& lookupKey, const std::vector<Transaction>& txnsCurrent,
-      const std::vector<Transaction>& txnsGenerated);
+      const PairOfKey& lookupKey, const bytes& encodedTxns,
+      const std::vector<uint32_t>& encodedTxnSizes);
   static bool SetNodeForwardTxnBlock(bytes& dst, const unsigned int offset,
                                      const uint64_t& epochNumber,
                                      const uint64_t& dsBlockNum,
@@ -431,6 +457,15 @@ class Messenger {
                                          uint64_t& epochNum,
                                          uint32_t& listenPort);
 
+  static bool SetNodeMempoolSummary(bytes& dst, const unsigned int offset,
+                                    const uint64_t epochNum,
+                                    const uint32_t listenPort,
+                                    const std::vector<uint64_t>& shortTxnIds);
+  static bool GetNodeMempoolSummary(const bytes& src,
+                                    const unsigned int offset,
+                                    uint64_t& epochNum, uint32_t& listenPort,
+                                    std::vector<uint64_t>& shortTxnIds);
+
   // ============================================================================
   // Lookup messages
   // ============================================================================
@@ -475,6 +510,10 @@ class Messenger {
                                           const uint64_t highBlockNum,
                                           const PairOfKey& lookupKey,
                                           const std::vector<DSBlock>& dsBlocks);
+  static bool SetLookupSetDSBlockFromSeed(
+      bytes& dst, const unsigned int offset, const uint64_t lowBlockNum,
+      const uint64_t highBlockNum, const PairOfKey& lookupKey,
+      const std::vector<std::shared_ptr<const bytes>>& dsBlocks);
   static bool GetLookupSetDSBlockFromSeed(const bytes& src,
                                           const unsigned int offset,
                                           uint64_t& lowBlockNum,
@@ -495,6 +534,10 @@ class Messenger {
                                           const uint64_t highBlockNum,
                                           const PairOfKey& lookupKey,
                                           const std::vector<TxBlock>& txBlocks);
+  static bool SetLookupSetTxBlockFromSeed(
+      bytes& dst, const unsigned int offset, const uint64_t lowBlockNum,
+      const uint64_t highBlockNum, const PairOfKey& lookupKey,
+      const std::vector<std::shared_ptr<const bytes>>& txBlocks);
   static bool GetLookupSetTxBlockFromSeed(const bytes& src,
                                           const unsigned int offset,
                                           uint64_t& lowBlockNum,
@@ -551,6 +594,28 @@ class Messenger {
                                         const unsigned int offset,
                                         PubKey& lookupPubKey,
                                         bytes& accountStoreBytes);
+  static bool SetLookupGetStateSnapshotManifestFromSeed(
+      bytes& dst, const unsigned int offset, const uint32_t listenPort);
+  static bool GetLookupGetStateSnapshotManifestFromSeed(
+      const bytes& src, const unsigned int offset, uint32_t& listenPort);
+  static bool SetLookupSetStateSnapshotManifestFromSeed(
+      bytes& dst, const unsigned int offset, const PairOfKey& lookupKey,
+      const StateSnapshotManifest& manifest);
+  static bool GetLookupSetStateSnapshotManifestFromSeed(
+      const bytes& src, const unsigned int offset, PubKey& lookupPubKey,
+      StateSnapshotManifest& manifest);
+  static bool SetLookupGetStateSnapshotChunkFromSeed(
+      bytes& dst, const unsigned int offset, const uint64_t txBlockNum,
+      const dev::h256& chunkHash, const uint32_t listenPort);
+  static bool GetLookupGetStateSnapshotChunkFromSeed(
+      const bytes& src, const unsigned int offset, uint64_t& txBlockNum,
+      dev::h256& chunkHash, uint32_t& listenPort);
+  static bool SetLookupSetStateSnapshotChunkFromSeed(bytes& dst,
+                                                     const unsigned int offset,
+                                                     const bytes& chunk);
+  static bool GetLookupSetStateSnapshotChunkFromSeed(const bytes& src,
+                                                     const unsigned int offset,
+                                                     bytes& chunk);
   static bool SetLookupSetLookupOffline(bytes& dst, const unsigned int offset,
                                         const uint8_t msgType,
                                         const uint32_t listenPort,
@@ -605,22 +670,26 @@ class Messenger {
                                            PubKey& lookupPubKey);
   // UNUSED
   static bool SetLookupGetShardsFromSeed(bytes& dst, const unsigned int offset,
-                                         const uint32_t listenPort);
+                                         const uint32_t listenPort,
+                                         const uint64_t requestId);
 
   // UNUSED
   static bool GetLookupGetShardsFromSeed(const bytes& src,
                                          const unsigned int offset,
-                                         uint32_t& listenPort);
+                                         uint32_t& listenPort,
+                                         uint64_t& requestId);
   // UNUSED
   static bool SetLookupSetShardsFromSeed(
       bytes& dst, const unsigned int offset, const PairOfKey& lookupKey,
-      const uint32_t& shardingStructureVersion, const DequeOfShard& shards);
+      const uint32_t& shardingStructureVersion, const DequeOfShard& shards,
+      const uint64_t requestId);
 
   static bool GetLookupSetShardsFromSeed(const bytes& src,
                                          const unsigned int offset,
                                          PubKey& lookupPubKey,
                                          uint32_t& shardingStructureVersion,
-                                         DequeOfShard& shards);
+                                         DequeOfShard& shards,
+                                         uint64_t& requestId);
 
   static bool SetForwardTxnBlockFromSeed(
       bytes& dst, const unsigned int offset,
@@ -37,6 +37,13 @@ template bool MessengerAccountStoreTrie::SetAccountStoreTrie<
         stateTrie,
     const shared_ptr<unordered_map<Address, Account>>& addressToAccount);
 
+template bool MessengerAccountStoreTrie::SetAccountStoreTrieChunks<
+    dev::OverlayDB, std::unordered_map<Address, Account>>(
+    vector<bytes>& chunks, const unsigned int maxChunkSize,
+    const dev::SpecificTrieDB<dev::GenericTrieDB<dev::OverlayDB>, Address>&
+        stateTrie,
+    const shared_ptr<unordered_map<Address, Account>>& addressToAccount);
+
 template <class DB, class MAP>
 bool MessengerAccountStoreTrie::SetAccountStoreTrie(
     bytes& dst, const unsigned int offset,
@@ -79,4 +86,65 @@ bool MessengerAccountStoreTrie::SetAccountStoreTrie(
   }
 
   return SerializeToArray(result, dst, offset);
-}
\ No newline at end of file
+}
+
+template <class DB, class MAP>
+bool MessengerAccountStoreTrie::SetAccountStoreTrieChunks(
+    vector<bytes>& chunks, const unsigned int maxChunkSize,
+    const dev::SpecificTrieDB<dev::GenericTrieDB<DB>, Address>& stateTrie,
+    const shared_ptr<MAP>& addressToAccount) {
+  chunks.clear();
+
+  ProtoAccountStore result;
+  size_t resultSize = 0;
+
+  for (const auto& i : stateTrie) {
+    ProtoAccountStore::AddressAccount protoEntry;
+    Address address(i.first);
+    protoEntry.set_address(address.data(), address.size);
+    ProtoAccount* protoEntryAccount = protoEntry.mutable_account();
+
+    auto it = addressToAccount->find(address);
+    if (it != addressToAccount->end()) {
+      AccountToProtobuf(it->second, *protoEntryAccount);
+    } else {
+      Account account;
+      if (!account.DeserializeBase(bytes(i.second.begin(), i.second.end()),
+                                   0)) {
+        LOG_GENERAL(WARNING, "Account::DeserializeBase failed");
+        return false;
+      }
+      if (account.GetCodeHash() != dev::h256()) {
+        account.SetAddress(address);
+      }
+      AccountToProtobuf(account, *protoEntryAccount);
+    }
+
+    if (!protoEntryAccount->IsInitialized()) {
+      LOG_GENERAL(WARNING, "ProtoAccount initialization failed.");
+      return false;
+    }
+
+    const size_t entrySize = protoEntry.ByteSize();
+    if (result.entries_size() > 0 && resultSize + entrySize > maxChunkSize) {
+      chunks.emplace_back();
+      if (!SerializeToArray(result, chunks.back(), 0)) {
+        return false;
+      }
+      result.Clear();
+      resultSize = 0;
+    }
+
+    result.add_entries()->Swap(&protoEntry);
+    resultSize += entrySize;
+  }
+
+  if (result.entries_size() > 0) {
+    chunks.emplace_back();
+    if (!SerializeToArray(result, chunks.back(), 0)) {
+      return false;
+    }
+  }
+
+  return true;
+}
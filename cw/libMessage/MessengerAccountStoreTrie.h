@@ -36,6 +36,14 @@ class MessengerAccountStoreTrie {
       bytes& dst, const unsigned int offset,
       const dev::SpecificTrieDB<dev::GenericTrieDB<DB>, Address>& stateTrie,
       const std::shared_ptr<MAP>& addressToAccount);
+
+  /// Same encoding as SetAccountStoreTrie, split into multiple account stores
+  /// of roughly maxChunkSize bytes each
+  template <class DB, class MAP>
+  static bool SetAccountStoreTrieChunks(
+      std::vector<bytes>& chunks, const unsigned int maxChunkSize,
+      const dev::SpecificTrieDB<dev::GenericTrieDB<DB>, Address>& stateTrie,
+      const std::shared_ptr<MAP>& addressToAccount);
 };
 
 #endif  // __MESSENGERACCOUNTSTORETRIE_H__
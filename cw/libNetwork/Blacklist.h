@@ -24,15 +24,7 @@
 #include <unordered_map>
 
 #include "common/BaseType.h"
-
-namespace std {
-template <>
-struct hash<uint128_t> {
-  std::size_t operator()(const uint128_t& key) const {
-    return std::hash<std::string>()(key.convert_to<std::string>());
-  }
-};
-}  // namespace std
+#include "libUtils/Uint128.h"
 
 class Blacklist {
   Blacklist();
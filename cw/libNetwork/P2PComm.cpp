@@ -57,7 +57,7 @@ const unsigned int GOSSIP_SNDR_LISTNR_PORT_LEN = 4;
 
 P2PComm::Dispatcher P2PComm::m_dispatcher;
 std::mutex P2PComm::m_mutexPeerConnectionCount;
-std::map<uint128_t, uint16_t> P2PComm::m_peerConnectionCount;
+std::unordered_map<uint128_t, uint16_t> P2PComm::m_peerConnectionCount;
 
 /// Comparison operator for ordering the list of message hashes.
 struct hash_compare {
@@ -201,7 +201,7 @@ bool SendJob::SendMessageSocketCore(const Peer& peer, const bytes& message,
 
     struct sockaddr_in serv_addr;
     serv_addr.sin_family = AF_INET;
-    serv_addr.sin_addr.s_addr = peer.m_ipAddress.convert_to<unsigned long>();
+    serv_addr.sin_addr.s_addr = peer.GetIPv4Address();
     serv_addr.sin_port = htons(peer.m_listenPortHost);
 
     if (connect(cli_sock, (struct sockaddr*)&serv_addr, sizeof(serv_addr)) <
@@ -24,6 +24,7 @@
 #include <functional>
 #include <mutex>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 #include "Peer.h"
@@ -100,7 +101,7 @@ class P2PComm {
   PairOfKey m_selfKey;
 
   static std::mutex m_mutexPeerConnectionCount;
-  static std::map<uint128_t, uint16_t> m_peerConnectionCount;
+  static std::unordered_map<uint128_t, uint16_t> m_peerConnectionCount;
 
   ThreadPool m_SendPool{MAXMESSAGE, "SendPool"};
 
@@ -54,7 +54,7 @@ bool Peer::operator<(const Peer& r) const {
 const string Peer::GetPrintableIPAddress() const {
   char str[INET_ADDRSTRLEN];
   struct sockaddr_in serv_addr;
-  serv_addr.sin_addr.s_addr = m_ipAddress.convert_to<unsigned long>();
+  serv_addr.sin_addr.s_addr = GetIPv4Address();
   inet_ntop(AF_INET, &(serv_addr.sin_addr), str, INET_ADDRSTRLEN);
   return string(str);
 }
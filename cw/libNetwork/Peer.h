@@ -18,11 +18,13 @@
 #ifndef __PEER_H__
 #define __PEER_H__
 
+#include <boost/functional/hash.hpp>
 #include <cstdint>
 #include <functional>
 
 #include "common/BaseType.h"
 #include "common/Serializable.h"
+#include "libUtils/Uint128.h"
 
 /// Stores IP information on a single Zilliqa peer.
 struct Peer : public Serializable {
@@ -53,6 +55,11 @@ struct Peer : public Serializable {
   /// Less-than comparison operator.
   bool operator<(const Peer& r) const;
 
+  /// Returns the IPv4 address (net-encoded) held in the low 32 bits
+  uint32_t GetIPv4Address() const {
+    return static_cast<uint32_t>(ToNativeUint128(m_ipAddress));
+  }
+
   /// Utility function for printing peer IP info.
   const std::string GetPrintableIPAddress() const;
 
@@ -87,10 +94,9 @@ namespace std {
 template <>
 struct hash<Peer> {
   size_t operator()(const Peer& obj) const {
-    bytes s_peer;
-    obj.Serialize(s_peer, 0);
-    std::string str_peer(s_peer.begin(), s_peer.end());
-    return std::hash<string>()(str_peer);
+    size_t seed = Uint128Hash()(obj.m_ipAddress);
+    boost::hash_combine(seed, obj.m_listenPortHost);
+    return seed;
   }
 };
 }  // namespace std
@@ -20,6 +20,7 @@
 
 #include "Peer.h"
 #include "common/Constants.h"
+#include "libUtils/Uint128.h"
 
 #include <functional>
 #include <mutex>
@@ -27,16 +28,6 @@
 #include <vector>
 
 class ReputationManager {
-  // Custom hasher
-  // Ref:
-  // https://stackoverflow.com/questions/32082786/why-i-cannot-use-neither-stdunordered-map-nor-boostunordered-map-with-boost
-  template <typename T>
-  struct hash_str {
-    size_t operator()(const T& t) const {
-      return std::hash<std::string>()(t.str());
-    }
-  };
-
   ReputationManager();
   ~ReputationManager();
 
@@ -71,7 +62,7 @@ class ReputationManager {
   std::mutex m_mutexReputations;
 
  private:
-  std::unordered_map<uint128_t, int32_t, hash_str<uint128_t>> m_Reputations;
+  std::unordered_map<uint128_t, int32_t> m_Reputations;
 
   void AddNodeIfNotKnownInternal(const uint128_t& IPAddress);
   void SetReputation(const uint128_t& IPAddress, const int32_t ReputationScore);
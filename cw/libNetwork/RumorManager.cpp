@@ -496,7 +496,7 @@ std::pair<bool, RumorManager::RawBytes> RumorManager::RumorReceived(
       auto it2 = m_hashesSubscriberMap.find(message_wo_keysig);
       if (it2 == m_hashesSubscriberMap.end()) {
         m_hashesSubscriberMap.insert(RumorHashesPeersMap::value_type(
-            message_wo_keysig, std::set<Peer>()));
+            message_wo_keysig, std::unordered_set<Peer>()));
       }
       m_hashesSubscriberMap[message_wo_keysig].insert(from);
     }
@@ -19,11 +19,14 @@
 #define __RUMORMANAGER_H__
 
 #include <boost/bimap.hpp>
+#include <boost/bimap/set_of.hpp>
+#include <boost/bimap/unordered_set_of.hpp>
 #include <condition_variable>
 #include <deque>
 #include <map>
 #include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 
 #include "Peer.h"
 #include "ShardStruct.h"
@@ -44,14 +47,18 @@ class RumorManager {
 
  private:
   // TYPES
-  typedef boost::bimap<int, Peer> PeerIdPeerBiMap;
+  typedef boost::bimap<boost::bimaps::unordered_set_of<int>,
+                       boost::bimaps::unordered_set_of<Peer, std::hash<Peer>>>
+      PeerIdPeerBiMap;
   typedef boost::bimap<int, RawBytes> RumorIdRumorBimap;
   typedef boost::bimap<RawBytes, RawBytes> RumorHashRumorBiMap;
-  typedef std::map<RawBytes, std::set<Peer>> RumorHashesPeersMap;
+  typedef std::map<RawBytes, std::unordered_set<Peer>> RumorHashesPeersMap;
   typedef std::deque<std::pair<RumorHashRumorBiMap::iterator,
                                std::chrono::high_resolution_clock::time_point>>
       RumorRawMsgTimestampDeque;
-  typedef boost::bimap<PubKey, Peer> PubKeyPeerBiMap;
+  typedef boost::bimap<boost::bimaps::set_of<PubKey>,
+                       boost::bimaps::unordered_set_of<Peer, std::hash<Peer>>>
+      PubKeyPeerBiMap;
 
   // MEMBERS
   std::shared_ptr<RRS::RumorHolder> m_rumorHolder;
@@ -89,6 +89,16 @@ void Node::StoreDSBlockToDisk(const DSBlock& dsblock) {
   m_mediator.m_blocklinkchain.AddBlockLink(
       latestInd, dsblock.GetHeader().GetBlockNum(), BlockType::DS,
       dsblock.GetBlockHash());
+
+  if (LOOKUP_NODE_MODE) {
+    auto moveToColdStorage =
+        [dsBlockNum = dsblock.GetHeader().GetBlockNum()]() -> void {
+      if (!BlockStorage::GetBlockStorage().MoveToColdStorage(dsBlockNum)) {
+        LOG_GENERAL(WARNING, "BlockStorage::MoveToColdStorage failed");
+      }
+    };
+    DetachedFunction(1, moveToColdStorage);
+  }
 }
 
 void Node::UpdateDSCommiteeComposition(DequeOfNode& dsComm,
@@ -265,7 +275,7 @@ void Node::StartFirstTxEpoch() {
   uint16_t lastBlockHash = 0;
   if (m_mediator.m_currentEpochNum > 1) {
     lastBlockHash = DataConversion::charArrTo16Bits(
-        m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes());
+        m_mediator.m_txBlockChain.GetLastBlockPtr()->GetBlockHash().asBytes());
   }
 
   lock_guard<mutex> g(m_mutexShardMember);
@@ -336,8 +346,13 @@ void Node::ResetConsensusId() {
 }
 
 bool Node::ProcessVCDSBlocksMessage(const bytes& message,
-                                    unsigned int cur_offset,
-                                    [[gnu::unused]] const Peer& from) {
+                                    unsigned int cur_offset, const Peer& from) {
+  return ProcessVCDSBlocksMessage(message, cur_offset, from, nullptr);
+}
+
+bool Node::ProcessVCDSBlocksMessage(const bytes& message,
+                                    unsigned int cur_offset, const Peer& from,
+                                    const DequeOfShard* lookupShards) {
   LOG_MARKER();
 
   unsigned int oldNumShards = m_mediator.m_ds->GetNumShards();
@@ -360,13 +375,64 @@ bool Node::ProcessVCDSBlocksMessage(const bytes& message,
 
   DequeOfShard t_shards;
   uint32_t shardingStructureVersion = 0;
+  bool missingBase = false;
+
+  DequeOfShard prevShards;
+  {
+    lock_guard<mutex> g(m_mediator.m_ds->m_mutexShards);
+    prevShards = m_mediator.m_ds->m_prevShards;
+  }
 
   if (!Messenger::GetNodeVCDSBlocksMessage(
           message, cur_offset, shardId, dsblock, vcBlocks,
-          shardingStructureVersion, t_shards)) {
-    LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
-              "Messenger::GetNodeVCDSBlocksMessage failed.");
-    return false;
+          shardingStructureVersion, t_shards, prevShards, missingBase)) {
+    if (!missingBase) {
+      LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
+                "Messenger::GetNodeVCDSBlocksMessage failed.");
+      return false;
+    }
+
+    // The sharding structure delta is not based on the structure I have, so
+    // get the current structure from a lookup without holding up this
+    // handler, and process the DS block again with it. It is either already
+    // the new structure, or the base of the delta.
+    if (lookupShards == nullptr) {
+      if (m_isFetchingShardStructure.exchange(true)) {
+        LOG_GENERAL(INFO, "Already fetching the sharding structure");
+        return false;
+      }
+
+      auto fetchShardStructure = [this, message, cur_offset, from]() -> void {
+        DequeOfShard shards;
+        if (m_mediator.m_lookup->FetchShardingStructure(shards)) {
+          ProcessVCDSBlocksMessage(message, cur_offset, from, &shards);
+        } else {
+          LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
+                    "Lookup::FetchShardingStructure failed.");
+        }
+        m_isFetchingShardStructure = false;
+      };
+      DetachedFunction(1, fetchShardStructure);
+      return false;
+    }
+
+    ShardingHash lookupShardingHash;
+    if (Messenger::GetShardingStructureHash(
+            SHARDINGSTRUCTURE_VERSION, *lookupShards, lookupShardingHash) &&
+        lookupShardingHash == dsblock.GetHeader().GetShardingHash()) {
+      t_shards = *lookupShards;
+    } else {
+      vcBlocks.clear();
+      t_shards.clear();
+      if (!Messenger::GetNodeVCDSBlocksMessage(
+              message, cur_offset, shardId, dsblock, vcBlocks,
+              shardingStructureVersion, t_shards, *lookupShards,
+              missingBase)) {
+        LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
+                  "Messenger::GetNodeVCDSBlocksMessage failed.");
+        return false;
+      }
+    }
   }
 
   if (shardingStructureVersion != SHARDINGSTRUCTURE_VERSION) {
@@ -437,7 +503,7 @@ bool Node::ProcessVCDSBlocksMessage(const bytes& message,
     LOG_GENERAL(WARNING,
                 "ProcessVCDSBlocksMessage CheckWhetherBlockIsLatest failed");
     if (dsblock.GetHeader().GetBlockNum() >
-        m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() +
+        m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum() +
             1) {
       if (LOOKUP_NODE_MODE && ARCHIVAL_LOOKUP) {
         m_mediator.m_lookup->RejoinAsNewLookup();
@@ -497,7 +563,18 @@ bool Node::ProcessVCDSBlocksMessage(const bytes& message,
     }
   }
 
-  m_mediator.m_ds->m_shards = move(t_shards);
+  // Keep the previous structure as the base of the delta I forward, unless
+  // it is not the one the DS committee used
+  DequeOfShard baseShards;
+  bool forwardDelta = false;
+  {
+    lock_guard<mutex> g(m_mediator.m_ds->m_mutexShards);
+    forwardDelta = !missingBase && m_mediator.m_ds->UseShardingStructureDelta(
+                                       dsblock.GetHeader().GetBlockNum());
+    baseShards = move(m_mediator.m_ds->m_prevShards);
+    m_mediator.m_ds->m_shards = move(t_shards);
+    m_mediator.m_ds->m_prevShards = m_mediator.m_ds->m_shards;
+  }
 
   m_myshardId = shardId;
   if (!BlockStorage::GetBlockStorage().PutShardStructure(
@@ -537,6 +614,7 @@ bool Node::ProcessVCDSBlocksMessage(const bytes& message,
   m_mediator.UpdateDSBlockRand();  // Update the rand1 value for next PoW
   UpdateDSCommiteeComposition(*m_mediator.m_DSCommittee,
                               m_mediator.m_dsBlockChain.GetLastBlock());
+  m_mediator.UpdateCommitteeView();
 
   uint16_t lastBlockHash = 0;
   if (m_mediator.m_currentEpochNum > 1) {
@@ -639,9 +717,17 @@ bool Node::ProcessVCDSBlocksMessage(const bytes& message,
         // excess data beyond the VCDSBlock
         bytes message2 = {MessageType::NODE, NodeInstructionType::DSBLOCK};
 
-        if (!Messenger::SetNodeVCDSBlocksMessage(
-                message2, MessageOffset::BODY, shardId, dsblock, vcBlocks,
-                shardingStructureVersion, m_mediator.m_ds->m_shards)) {
+        bool result;
+        if (forwardDelta) {
+          result = Messenger::SetNodeVCDSBlocksMessage(
+              message2, MessageOffset::BODY, shardId, dsblock, vcBlocks,
+              shardingStructureVersion, m_mediator.m_ds->m_shards, baseShards);
+        } else {
+          result = Messenger::SetNodeVCDSBlocksMessage(
+              message2, MessageOffset::BODY, shardId, dsblock, vcBlocks,
+              shardingStructureVersion, m_mediator.m_ds->m_shards);
+        }
+        if (!result) {
           LOG_GENERAL(WARNING, "Messenger::SetNodeVCDSBlocksMessage failed");
         } else {
           SendDSBlockToOtherShardNodes(message2);
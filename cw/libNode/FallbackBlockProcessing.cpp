@@ -287,6 +287,7 @@ bool Node::ProcessFallbackBlock(const bytes& message, unsigned int cur_offset,
                                      *m_mediator.m_DSCommittee,
                                      m_mediator.m_ds->m_shards);
     }
+    m_mediator.UpdateCommitteeView();
 
     auto writeStateToDisk = [this]() mutable -> void {
       if (!AccountStore::GetInstance().MoveUpdatesToDisk()) {
@@ -302,8 +303,8 @@ bool Node::ProcessFallbackBlock(const bytes& message, unsigned int cur_offset,
       LOG_STATE("[FLBLK][" << setw(15) << left
                            << m_mediator.m_selfPeer.GetPrintableIPAddress()
                            << "]["
-                           << m_mediator.m_txBlockChain.GetLastBlock()
-                                      .GetHeader()
+                           << m_mediator.m_txBlockChain.GetLastBlockPtr()
+                                      ->GetHeader()
                                       .GetBlockNum() +
                                   1
                            << "] FINISH WRITE STATE TO DISK");
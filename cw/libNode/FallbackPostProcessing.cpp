@@ -207,8 +207,8 @@ void Node::ProcessFallbackConsensusWhenDone() {
       LOG_STATE("[FLBLK][" << setw(15) << left
                            << m_mediator.m_selfPeer.GetPrintableIPAddress()
                            << "]["
-                           << m_mediator.m_txBlockChain.GetLastBlock()
-                                      .GetHeader()
+                           << m_mediator.m_txBlockChain.GetLastBlockPtr()
+                                      ->GetHeader()
                                       .GetBlockNum() +
                                   1
                            << "] FINISH WRITE STATE TO DISK");
@@ -228,6 +228,7 @@ void Node::ProcessFallbackConsensusWhenDone() {
   for (unsigned int i = 0; i <= m_myshardId; i++) {
     m_mediator.m_ds->m_shards.pop_front();
   }
+  m_mediator.UpdateCommitteeView();
 
   auto composeFallbackBlockMessageForSender =
       [this](bytes& fallback_message) -> bool {
@@ -238,7 +239,7 @@ void Node::ProcessFallbackConsensusWhenDone() {
     DataSender::GetInstance().SendDataToOthers(
         *m_microblock, *m_myShardMembers, m_mediator.m_ds->m_shards, {},
         m_mediator.m_lookup->GetLookupNodes(),
-        m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash(),
+        m_mediator.m_txBlockChain.GetLastBlockPtr()->GetBlockHash(),
         m_consensusMyID, composeFallbackBlockMessageForSender);
   }
 }
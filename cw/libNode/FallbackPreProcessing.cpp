@@ -489,7 +489,7 @@ bool Node::RunConsensusOnFallbackWhenLeader() {
 
     // Create new consensus object
     m_consensusBlockHash =
-        m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes();
+        m_mediator.m_txBlockChain.GetLastBlockPtr()->GetBlockHash().asBytes();
 
     m_consensusObject.reset(new ConsensusLeader(
         m_mediator.m_consensusID, m_mediator.m_currentEpochNum,
@@ -545,7 +545,7 @@ bool Node::RunConsensusOnFallbackWhenBackup() {
             "I am a fallback backup node. Waiting for Fallback announcement.");
 
   m_consensusBlockHash =
-      m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes();
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetBlockHash().asBytes();
 
   auto func = [this](const bytes& input, unsigned int offset, bytes& errorMsg,
                      const uint32_t consensusID, const uint64_t blockNumber,
@@ -300,7 +300,7 @@ void Node::UpdateStateForNextConsensusRound() {
   m_mediator.m_consensusID++;
 
   uint16_t lastBlockHash = DataConversion::charArrTo16Bits(
-      m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash().asBytes());
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetBlockHash().asBytes());
   {
     lock_guard<mutex> g(m_mutexShardMember);
 
@@ -434,7 +434,7 @@ bool Node::ComposeMBnForwardTxnMessageForSender(bytes& mb_txns_message) {
   }
 
   const auto& blocknum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
 
   {
     const vector<TxnHash>& tx_hashes = m_microblock->GetTranHashes();
@@ -734,8 +734,8 @@ bool Node::ProcessFinalBlockCore(const bytes& message, unsigned int offset,
     auto writeStateToDisk = [this]() -> void {
       if (!AccountStore::GetInstance().MoveUpdatesToDisk(
               LOOKUP_NODE_MODE && ENABLE_REPOPULATE &&
-              (m_mediator.m_dsBlockChain.GetLastBlock()
-                       .GetHeader()
+              (m_mediator.m_dsBlockChain.GetLastBlockPtr()
+                       ->GetHeader()
                        .GetBlockNum() %
                    REPOPULATE_STATE_PER_N_DS ==
                REPOPULATE_STATE_IN_DS))) {
@@ -760,8 +760,8 @@ bool Node::ProcessFinalBlockCore(const bytes& message, unsigned int offset,
           // change if all microblock received from shards
           lock_guard<mutex> g(m_mutexUnavailableMicroBlocks);
           if (m_unavailableMicroBlocks.find(
-                  m_mediator.m_txBlockChain.GetLastBlock()
-                      .GetHeader()
+                  m_mediator.m_txBlockChain.GetLastBlockPtr()
+                      ->GetHeader()
                       .GetBlockNum()) == m_unavailableMicroBlocks.end()) {
             if (!BlockStorage::GetBlockStorage().PutMetadata(
                     MetaType::DSINCOMPLETED, {'0'})) {
@@ -773,8 +773,8 @@ bool Node::ProcessFinalBlockCore(const bytes& message, unsigned int offset,
         LOG_STATE("[FLBLK][" << setw(15) << left
                              << m_mediator.m_selfPeer.GetPrintableIPAddress()
                              << "]["
-                             << m_mediator.m_txBlockChain.GetLastBlock()
-                                        .GetHeader()
+                             << m_mediator.m_txBlockChain.GetLastBlockPtr()
+                                        ->GetHeader()
                                         .GetBlockNum() +
                                     1
                              << "] FINISH WRITE STATE TO DISK");
@@ -887,21 +887,42 @@ bool Node::ProcessStateDeltaFromFinalBlock(
 void Node::CommitForwardedTransactions(const MBnForwardedTxnEntry& entry) {
   LOG_MARKER();
 
-  for (const auto& twr : entry.m_transactions) {
+  // Reuse the bytes the txns arrived in, unless the entry was not decoded
+  // from the wire
+  const bool hasWireBytes =
+      entry.m_serializedTransactions.size() == entry.m_transactions.size();
+  vector<bytes> serializedTxBodies;
+  if (!hasWireBytes) {
+    serializedTxBodies.resize(entry.m_transactions.size());
+  }
+
+  vector<pair<dev::h256, dev::bytesConstRef>> txBodies;
+  txBodies.reserve(entry.m_transactions.size());
+
+  for (unsigned int i = 0; i < entry.m_transactions.size(); i++) {
+    const auto& twr = entry.m_transactions.at(i);
+
     if (LOOKUP_NODE_MODE) {
       LookupServer::AddToRecentTransactions(twr.GetTransaction().GetTranID());
     }
 
-    // Store TxBody to disk
-    bytes serializedTxBody;
-    twr.Serialize(serializedTxBody, 0);
-    if (!BlockStorage::GetBlockStorage().PutTxBody(
-            twr.GetTransaction().GetTranID(), serializedTxBody)) {
-      LOG_GENERAL(WARNING, "BlockStorage::PutTxBody failed "
-                               << twr.GetTransaction().GetTranID());
-      return;
+    if (hasWireBytes) {
+      txBodies.emplace_back(
+          twr.GetTransaction().GetTranID(),
+          dev::bytesConstRef(&entry.m_serializedTransactions.at(i)));
+    } else {
+      twr.Serialize(serializedTxBodies.at(i), 0);
+      txBodies.emplace_back(twr.GetTransaction().GetTranID(),
+                            dev::bytesConstRef(&serializedTxBodies.at(i)));
     }
   }
+
+  // Store TxBodies to disk
+  if (!BlockStorage::GetBlockStorage().PutTxBodies(txBodies)) {
+    LOG_GENERAL(WARNING, "BlockStorage::PutTxBodies failed for microblock "
+                             << entry.m_microBlock.GetBlockHash());
+    return;
+  }
   LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
             "Proceessed " << entry.m_transactions.size() << " of txns.");
 }
@@ -1013,7 +1034,7 @@ bool Node::ProcessMBnForwardTransaction(const bytes& message,
       << entry.m_microBlock.GetHeader().GetEpochNum() << " shard "
       << entry.m_microBlock.GetHeader().GetShardId());
 
-  if (m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() <
+  if (m_mediator.m_txBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum() <
       entry.m_microBlock.GetHeader().GetEpochNum()) {
     lock_guard<mutex> g(m_mutexMBnForwardedTxnBuffer);
     m_mbnForwardedTxnBuffer[entry.m_microBlock.GetHeader().GetEpochNum()]
@@ -1057,8 +1078,8 @@ bool Node::ProcessMBnForwardTransactionCore(const MBnForwardedTxnEntry& entry) {
 
       if (LOOKUP_NODE_MODE && m_isVacuousEpochBuffer &&
           entry.m_microBlock.GetHeader().GetEpochNum() ==
-              m_mediator.m_txBlockChain.GetLastBlock()
-                  .GetHeader()
+              m_mediator.m_txBlockChain.GetLastBlockPtr()
+                  ->GetHeader()
                   .GetBlockNum()) {
         // change if states was moved to disk
         uint64_t epochNum;
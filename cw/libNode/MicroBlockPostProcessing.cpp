@@ -278,7 +278,7 @@ bool Node::ProcessMicroBlockConsensusCore(const bytes& message,
       DataSender::GetInstance().SendDataToOthers(
           *m_microblock, *m_myShardMembers, ds_shards, t_blocks,
           m_mediator.m_lookup->GetLookupNodes(),
-          m_mediator.m_txBlockChain.GetLastBlock().GetBlockHash(),
+          m_mediator.m_txBlockChain.GetLastBlockPtr()->GetBlockHash(),
           m_consensusMyID, composeMicroBlockMessageForSender, false, nullptr);
     }
 
@@ -19,6 +19,7 @@
 #include <chrono>
 #include <functional>
 #include <thread>
+#include <unordered_set>
 
 #include "Node.h"
 #include "common/Constants.h"
@@ -40,6 +41,7 @@
 #include "libUtils/BitVector.h"
 #include "libUtils/DataConversion.h"
 #include "libUtils/DetachedFunction.h"
+#include "libUtils/JoinableFunction.h"
 #include "libUtils/Logger.h"
 #include "libUtils/RootComputation.h"
 #include "libUtils/SanityChecks.h"
@@ -51,6 +53,17 @@ using namespace std;
 using namespace boost::multiprecision;
 using namespace boost::multi_index;
 
+namespace {
+/// Short ID of a txn in mempool summaries, taken from the start of its hash
+uint64_t GetShortTxnId(const TxnHash& txnHash) {
+  uint64_t shortTxnId = 0;
+  for (unsigned int i = 0; i < sizeof(uint64_t); i++) {
+    shortTxnId = (shortTxnId << 8) | txnHash.asArray().at(i);
+  }
+  return shortTxnId;
+}
+}  // namespace
+
 bool Node::ComposeMicroBlock() {
   if (LOOKUP_NODE_MODE) {
     LOG_GENERAL(WARNING,
@@ -77,7 +90,7 @@ bool Node::ComposeMicroBlock() {
     rewards = m_txnFees;
   }
   BlockHash prevHash =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetMyHash();
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetHeader().GetMyHash();
 
   TxnHash txRootHash, txReceiptHash;
   uint32_t numTxs = 0;
@@ -217,6 +230,156 @@ bool Node::OnNodeMissingTxns(const bytes& errorMsg, const unsigned int offset,
   return true;
 }
 
+bool Node::ProcessMempoolSummary(const bytes& message, unsigned int offset,
+                                 const Peer& from) {
+  LOG_MARKER();
+
+  if (LOOKUP_NODE_MODE) {
+    LOG_GENERAL(WARNING,
+                "Node::ProcessMempoolSummary not expected to be called from "
+                "LookUp node");
+    return true;
+  }
+
+  uint64_t epochNum = 0;
+  uint32_t portNo = 0;
+  vector<uint64_t> shortTxnIds;
+
+  if (!Messenger::GetNodeMempoolSummary(message, offset, epochNum, portNo,
+                                        shortTxnIds)) {
+    LOG_GENERAL(WARNING, "Messenger::GetNodeMempoolSummary failed");
+    return false;
+  }
+
+  if (epochNum != m_mediator.m_currentEpochNum) {
+    LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
+              "untimely delivery of mempool summary. received: "
+                  << epochNum << " , local: " << m_mediator.m_currentEpochNum);
+    return false;
+  }
+
+  if (!m_isPrimary || m_mediator.m_ds->m_mode != DirectoryService::IDLE ||
+      m_state != MICROBLOCK_CONSENSUS_PREP || !m_txn_distribute_window_open) {
+    LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
+              "Not a shard leader collecting txns, ignore mempool summary");
+    return false;
+  }
+
+  Peer peer(from.m_ipAddress, portNo);
+
+  PubKey senderPubKey;
+  uint32_t senderShardId = 0;
+  const auto committeeView = m_mediator.GetCommitteeView();
+  if (!committeeView->GetPubKey(peer, senderPubKey) ||
+      !committeeView->GetShardId(senderPubKey, senderShardId) ||
+      senderShardId != m_myshardId) {
+    LOG_GENERAL(WARNING, "Mempool summary not from my shard: " << peer);
+    return false;
+  }
+
+  // Each backup is answered at most once per epoch
+  {
+    lock_guard<mutex> g(m_mutexMempoolSummary);
+    if (m_mempoolSummaryEpoch != epochNum) {
+      m_mempoolSummaryEpoch = epochNum;
+      m_mempoolSummarySenders.clear();
+    }
+    if (!m_mempoolSummarySenders.emplace(senderPubKey).second) {
+      LOG_GENERAL(WARNING, "Already answered mempool summary from " << peer);
+      return false;
+    }
+  }
+
+  unordered_set<uint64_t> heldTxnIds(shortTxnIds.begin(), shortTxnIds.end());
+
+  // Txns left out by the size cap go through the missing-txn round
+  std::vector<Transaction> txns;
+  uint64_t txnsSize = 0;
+  {
+    lock_guard<mutex> g(m_mutexCreatedTransactions);
+    for (const auto& entry : m_createdTxns.HashIndex) {
+      if (heldTxnIds.find(GetShortTxnId(entry.first)) != heldTxnIds.end()) {
+        continue;
+      }
+      bytes encodedTxn;
+      if (!Messenger::SetTransaction(encodedTxn, 0, entry.second)) {
+        LOG_GENERAL(WARNING, "Messenger::SetTransaction failed");
+        continue;
+      }
+      if (txnsSize + encodedTxn.size() > TXN_PREFETCH_MAX_REPLY_SIZE_IN_BYTES) {
+        break;
+      }
+      txnsSize += encodedTxn.size();
+      txns.emplace_back(entry.second);
+    }
+  }
+
+  unsigned int cur_offset = 0;
+  bytes tx_message = {MessageType::NODE,
+                      NodeInstructionType::SUBMITTRANSACTION};
+  cur_offset += MessageOffset::BODY;
+  tx_message.push_back(SUBMITTRANSACTIONTYPE::PREFETCHTXN);
+  cur_offset += MessageOffset::INST;
+  Serializable::SetNumber<uint64_t>(tx_message, cur_offset, epochNum,
+                                    sizeof(uint64_t));
+  cur_offset += sizeof(uint64_t);
+
+  if (!Messenger::SetTransactionArray(tx_message, cur_offset, txns)) {
+    LOG_GENERAL(WARNING, "Messenger::SetTransactionArray failed");
+    return false;
+  }
+
+  LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
+            "Pushing " << txns.size() << " txns to " << peer);
+
+  // Reply even if nothing is missing, so the backup can stop waiting
+  P2PComm::GetInstance().SendMessage(peer, tx_message);
+
+  return true;
+}
+
+void Node::PrefetchTxnsFromShardLeader() {
+  LOG_MARKER();
+
+  vector<uint64_t> shortTxnIds;
+  {
+    lock_guard<mutex> g(m_mutexCreatedTransactions);
+    shortTxnIds.reserve(m_createdTxns.HashIndex.size());
+    for (const auto& entry : m_createdTxns.HashIndex) {
+      shortTxnIds.emplace_back(GetShortTxnId(entry.first));
+    }
+  }
+
+  bytes summary = {MessageType::NODE, NodeInstructionType::MEMPOOLSUMMARY};
+
+  if (!Messenger::SetNodeMempoolSummary(
+          summary, MessageOffset::BODY, m_mediator.m_currentEpochNum,
+          m_mediator.m_selfPeer.m_listenPortHost, shortTxnIds)) {
+    LOG_GENERAL(WARNING, "Messenger::SetNodeMempoolSummary failed");
+    return;
+  }
+
+  Peer leader;
+  {
+    lock_guard<mutex> g(m_mutexShardMember);
+    leader = (*m_myShardMembers)[m_consensusLeaderID].second;
+  }
+
+  P2PComm::GetInstance().SendMessage(leader, summary);
+
+  unique_lock<mutex> lock(m_mutexCVTxnPrefetch);
+  if (!cv_TxnPrefetch.wait_for(
+          lock,
+          chrono::milliseconds(
+              min(TXN_PREFETCH_TIMEOUT_IN_MS, ANNOUNCEMENT_DELAY_IN_MS)),
+          [this] {
+            return m_txnPrefetchEpoch == m_mediator.m_currentEpochNum;
+          })) {
+    LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
+              "Timeout waiting for prefetched txns from shard leader");
+  }
+}
+
 bool Node::OnCommitFailure([
     [gnu::unused]] const std::map<unsigned int, bytes>& commitFailureMap) {
   if (LOOKUP_NODE_MODE) {
@@ -491,6 +654,7 @@ void Node::UpdateProcessedTransactions() {
     m_processedTransactions[m_mediator.m_currentEpochNum] =
         std::move(t_processedTransactions);
     t_processedTransactions.clear();
+    m_expectedTranReceiptHash = TxnHash();
   }
 }
 
@@ -505,6 +669,7 @@ void Node::ProcessTransactionWhenShardBackup() {
 
   t_createdTxns = m_createdTxns;
   m_expectedTranOrdering.clear();
+  m_expectedTranReceiptHash = TxnHash();
   map<Address, map<uint64_t, Transaction>> t_addrNonceTxnMap;
   t_processedTransactions.clear();
 
@@ -538,8 +703,14 @@ void Node::ProcessTransactionWhenShardBackup() {
     return false;
   };
 
-  auto appendOne = [this](const Transaction& t, const TransactionReceipt& tr) {
+  // Hash the receipts as they are produced, so that validating the leader's
+  // microblock does not have to if it proposes the same order
+  SHA2<HASH_TYPE::HASH_VARIANT_256> receiptsSha2;
+
+  auto appendOne = [this, &receiptsSha2](const Transaction& t,
+                                         const TransactionReceipt& tr) {
     m_expectedTranOrdering.emplace_back(t.GetTranID());
+    receiptsSha2.Update(DataConversion::StringToCharArray(tr.GetString()));
     t_processedTransactions.insert(
         make_pair(t.GetTranID(), TransactionWithReceipt(t, tr)));
   };
@@ -639,6 +810,10 @@ void Node::ProcessTransactionWhenShardBackup() {
     }
   }
 
+  if (!m_expectedTranOrdering.empty()) {
+    m_expectedTranReceiptHash = TxnHash(receiptsSha2.Finalize());
+  }
+
   cv_TxnProcFinished.notify_all();
 
   ReinstateMemPool(t_addrNonceTxnMap, gasLimitExceededTxnBuffer);
@@ -719,10 +894,10 @@ bool Node::RunConsensusOnMicroBlockWhenShardLeader() {
   if (!m_mediator.GetIsVacuousEpoch() &&
       ((m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDifficulty() >=
             TXN_SHARD_TARGET_DIFFICULTY &&
-        m_mediator.m_dsBlockChain.GetLastBlock()
-                .GetHeader()
+        m_mediator.m_dsBlockChain.GetLastBlockPtr()
+                ->GetHeader()
                 .GetDSDifficulty() >= TXN_DS_TARGET_DIFFICULTY) ||
-       m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() >=
+       m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum() >=
            TXN_DS_TARGET_NUM)) {
     ProcessTransactionWhenShardLeader();
     if (!AccountStore::GetInstance().SerializeDelta()) {
@@ -738,8 +913,8 @@ bool Node::RunConsensusOnMicroBlockWhenShardLeader() {
   }
 
   // m_consensusID = 0;
-  m_consensusBlockHash = m_mediator.m_txBlockChain.GetLastBlock()
-                             .GetHeader()
+  m_consensusBlockHash = m_mediator.m_txBlockChain.GetLastBlockPtr()
+                             ->GetHeader()
                              .GetMyHash()
                              .asBytes();
 
@@ -816,12 +991,13 @@ bool Node::RunConsensusOnMicroBlockWhenShardBackup() {
       !m_mediator.GetIsVacuousEpoch() &&
       ((m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDifficulty() >=
             TXN_SHARD_TARGET_DIFFICULTY &&
-        m_mediator.m_dsBlockChain.GetLastBlock()
-                .GetHeader()
+        m_mediator.m_dsBlockChain.GetLastBlockPtr()
+                ->GetHeader()
                 .GetDSDifficulty() >= TXN_DS_TARGET_DIFFICULTY) ||
-       m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() >=
+       m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum() >=
            TXN_DS_TARGET_NUM)) {
     std::this_thread::sleep_for(chrono::milliseconds(TX_DISTRIBUTE_TIME_IN_MS));
+    PrefetchTxnsFromShardLeader();
     ProcessTransactionWhenShardBackup();
   }
 
@@ -829,8 +1005,8 @@ bool Node::RunConsensusOnMicroBlockWhenShardBackup() {
             "I am a backup node. Waiting for microblock announcement for epoch "
                 << m_mediator.m_currentEpochNum);
   // m_consensusID = 0;
-  m_consensusBlockHash = m_mediator.m_txBlockChain.GetLastBlock()
-                             .GetHeader()
+  m_consensusBlockHash = m_mediator.m_txBlockChain.GetLastBlockPtr()
+                             ->GetHeader()
                              .GetMyHash()
                              .asBytes();
 
@@ -1008,10 +1184,10 @@ unsigned char Node::CheckLegitimacyOfTxnHashes(bytes& errorMsg) {
   if (!m_mediator.GetIsVacuousEpoch() &&
       ((m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDifficulty() >=
             TXN_SHARD_TARGET_DIFFICULTY &&
-        m_mediator.m_dsBlockChain.GetLastBlock()
-                .GetHeader()
+        m_mediator.m_dsBlockChain.GetLastBlockPtr()
+                ->GetHeader()
                 .GetDSDifficulty() >= TXN_DS_TARGET_DIFFICULTY) ||
-       m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum() >=
+       m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum() >=
            TXN_DS_TARGET_NUM)) {
     vector<TxnHash> missingTxnHashes;
     if (!VerifyTxnsOrdering(m_microblock->GetTranHashes(), missingTxnHashes)) {
@@ -1143,7 +1319,7 @@ bool Node::CheckMicroBlockHashes(bytes& errorMsg) {
   return true;
 }
 
-bool Node::CheckMicroBlockTxnRootHash() {
+bool Node::CheckMicroBlockTxnRootHash(const TxnHash& expectedTxRootHash) {
   if (LOOKUP_NODE_MODE) {
     LOG_GENERAL(WARNING,
                 "Node::CheckMicroBlockTxnRootHash not expected to be "
@@ -1152,8 +1328,6 @@ bool Node::CheckMicroBlockTxnRootHash() {
   }
 
   // Check transaction root
-  TxnHash expectedTxRootHash = ComputeRoot(m_microblock->GetTranHashes());
-
   if (expectedTxRootHash != m_microblock->GetHeader().GetTxRootHash()) {
     LOG_CHECK_FAIL("Txn root hash", m_microblock->GetHeader().GetTxRootHash(),
                    expectedTxRootHash);
@@ -1196,15 +1370,7 @@ bool Node::CheckMicroBlockStateDeltaHash() {
   return true;
 }
 
-bool Node::CheckMicroBlockTranReceiptHash() {
-  TxnHash expectedTranHash;
-  if (!TransactionWithReceipt::ComputeTransactionReceiptsHash(
-          m_microblock->GetTranHashes(), t_processedTransactions,
-          expectedTranHash)) {
-    LOG_GENERAL(WARNING, "Cannot compute transaction receipts hash");
-    return false;
-  }
-
+bool Node::CheckMicroBlockTranReceiptHash(const TxnHash& expectedTranHash) {
   if (expectedTranHash != m_microblock->GetHeader().GetTranReceiptHash()) {
     LOG_CHECK_FAIL("Txn receipt hash",
                    m_microblock->GetHeader().GetTranReceiptHash(),
@@ -1231,10 +1397,48 @@ bool Node::CheckMicroBlockValidity(bytes& errorMsg) {
 
   LOG_MARKER();
 
-  return CheckMicroBlockVersion() && CheckMicroBlockshardId() &&
-         CheckMicroBlockTimestamp() && CheckMicroBlockHashes(errorMsg) &&
-         CheckMicroBlockTxnRootHash() && CheckMicroBlockStateDeltaHash() &&
-         CheckMicroBlockTranReceiptHash();
+  if (!CheckMicroBlockVersion() || !CheckMicroBlockshardId() ||
+      !CheckMicroBlockTimestamp()) {
+    return false;
+  }
+
+  // Compute the txn root and receipts hash of the proposed txns while the
+  // txn hashes are checked against my own txns. The receipts hash computed
+  // while processing the txns is reused if the leader proposed my order.
+  const vector<TxnHash>& tranHashes = m_microblock->GetTranHashes();
+  TxnHash expectedTxRootHash;
+  TxnHash expectedTranHash;
+  bool tranHashComputed = false;
+
+  auto computeHashes = [this, &tranHashes, &expectedTxRootHash,
+                        &expectedTranHash, &tranHashComputed]() -> void {
+    expectedTxRootHash = ComputeRoot(tranHashes);
+
+    if (m_expectedTranReceiptHash != TxnHash() &&
+        tranHashes == m_expectedTranOrdering) {
+      expectedTranHash = m_expectedTranReceiptHash;
+      tranHashComputed = true;
+    } else {
+      tranHashComputed = TransactionWithReceipt::ComputeTransactionReceiptsHash(
+          tranHashes, t_processedTransactions, expectedTranHash);
+    }
+  };
+
+  JoinableFunction hashComputation(1, computeHashes);
+  const bool hashesValid = CheckMicroBlockHashes(errorMsg);
+  hashComputation.join();
+
+  if (!hashesValid || !CheckMicroBlockTxnRootHash(expectedTxRootHash) ||
+      !CheckMicroBlockStateDeltaHash()) {
+    return false;
+  }
+
+  if (!tranHashComputed) {
+    LOG_GENERAL(WARNING, "Cannot compute transaction receipts hash");
+    return false;
+  }
+
+  return CheckMicroBlockTranReceiptHash(expectedTranHash);
 
   // Check gas limit (must satisfy some equations)
   // Check gas used (must be <= gas limit)
@@ -172,8 +172,8 @@ bool Node::Install(const SyncType syncType, const bool toRetrieveHistory,
       return true;
     }
 
-    m_mediator.m_currentEpochNum =
-        m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+    m_mediator.SetEpochNum(
+        m_mediator.m_txBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum());
     m_mediator.IncreaseEpochNum();
 
     if (RECOVERY_TRIM_INCOMPLETED_BLOCK) {
@@ -268,6 +268,7 @@ void Node::Init() {
     std::lock_guard<mutex> lock(m_mediator.m_mutexDSCommittee);
     m_mediator.m_DSCommittee->clear();
   }
+  m_mediator.UpdateCommitteeView();
   // m_committedTransactions.clear();
   AccountStore::GetInstance().Init();
 
@@ -464,8 +465,8 @@ bool Node::ValidateDB() {
 
 void Node::Prepare(bool runInitializeGenesisBlocks) {
   LOG_MARKER();
-  m_mediator.m_currentEpochNum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1;
+  m_mediator.SetEpochNum(
+      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() + 1);
   m_mediator.UpdateDSBlockRand(runInitializeGenesisBlocks);
   m_mediator.UpdateTxBlockRand(runInitializeGenesisBlocks);
   SetState(POW_SUBMISSION);
@@ -643,7 +644,7 @@ bool Node::StartRetrieveHistory(const SyncType syncType,
   if (!LOOKUP_NODE_MODE &&
       SyncType::NO_SYNC == m_mediator.m_lookup->GetSyncType() &&
       SyncType::RECOVERY_ALL_SYNC != syncType &&
-      (m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() <
+      (m_mediator.m_txBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum() <
            NUM_FINAL_BLOCK_PER_POW ||
        m_mediator.GetIsVacuousEpoch(
            m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum() +
@@ -660,16 +661,16 @@ bool Node::StartRetrieveHistory(const SyncType syncType,
     for (uint64_t blockNum =
              m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetEpochNum();
          blockNum <=
-         m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+         m_mediator.m_txBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
          ++blockNum) {
       LOG_GENERAL(INFO, "Update coin base for finalblock with blockNum: "
                             << blockNum << ", reward: "
-                            << m_mediator.m_txBlockChain.GetBlock(blockNum)
-                                   .GetHeader()
+                            << m_mediator.m_txBlockChain.GetBlockPtr(blockNum)
+                                   ->GetHeader()
                                    .GetRewards());
       m_mediator.m_ds->SaveCoinbase(
-          m_mediator.m_txBlockChain.GetBlock(blockNum).GetB1(),
-          m_mediator.m_txBlockChain.GetBlock(blockNum).GetB2(),
+          m_mediator.m_txBlockChain.GetBlockPtr(blockNum)->GetB1(),
+          m_mediator.m_txBlockChain.GetBlockPtr(blockNum)->GetB2(),
           CoinbaseReward::FINALBLOCK_REWARD, blockNum + 1);
       m_mediator.m_ds->m_totalTxnFees +=
           m_mediator.m_txBlockChain.GetBlock(blockNum).GetHeader().GetRewards();
@@ -727,6 +728,8 @@ bool Node::StartRetrieveHistory(const SyncType syncType,
         m_mediator.m_ds->m_mapNodeReputation);
   }
 
+  m_mediator.UpdateCommitteeView();
+
   if (REJOIN_NODE_NOT_IN_NETWORK && !LOOKUP_NODE_MODE && !bDS &&
       !bInShardStructure) {
     LOG_GENERAL(WARNING,
@@ -810,8 +813,8 @@ void Node::WakeupAtDSEpoch() {
   if (DirectoryService::IDLE != m_mediator.m_ds->m_mode) {
     SetState(POW_SUBMISSION);
     LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
-              "START OF EPOCH " << m_mediator.m_dsBlockChain.GetLastBlock()
-                                           .GetHeader()
+              "START OF EPOCH " << m_mediator.m_dsBlockChain.GetLastBlockPtr()
+                                           ->GetHeader()
                                            .GetBlockNum() +
                                        1);
     if (BROADCAST_GOSSIP_MODE) {
@@ -870,7 +873,7 @@ void Node::WakeupAtDSEpoch() {
   uint8_t dsDifficulty =
       m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDSDifficulty();
   uint8_t difficulty =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDifficulty();
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetDifficulty();
   SetState(POW_SUBMISSION);
 
   auto func = [this, block_num, dsDifficulty, difficulty]() mutable -> void {
@@ -1187,6 +1190,86 @@ bool Node::ProcessSubmitMissingTxn(const bytes& message, unsigned int offset,
   return true;
 }
 
+bool Node::ProcessSubmitPrefetchTxn(const bytes& message, unsigned int offset,
+                                    const Peer& from) {
+  if (offset >= message.size()) {
+    LOG_GENERAL(WARNING, "Invalid txn message, message size: "
+                             << message.size()
+                             << ", txn data offset: " << offset);
+    return false;
+  }
+
+  unsigned int cur_offset = offset;
+
+  auto msgBlockNum =
+      Serializable::GetNumber<uint64_t>(message, offset, sizeof(uint64_t));
+  cur_offset += sizeof(uint64_t);
+
+  if (msgBlockNum != m_mediator.m_currentEpochNum) {
+    LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
+              "untimely delivery of prefetched txns. received: "
+                  << msgBlockNum << " , local: "
+                  << m_mediator.m_currentEpochNum);
+    return false;
+  }
+
+  // Only the shard leader answers mempool summaries
+  Peer leader;
+  {
+    lock_guard<mutex> g(m_mutexShardMember);
+    if (m_consensusLeaderID >= m_myShardMembers->size()) {
+      return false;
+    }
+    leader = (*m_myShardMembers)[m_consensusLeaderID].second;
+  }
+  if (leader.GetIpAddress() != from.GetIpAddress()) {
+    LOG_GENERAL(WARNING, "Prefetched txns not from shard leader: " << from);
+    return false;
+  }
+
+  {
+    lock_guard<mutex> g(m_mutexCVTxnPrefetch);
+    if (m_txnPrefetchEpoch == msgBlockNum) {
+      LOG_GENERAL(INFO, "Already got prefetched txns for this epoch");
+      return false;
+    }
+  }
+
+  std::vector<Transaction> txns;
+  if (!Messenger::GetTransactionArray(message, cur_offset, txns)) {
+    LOG_GENERAL(WARNING, "Messenger::GetTransactionArray failed.");
+    return false;
+  }
+
+  std::vector<Transaction> checkedTxns;
+  for (const auto& txn : txns) {
+    if (m_mediator.m_validator->CheckCreatedTransactionFromLookup(txn)) {
+      checkedTxns.push_back(txn);
+    } else {
+      LOG_GENERAL(WARNING, "Prefetched txn is not valid.");
+    }
+  }
+
+  LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
+            "Prefetched " << checkedTxns.size() << " of " << txns.size()
+                          << " txns from shard leader");
+
+  {
+    lock_guard<mutex> g(m_mutexCreatedTransactions);
+    for (const auto& txn : checkedTxns) {
+      m_createdTxns.insert(txn);
+    }
+  }
+
+  {
+    lock_guard<mutex> g(m_mutexCVTxnPrefetch);
+    m_txnPrefetchEpoch = msgBlockNum;
+  }
+  cv_TxnPrefetch.notify_all();
+
+  return true;
+}
+
 bool Node::ProcessSubmitTransaction(const bytes& message, unsigned int offset,
                                     [[gnu::unused]] const Peer& from) {
   if (LOOKUP_NODE_MODE) {
@@ -1223,6 +1306,16 @@ bool Node::ProcessSubmitTransaction(const bytes& message, unsigned int offset,
     }
 
     ProcessSubmitMissingTxn(message, cur_offset, from);
+  } else if (submitTxnType == SUBMITTRANSACTIONTYPE::PREFETCHTXN) {
+    if (m_mediator.m_ds->m_mode != DirectoryService::IDLE ||
+        m_state != MICROBLOCK_CONSENSUS_PREP) {
+      LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
+                "As a shard node not collecting txns: don't want prefetched "
+                "txns");
+      return false;
+    }
+
+    ProcessSubmitPrefetchTxn(message, cur_offset, from);
   }
   return true;
 }
@@ -1322,15 +1415,15 @@ bool Node::ProcessTxnPacketFromLookup([[gnu::unused]] const bytes& message,
        (m_state == MICROBLOCK_CONSENSUS_PREP ||
         m_state == MICROBLOCK_CONSENSUS));
 
-  if (isLookup || !properState) {
+  // Lookups stream packets throughout the epoch, so packets received in the
+  // prepared state are admitted right away whether from lookup or gossip
+  if (!properState) {
     if ((epochNumber + (isLookup ? 0 : 1)) < m_mediator.m_currentEpochNum) {
       LOG_GENERAL(WARNING, "Txn packet from older epoch, discard");
       return false;
     }
     lock_guard<mutex> g(m_mutexTxnPacketBuffer);
-    LOG_GENERAL(INFO, string(isLookup ? "Received txn from lookup"
-                                      : "Received not in the prepared state") +
-                          ", store to buffer");
+    LOG_GENERAL(INFO, "Received not in the prepared state, store to buffer");
     LOG_STATE("[TXNPKTPROC]["
               << std::setw(15) << std::left
               << m_mediator.m_selfPeer.GetPrintableIPAddress() << "]["
@@ -1339,9 +1432,9 @@ bool Node::ProcessTxnPacketFromLookup([[gnu::unused]] const bytes& message,
               << "] RECVFROMLOOKUP");
     m_txnPacketBuffer.emplace_back(message2);
   } else {
-    LOG_GENERAL(INFO,
-                "Packet received from a non-lookup node, "
-                "should be from gossip neighbor and process it");
+    LOG_GENERAL(INFO, "Packet received from "
+                          << (isLookup ? "lookup" : "gossip neighbor")
+                          << ", process it");
     return ProcessTxnPacketFromLookupCore(message2, epochNumber, dsBlockNum,
                                           shardId, lookupPubKey, transactions);
   }
@@ -1377,11 +1470,11 @@ bool Node::ProcessTxnPacketFromLookupCore(const bytes& message,
   }
 
   if (dsBlockNum !=
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum()) {
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum()) {
     LOG_GENERAL(WARNING, "Wrong DS block num ("
                              << dsBlockNum << "), expected ("
-                             << m_mediator.m_dsBlockChain.GetLastBlock()
-                                    .GetHeader()
+                             << m_mediator.m_dsBlockChain.GetLastBlockPtr()
+                                    ->GetHeader()
                                     .GetBlockNum()
                              << ")");
     return false;
@@ -1783,6 +1876,7 @@ void Node::CleanCreatedTransaction() {
     std::lock_guard<mutex> lock(m_mutexProcessedTransactions);
     m_processedTransactions.clear();
     t_processedTransactions.clear();
+    m_expectedTranReceiptHash = TxnHash();
   }
   {
     std::unique_lock<shared_timed_mutex> lock(m_unconfirmedTxnsMutex);
@@ -1876,7 +1970,7 @@ void Node::QueryLookupForDSGuardNetworkInfoUpdate() {
       MessageType::LOOKUP,
       LookupInstructionType::GETGUARDNODENETWORKINFOUPDATE};
   uint64_t dsEpochNum =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
 
   LOG_GENERAL(INFO,
               "Querying the lookup for any ds guard node network info change "
@@ -1985,6 +2079,8 @@ bool Node::ProcessDSGuardNetworkInfoUpdate(const bytes& message,
     }
   }
 
+  m_mediator.UpdateCommitteeView();
+
   m_requestedForDSGuardNetworkInfoUpdate = false;
   return true;
 }
@@ -2124,6 +2220,7 @@ bool Node::Execute(const bytes& message, unsigned int offset,
       &Node::ProcessFallbackBlock,
       &Node::ProcessProposeGasPrice,
       &Node::ProcessDSGuardNetworkInfoUpdate,
+      &Node::ProcessMempoolSummary,
   };
 
   const unsigned char ins_byte = message.at(offset);
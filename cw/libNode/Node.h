@@ -17,6 +17,7 @@
 #ifndef __NODE_H__
 #define __NODE_H__
 
+#include <atomic>
 #include <condition_variable>
 #include <deque>
 #include <list>
@@ -24,6 +25,7 @@
 #include <mutex>
 #include <shared_mutex>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "common/Constants.h"
@@ -57,7 +59,10 @@ class Node : public Executable {
     NUM_ACTIONS
   };
 
-  enum SUBMITTRANSACTIONTYPE : unsigned char { MISSINGTXN = 0x01 };
+  enum SUBMITTRANSACTIONTYPE : unsigned char {
+    MISSINGTXN = 0x01,
+    PREFETCHTXN = 0x02
+  };
 
   enum REJOINTYPE : unsigned char {
     ATFINALBLOCK = 0x00,
@@ -127,6 +132,9 @@ class Node : public Executable {
   std::unordered_map<TxnHash, PoolTxnStatus> m_unconfirmedTxns;
 
   std::vector<TxnHash> m_expectedTranOrdering;
+  // Receipts hash of m_expectedTranOrdering, computed while processing the
+  // txns as a shard backup. Reset once t_processedTransactions is cleared.
+  TxnHash m_expectedTranReceiptHash;
   std::mutex m_mutexProcessedTransactions;
   std::unordered_map<uint64_t,
                      std::unordered_map<TxnHash, TransactionWithReceipt>>
@@ -187,6 +195,8 @@ class Node : public Executable {
                                         std::array<unsigned char, 32>& rand2);
   bool ProcessSubmitMissingTxn(const bytes& message, unsigned int offset,
                                const Peer& from);
+  bool ProcessSubmitPrefetchTxn(const bytes& message, unsigned int offset,
+                                const Peer& from);
 
   bool FindTxnInProcessedTxnsList(
       const uint64_t& blockNum, uint8_t sharing_mode,
@@ -225,6 +235,7 @@ class Node : public Executable {
       const std::vector<Transaction>& gasLimitExceededTxnBuffer);
 
   // internal calls from ProcessVCDSBlocksMessage
+  std::atomic<bool> m_isFetchingShardStructure{false};
   void LogReceivedDSBlockDetails(const DSBlock& dsblock);
   void StoreDSBlockToDisk(const DSBlock& dsblock);
 
@@ -263,10 +274,18 @@ class Node : public Executable {
   bool ProcessDSGuardNetworkInfoUpdate(const bytes& message,
                                        unsigned int offset, const Peer& from);
 
+  bool ProcessMempoolSummary(const bytes& message, unsigned int offset,
+                             const Peer& from);
+
   // bool ProcessCreateAccounts(const bytes & message,
   // unsigned int offset, const Peer & from);
   bool ProcessVCDSBlocksMessage(const bytes& message, unsigned int cur_offset,
                                 const Peer& from);
+  /// lookupShards is the structure fetched from a lookup when the sharding
+  /// structure delta was not based on the one I have, or nullptr
+  bool ProcessVCDSBlocksMessage(const bytes& message, unsigned int cur_offset,
+                                const Peer& from,
+                                const DequeOfShard* lookupShards);
   bool ProcessDoRejoin(const bytes& message, unsigned int offset,
                        const Peer& from);
 
@@ -298,9 +317,9 @@ class Node : public Executable {
   bool CheckMicroBlockshardId();
   bool CheckMicroBlockTimestamp();
   bool CheckMicroBlockHashes(bytes& errorMsg);
-  bool CheckMicroBlockTxnRootHash();
+  bool CheckMicroBlockTxnRootHash(const TxnHash& expectedTxRootHash);
   bool CheckMicroBlockStateDeltaHash();
-  bool CheckMicroBlockTranReceiptHash();
+  bool CheckMicroBlockTranReceiptHash(const TxnHash& expectedTranHash);
 
   void NotifyTimeout(bool& txnProcTimeout);
   bool VerifyTxnsOrdering(const std::vector<TxnHash>& tranHashes,
@@ -392,6 +411,17 @@ class Node : public Executable {
   std::mutex m_mutexCVMicroBlockMissingTxn;
   std::condition_variable cv_MicroBlockMissingTxn;
 
+  // Txns pushed by the shard leader in reply to our mempool summary
+  std::mutex m_mutexCVTxnPrefetch;
+  std::condition_variable cv_TxnPrefetch;
+  uint64_t m_txnPrefetchEpoch = 0;
+
+  // Shard backups the leader has answered a mempool summary from, in epoch
+  // m_mempoolSummaryEpoch
+  std::mutex m_mutexMempoolSummary;
+  uint64_t m_mempoolSummaryEpoch = 0;
+  std::unordered_set<PubKey> m_mempoolSummarySenders;
+
   // std::condition_variable m_cvNewRoundStarted;
   // std::mutex m_mutexNewRoundStarted;
   // bool m_newRoundStarted = false;
@@ -508,6 +538,7 @@ class Node : public Executable {
 
   void ProcessTransactionWhenShardLeader();
   void ProcessTransactionWhenShardBackup();
+  void PrefetchTxnsFromShardLeader();
   bool ComposeMicroBlock();
   bool CheckMicroBlockValidity(bytes& errorMsg);
   bool OnNodeMissingTxns(const bytes& errorMsg, const unsigned int offset,
@@ -167,8 +167,8 @@ bool Node::StartPoW(const uint64_t& block_num, uint8_t ds_difficulty,
         POW::GetInstance().StopMining();
 
         if (m_mediator.m_currentEpochNum ==
-            m_mediator.m_dsBlockChain.GetLastBlock()
-                .GetHeader()
+            m_mediator.m_dsBlockChain.GetLastBlockPtr()
+                ->GetHeader()
                 .GetEpochNum()) {
           LOG_GENERAL(WARNING, "DS was processed just now, ignore time out");
           return;
@@ -404,6 +404,7 @@ LOG_EPOCH(INFO,m_mediator.m_currentEpochNum,
                           << m_mediator.m_DSCommittee->back().second);
     cur_offset += IP_SIZE + PORT_SIZE;
   }
+  m_mediator.UpdateCommitteeView();
 
   {
     lock_guard<mutex> g(m_mediator.m_mutexInitialDSCommittee);
@@ -441,8 +442,8 @@ bool Node::ProcessStartPoW(const bytes& message, unsigned int offset,
 
   LOG_MARKER();
   LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
-            "START OF EPOCH " << m_mediator.m_dsBlockChain.GetLastBlock()
-                                         .GetHeader()
+            "START OF EPOCH " << m_mediator.m_dsBlockChain.GetLastBlockPtr()
+                                         ->GetHeader()
                                          .GetBlockNum() +
                                      1);
 
@@ -133,6 +133,8 @@ bool Node::ProcessVCBlock(const bytes& message, unsigned int cur_offset,
     return false;
   }
 
+  m_mediator.UpdateCommitteeView();
+
   if (!LOOKUP_NODE_MODE && BROADCAST_TREEBASED_CLUSTER_MODE) {
     // Avoid using the original message for broadcasting in case it contains
     // excess data beyond the VCBlock
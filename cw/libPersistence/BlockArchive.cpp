@@ -0,0 +1,411 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+
+#include <boost/filesystem.hpp>
+
+#include "BlockArchive.h"
+#include "common/Serializable.h"
+#include "libCrypto/Sha2.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+namespace {
+const uint64_t ARCHIVE_MAGIC = 0x5A494C4152434832;  // "ZILARCH2"
+
+// Magic, number of the first archived block
+const unsigned int INDEX_HEADER_SIZE = 2 * sizeof(uint64_t);
+
+// Offset, length and SHA256 of the block in the data file. A zero length
+// marks a block missing from the archive.
+const unsigned int BLOCK_HASH_SIZE = 32;
+const unsigned int INDEX_ENTRY_SIZE = 2 * sizeof(uint64_t) + BLOCK_HASH_SIZE;
+
+// The files are mapped in chunks past their end, so that most appends do
+// not have to remap them
+const uint64_t INDEX_MAP_CHUNK_SIZE = 1024 * 1024;
+const uint64_t DATA_MAP_CHUNK_SIZE = 64 * 1024 * 1024;
+
+// Blocks missing before an appended block each take an index entry. Past
+// this many, the archive starts over instead.
+const uint64_t MAX_MISSING_BLOCKS = 1024;
+
+uint64_t GetMapSize(const uint64_t& size, const uint64_t& chunkSize) {
+  return (size / chunkSize + 1) * chunkSize;
+}
+
+bytes GetBlockHash(const bytes& body) {
+  SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
+  sha2.Update(body);
+  return sha2.Finalize();
+}
+
+uint64_t ReadNumber(const unsigned char* src) {
+  uint64_t result = 0;
+  for (unsigned int i = 0; i < sizeof(uint64_t); i++) {
+    result = (result << 8) | src[i];
+  }
+  return result;
+}
+
+bool WriteAll(int fd, const bytes& src, const uint64_t& offset) {
+  size_t written = 0;
+  while (written < src.size()) {
+    ssize_t ret = pwrite(fd, src.data() + written, src.size() - written,
+                         offset + written);
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    written += ret;
+  }
+  return true;
+}
+}  // namespace
+
+BlockArchive::BlockArchive(const string& path, const string& name)
+    : m_indexFilename(path + "/" + name + ".idx"),
+      m_dataFilename(path + "/" + name + ".dat") {
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(path, ec);
+  if (ec) {
+    LOG_GENERAL(WARNING, "Failed to create " << path << ": " << ec.message());
+    return;
+  }
+
+  Open();
+}
+
+BlockArchive::~BlockArchive() { Close(); }
+
+bool BlockArchive::Open() {
+  m_indexFd = open(m_indexFilename.c_str(), O_RDWR | O_CREAT, 0644);
+  m_dataFd = open(m_dataFilename.c_str(), O_RDWR | O_CREAT, 0644);
+  if (m_indexFd < 0 || m_dataFd < 0) {
+    LOG_GENERAL(WARNING, "Failed to open " << m_indexFilename);
+    Close();
+    return false;
+  }
+
+  struct stat indexStat, dataStat;
+  if (fstat(m_indexFd, &indexStat) != 0 || fstat(m_dataFd, &dataStat) != 0) {
+    LOG_GENERAL(WARNING, "Failed to stat " << m_indexFilename);
+    Close();
+    return false;
+  }
+
+  m_indexSize = indexStat.st_size;
+  m_dataSize = dataStat.st_size;
+
+  if (m_indexSize < INDEX_HEADER_SIZE) {
+    bytes header;
+    Serializable::SetNumber<uint64_t>(header, 0, ARCHIVE_MAGIC,
+                                      sizeof(uint64_t));
+    Serializable::SetNumber<uint64_t>(header, sizeof(uint64_t), 0,
+                                      sizeof(uint64_t));
+    if (!WriteAll(m_indexFd, header, 0) ||
+        ftruncate(m_indexFd, INDEX_HEADER_SIZE) != 0) {
+      LOG_GENERAL(WARNING, "Failed to initialize " << m_indexFilename);
+      Close();
+      return false;
+    }
+    m_indexSize = INDEX_HEADER_SIZE;
+  }
+
+  if (!Map()) {
+    Close();
+    return false;
+  }
+
+  if (ReadNumber(m_index) != ARCHIVE_MAGIC) {
+    LOG_GENERAL(WARNING, m_indexFilename << " is not a block archive");
+    Close();
+    return false;
+  }
+
+  m_baseBlockNum = ReadNumber(m_index + sizeof(uint64_t));
+  m_numBlocks = (m_indexSize - INDEX_HEADER_SIZE) / INDEX_ENTRY_SIZE;
+
+  // Drop whatever an interrupted Append left behind
+  uint64_t numValidBlocks = m_numBlocks;
+  while (numValidBlocks > 0) {
+    uint64_t offset = 0, length = 0;
+    bytes hash;
+    GetEntry(m_baseBlockNum + numValidBlocks - 1, offset, length, hash);
+    if (offset + length <= m_dataSize) {
+      break;
+    }
+    numValidBlocks--;
+  }
+
+  if (!TruncateFrom(m_baseBlockNum + numValidBlocks)) {
+    Close();
+    return false;
+  }
+
+  LOG_GENERAL(INFO, "Opened " << m_indexFilename << " with " << m_numBlocks
+                              << " blocks from " << m_baseBlockNum);
+
+  return true;
+}
+
+void BlockArchive::Close() {
+  Unmap();
+
+  if (m_indexFd >= 0) {
+    close(m_indexFd);
+    m_indexFd = -1;
+  }
+
+  if (m_dataFd >= 0) {
+    close(m_dataFd);
+    m_dataFd = -1;
+  }
+
+  m_indexSize = 0;
+  m_dataSize = 0;
+  m_baseBlockNum = 0;
+  m_numBlocks = 0;
+}
+
+bool BlockArchive::Map() {
+  // Only the part up to the end of the files is ever read
+  const uint64_t indexMapSize = GetMapSize(m_indexSize, INDEX_MAP_CHUNK_SIZE);
+  void* index =
+      mmap(nullptr, indexMapSize, PROT_READ, MAP_SHARED, m_indexFd, 0);
+  if (index == MAP_FAILED) {
+    LOG_GENERAL(WARNING, "Failed to map " << m_indexFilename);
+    return false;
+  }
+  m_index = static_cast<const unsigned char*>(index);
+  m_indexMapSize = indexMapSize;
+
+  const uint64_t dataMapSize = GetMapSize(m_dataSize, DATA_MAP_CHUNK_SIZE);
+  void* data = mmap(nullptr, dataMapSize, PROT_READ, MAP_SHARED, m_dataFd, 0);
+  if (data == MAP_FAILED) {
+    LOG_GENERAL(WARNING, "Failed to map " << m_dataFilename);
+    Unmap();
+    return false;
+  }
+  m_data = static_cast<const unsigned char*>(data);
+  m_dataMapSize = dataMapSize;
+
+  return true;
+}
+
+void BlockArchive::Unmap() {
+  if (m_index != nullptr) {
+    munmap(const_cast<unsigned char*>(m_index), m_indexMapSize);
+    m_index = nullptr;
+    m_indexMapSize = 0;
+  }
+
+  if (m_data != nullptr) {
+    munmap(const_cast<unsigned char*>(m_data), m_dataMapSize);
+    m_data = nullptr;
+    m_dataMapSize = 0;
+  }
+}
+
+bool BlockArchive::GetEntry(const uint64_t& blockNum, uint64_t& offset,
+                            uint64_t& length, bytes& hash) const {
+  if (m_index == nullptr || blockNum < m_baseBlockNum ||
+      blockNum - m_baseBlockNum >= m_numBlocks) {
+    return false;
+  }
+
+  const unsigned char* entry = m_index + INDEX_HEADER_SIZE +
+                               (blockNum - m_baseBlockNum) * INDEX_ENTRY_SIZE;
+  offset = ReadNumber(entry);
+  length = ReadNumber(entry + sizeof(uint64_t));
+  hash.assign(entry + 2 * sizeof(uint64_t), entry + INDEX_ENTRY_SIZE);
+
+  return true;
+}
+
+bool BlockArchive::TruncateFrom(const uint64_t& blockNum) {
+  const uint64_t numBlocks =
+      blockNum < m_baseBlockNum ? 0
+                                : min(m_numBlocks, blockNum - m_baseBlockNum);
+
+  // The data of the remaining blocks ends with the last one present
+  uint64_t dataSize = 0;
+  for (uint64_t i = numBlocks; i > 0; i--) {
+    uint64_t offset = 0, length = 0;
+    bytes hash;
+    GetEntry(m_baseBlockNum + i - 1, offset, length, hash);
+    if (length > 0) {
+      dataSize = offset + length;
+      break;
+    }
+  }
+
+  const uint64_t indexSize = INDEX_HEADER_SIZE + numBlocks * INDEX_ENTRY_SIZE;
+
+  Unmap();
+
+  if (ftruncate(m_indexFd, indexSize) != 0 ||
+      ftruncate(m_dataFd, dataSize) != 0) {
+    LOG_GENERAL(WARNING, "Failed to truncate " << m_indexFilename);
+    Map();
+    return false;
+  }
+
+  m_indexSize = indexSize;
+  m_dataSize = dataSize;
+  m_numBlocks = numBlocks;
+
+  return Map();
+}
+
+bool BlockArchive::Append(const uint64_t& blockNum, const bytes& body) {
+  unique_lock<shared_timed_mutex> g(m_mutex);
+
+  if (m_indexFd < 0 || body.empty()) {
+    return false;
+  }
+
+  if (m_numBlocks > 0 && blockNum >= m_baseBlockNum + m_numBlocks &&
+      blockNum - (m_baseBlockNum + m_numBlocks) > MAX_MISSING_BLOCKS) {
+    LOG_GENERAL(INFO, "Block " << blockNum << " too far past the end of "
+                               << m_indexFilename << ", starting over");
+    if (!TruncateFrom(m_baseBlockNum)) {
+      return false;
+    }
+  }
+
+  if (m_numBlocks == 0) {
+    bytes baseBlockNum;
+    Serializable::SetNumber<uint64_t>(baseBlockNum, 0, blockNum,
+                                      sizeof(uint64_t));
+    if (!WriteAll(m_indexFd, baseBlockNum, sizeof(uint64_t))) {
+      LOG_GENERAL(WARNING, "Failed to write " << m_indexFilename);
+      return false;
+    }
+    m_baseBlockNum = blockNum;
+  } else if (blockNum < m_baseBlockNum) {
+    LOG_GENERAL(WARNING, "Block " << blockNum << " precedes "
+                                  << m_indexFilename << " start "
+                                  << m_baseBlockNum);
+    return false;
+  } else if (blockNum - m_baseBlockNum < m_numBlocks) {
+    if (!TruncateFrom(blockNum)) {
+      return false;
+    }
+  }
+
+  // Data first, so that the index never points past the data
+  if (!WriteAll(m_dataFd, body, m_dataSize)) {
+    LOG_GENERAL(WARNING, "Failed to write " << m_dataFilename);
+    return false;
+  }
+
+  bytes entries;
+  unsigned int curOffset = 0;
+  for (uint64_t i = m_baseBlockNum + m_numBlocks; i <= blockNum; i++) {
+    const bool isBlock = (i == blockNum);
+    Serializable::SetNumber<uint64_t>(entries, curOffset,
+                                      isBlock ? m_dataSize : 0,
+                                      sizeof(uint64_t));
+    curOffset += sizeof(uint64_t);
+    Serializable::SetNumber<uint64_t>(entries, curOffset,
+                                      isBlock ? body.size() : 0,
+                                      sizeof(uint64_t));
+    curOffset += sizeof(uint64_t);
+    const bytes hash =
+        isBlock ? GetBlockHash(body) : bytes(BLOCK_HASH_SIZE, 0);
+    entries.insert(entries.end(), hash.begin(), hash.end());
+    curOffset += BLOCK_HASH_SIZE;
+  }
+
+  if (!WriteAll(m_indexFd, entries, m_indexSize)) {
+    LOG_GENERAL(WARNING, "Failed to write " << m_indexFilename);
+    return false;
+  }
+
+  m_indexSize += entries.size();
+  m_dataSize += body.size();
+  m_numBlocks = blockNum - m_baseBlockNum + 1;
+
+  if (m_indexSize > m_indexMapSize || m_dataSize > m_dataMapSize) {
+    Unmap();
+    return Map();
+  }
+
+  return true;
+}
+
+bool BlockArchive::Get(const uint64_t& blockNum, bytes& body) const {
+  shared_lock<shared_timed_mutex> g(m_mutex);
+
+  uint64_t offset = 0, length = 0;
+  bytes hash;
+  if (!GetEntry(blockNum, offset, length, hash) || length == 0) {
+    return false;
+  }
+
+  if (m_data == nullptr || offset + length > m_dataSize) {
+    LOG_GENERAL(WARNING, "Block " << blockNum << " out of bounds in "
+                                  << m_dataFilename);
+    return false;
+  }
+
+  body.assign(m_data + offset, m_data + offset + length);
+
+  if (GetBlockHash(body) != hash) {
+    LOG_GENERAL(WARNING, "Block " << blockNum << " corrupted in "
+                                  << m_dataFilename);
+    body.clear();
+    return false;
+  }
+
+  return true;
+}
+
+bool BlockArchive::Truncate(const uint64_t& blockNum) {
+  unique_lock<shared_timed_mutex> g(m_mutex);
+
+  if (m_indexFd < 0) {
+    return false;
+  }
+
+  if (blockNum >= m_baseBlockNum + m_numBlocks) {
+    return true;
+  }
+
+  return TruncateFrom(blockNum);
+}
+
+bool BlockArchive::Reset() {
+  unique_lock<shared_timed_mutex> g(m_mutex);
+
+  Close();
+
+  boost::system::error_code ec;
+  boost::filesystem::remove(m_indexFilename, ec);
+  boost::filesystem::remove(m_dataFilename, ec);
+
+  return Open();
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __BLOCKARCHIVE_H__
+#define __BLOCKARCHIVE_H__
+
+#include <shared_mutex>
+#include <string>
+
+#include "common/BaseType.h"
+
+/// Append-only archive of serialized blocks indexed by block number, read
+/// through memory maps. The index file holds a fixed-size entry (offset,
+/// length and hash in the data file) for every block number from the first
+/// archived one, so reading a block is an index lookup and a copy out of the
+/// data file. Blocks can only be appended after the last one, or dropped
+/// from the end when the chain is rolled back.
+class BlockArchive {
+  const std::string m_indexFilename;
+  const std::string m_dataFilename;
+
+  int m_indexFd = -1;
+  int m_dataFd = -1;
+  const unsigned char* m_index = nullptr;
+  const unsigned char* m_data = nullptr;
+  uint64_t m_indexSize = 0;
+  uint64_t m_dataSize = 0;
+  uint64_t m_indexMapSize = 0;
+  uint64_t m_dataMapSize = 0;
+  uint64_t m_baseBlockNum = 0;
+  uint64_t m_numBlocks = 0;
+
+  mutable std::shared_timed_mutex m_mutex;
+
+  bool Open();
+  void Close();
+  bool Map();
+  void Unmap();
+  bool GetEntry(const uint64_t& blockNum, uint64_t& offset, uint64_t& length,
+                bytes& hash) const;
+  bool TruncateFrom(const uint64_t& blockNum);
+
+ public:
+  /// Constructor. Opens or creates the archive name under path.
+  BlockArchive(const std::string& path, const std::string& name);
+
+  ~BlockArchive();
+
+  BlockArchive(const BlockArchive&) = delete;
+
+  BlockArchive& operator=(const BlockArchive&) = delete;
+
+  /// Adds a block. Replaces the block and drops all later ones if blockNum
+  /// is already archived. Starts the archive over at blockNum if it is too
+  /// far past the last block.
+  bool Append(const uint64_t& blockNum, const bytes& body);
+
+  /// Retrieves the serialized block, if it matches the hash archived with it
+  bool Get(const uint64_t& blockNum, bytes& body) const;
+
+  /// Drops the block and all later ones
+  bool Truncate(const uint64_t& blockNum);
+
+  /// Deletes all blocks
+  bool Reset();
+};
+
+#endif  // __BLOCKARCHIVE_H__
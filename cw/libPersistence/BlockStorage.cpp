@@ -48,10 +48,26 @@ bool BlockStorage::PutBlock(const uint64_t& blockNum, const bytes& body,
   if (blockType == BlockType::DS) {
     unique_lock<shared_timed_mutex> g(m_mutexDsBlockchain);
     ret = m_dsBlockchainDB->Insert(blockNum, body);
+    if (ret == 0 && m_dsBlockArchive &&
+        !m_dsBlockArchive->Append(blockNum, body)) {
+      LOG_GENERAL(WARNING, "Failed to archive DSBlock num = " << blockNum);
+      // An older copy must not be read instead of the one just stored
+      if (!m_dsBlockArchive->Truncate(blockNum)) {
+        m_dsBlockArchive->Reset();
+      }
+    }
     LOG_GENERAL(INFO, "Stored DSBlock num = " << blockNum);
   } else if (blockType == BlockType::Tx) {
     unique_lock<shared_timed_mutex> g(m_mutexTxBlockchain);
     ret = m_txBlockchainDB->Insert(blockNum, body);
+    if (ret == 0 && m_txBlockArchive &&
+        !m_txBlockArchive->Append(blockNum, body)) {
+      LOG_GENERAL(WARNING, "Failed to archive TxBlock num = " << blockNum);
+      // An older copy must not be read instead of the one just stored
+      if (!m_txBlockArchive->Truncate(blockNum)) {
+        m_txBlockArchive->Reset();
+      }
+    }
     LOG_GENERAL(INFO, "Stored TxBlock num = " << blockNum);
   }
   return (ret == 0);
@@ -97,19 +113,30 @@ bool BlockStorage::PutTxBlock(const uint64_t& blockNum, const bytes& body) {
   return PutBlock(blockNum, body, BlockType::Tx);
 }
 
-bool BlockStorage::PutTxBody(const dev::h256& key, const bytes& body) {
-  int ret;
-
+bool BlockStorage::PutTxBodies(
+    const vector<pair<dev::h256, dev::bytesConstRef>>& bodies) {
   if (!LOOKUP_NODE_MODE) {
     LOG_GENERAL(WARNING, "Non lookup node should not trigger this.");
     return false;
-  } else  // IS_LOOKUP_NODE
+  }
+
   {
     unique_lock<shared_timed_mutex> g(m_mutexTxBody);
-    ret = m_txBodyDB->Insert(key, body) && m_txBodyTmpDB->Insert(key, body);
+    if (!m_txBodyDB->BatchInsert(bodies)) {
+      LOG_GENERAL(WARNING, "BatchInsert m_txBodyDB failed");
+      return false;
+    }
   }
 
-  return (ret == 0);
+  {
+    unique_lock<shared_timed_mutex> g(m_mutexTxBodyTmp);
+    if (!m_txBodyTmpDB->BatchInsert(bodies)) {
+      LOG_GENERAL(WARNING, "BatchInsert m_txBodyTmpDB failed");
+      return false;
+    }
+  }
+
+  return true;
 }
 
 bool BlockStorage::PutMicroBlock(const BlockHash& blockHash,
@@ -168,6 +195,153 @@ bool BlockStorage::GetHistoricalMicroBlock(const BlockHash& blockhash,
   return true;
 }
 
+bool BlockStorage::GetLowestTxBlockNum(const uint64_t& fromBlockNum,
+                                       uint64_t& blockNum) {
+  shared_lock<shared_timed_mutex> g(m_mutexTxBlockchain);
+
+  bool found = false;
+  leveldb::Iterator* it =
+      m_txBlockchainDB->GetDB()->NewIterator(leveldb::ReadOptions());
+  for (it->SeekToFirst(); it->Valid(); it->Next()) {
+    // Keys are decimal strings, so their order is not numeric
+    const string bns = it->key().ToString();
+    char* end = nullptr;
+    const uint64_t num = strtoull(bns.c_str(), &end, 10);
+    if (bns.empty() || *end != '\0' || num < fromBlockNum) {
+      continue;
+    }
+    if (!found || num < blockNum) {
+      blockNum = num;
+      found = true;
+    }
+  }
+
+  delete it;
+
+  return found;
+}
+
+bool BlockStorage::GetTxBlockAtOrAfter(uint64_t& blockNum,
+                                       TxBlockSharedPtr& block) {
+  if (GetTxBlock(blockNum, block)) {
+    return true;
+  }
+
+  uint64_t nextBlockNum = 0;
+  if (!GetLowestTxBlockNum(blockNum, nextBlockNum) ||
+      !GetTxBlock(nextBlockNum, block)) {
+    return false;
+  }
+
+  LOG_GENERAL(WARNING, "Skipping missing TxBlocks " << blockNum << " to "
+                                                    << nextBlockNum - 1);
+  blockNum = nextBlockNum;
+
+  return true;
+}
+
+bool BlockStorage::MoveToColdStorage(const uint64_t& dsBlockNum) {
+  if (!LOOKUP_NODE_MODE || !m_coldStorage ||
+      TXBODY_HOT_RETENTION_DS_EPOCHS == 0 ||
+      dsBlockNum < TXBODY_HOT_RETENTION_DS_EPOCHS) {
+    return true;
+  }
+
+  LOG_MARKER();
+
+  const uint64_t lastColdDSBlockNum =
+      dsBlockNum - TXBODY_HOT_RETENTION_DS_EPOCHS;
+
+  lock_guard<mutex> g(m_mutexColdStorage);
+
+  // A node started from a later persistence does not have TxBlock 0, and
+  // TxBlocks it never received leave gaps that segments simply span
+  uint64_t txBlockNum = m_coldStorage->GetNextTxBlockNum();
+  TxBlockSharedPtr txBlock;
+  if (!GetTxBlockAtOrAfter(txBlockNum, txBlock)) {
+    LOG_GENERAL(WARNING, "No TxBlock from " << txBlockNum
+                                            << " for cold storage");
+    return false;
+  }
+
+  // One segment per DS epoch, holding all the TxBlocks of that epoch
+  while (txBlock &&
+         txBlock->GetHeader().GetDSBlockNum() <= lastColdDSBlockNum) {
+    const uint64_t coldDSBlockNum = txBlock->GetHeader().GetDSBlockNum();
+    const uint64_t loTxBlockNum = txBlockNum;
+
+    vector<ColdStorage::Record> records;
+    vector<TxnHash> txnHashes;
+    vector<BlockHash> microBlockHashes;
+
+    while (txBlock && txBlock->GetHeader().GetDSBlockNum() == coldDSBlockNum) {
+      for (const auto& info : txBlock->GetMicroBlockInfos()) {
+        string blockString;
+        {
+          shared_lock<shared_timed_mutex> g(m_mutexMicroBlock);
+          blockString = m_microBlockDB->Lookup(info.m_microBlockHash);
+        }
+        if (blockString.empty()) {
+          continue;
+        }
+
+        bytes block(blockString.begin(), blockString.end());
+        MicroBlock microBlock(block, 0);
+
+        for (const auto& txnHash : microBlock.GetTranHashes()) {
+          string bodyString;
+          {
+            shared_lock<shared_timed_mutex> g(m_mutexTxBody);
+            bodyString = m_txBodyDB->Lookup(txnHash);
+          }
+          if (bodyString.empty()) {
+            continue;
+          }
+          records.push_back({ColdStorage::TXBODY, txnHash,
+                             bytes(bodyString.begin(), bodyString.end())});
+          txnHashes.emplace_back(txnHash);
+        }
+
+        records.push_back(
+            {ColdStorage::MICROBLOCK, info.m_microBlockHash, move(block)});
+        microBlockHashes.emplace_back(info.m_microBlockHash);
+      }
+
+      if (!GetTxBlockAtOrAfter(++txBlockNum, txBlock)) {
+        txBlock.reset();
+      }
+    }
+
+    if (!m_coldStorage->PutSegment(coldDSBlockNum, loTxBlockNum,
+                                   txBlockNum - 1, records)) {
+      LOG_GENERAL(WARNING, "ColdStorage::PutSegment failed for DS epoch "
+                               << coldDSBlockNum);
+      return false;
+    }
+
+    // Only drop the hot copies once the segment is readable
+    {
+      unique_lock<shared_timed_mutex> g(m_mutexTxBody);
+      for (const auto& txnHash : txnHashes) {
+        m_txBodyDB->DeleteKey(txnHash);
+      }
+    }
+    {
+      unique_lock<shared_timed_mutex> g(m_mutexMicroBlock);
+      for (const auto& microBlockHash : microBlockHashes) {
+        m_microBlockDB->DeleteKey(microBlockHash);
+      }
+    }
+
+    LOG_GENERAL(INFO, "Moved " << txnHashes.size() << " txn bodies and "
+                               << microBlockHashes.size()
+                               << " microblocks of DS epoch " << coldDSBlockNum
+                               << " to cold storage");
+  }
+
+  return true;
+}
+
 bool BlockStorage::GetMicroBlock(const BlockHash& blockHash,
                                  MicroBlockSharedPtr& microblock) {
   LOG_MARKER();
@@ -180,6 +354,12 @@ bool BlockStorage::GetMicroBlock(const BlockHash& blockHash,
   }
 
   if (blockString.empty()) {
+    bytes block;
+    if (m_coldStorage &&
+        m_coldStorage->Get(ColdStorage::MICROBLOCK, blockHash, block)) {
+      microblock = make_shared<MicroBlock>(block, 0);
+      return true;
+    }
     return false;
   }
   microblock =
@@ -283,20 +463,12 @@ bool BlockStorage::GetTempStateInBatch(leveldb::Iterator*& iter,
 
 bool BlockStorage::GetDSBlock(const uint64_t& blockNum,
                               DSBlockSharedPtr& block) {
-  string blockString;
-  {
-    shared_lock<shared_timed_mutex> g(m_mutexDsBlockchain);
-    blockString = m_dsBlockchainDB->Lookup(blockNum);
-  }
-
-  if (blockString.empty()) {
+  bytes body;
+  if (!GetSerializedDSBlock(blockNum, body)) {
     return false;
   }
 
-  // LOG_GENERAL(INFO, blockString);
-  // LOG_GENERAL(INFO, blockString.length());
-  block = DSBlockSharedPtr(
-      new DSBlock(bytes(blockString.begin(), blockString.end()), 0));
+  block = DSBlockSharedPtr(new DSBlock(body, 0));
 
   return true;
 }
@@ -409,17 +581,55 @@ bool BlockStorage::GetBlockLink(const uint64_t& index,
 
 bool BlockStorage::GetTxBlock(const uint64_t& blockNum,
                               TxBlockSharedPtr& block) {
+  bytes body;
+  if (!GetSerializedTxBlock(blockNum, body)) {
+    return false;
+  }
+
+  block = TxBlockSharedPtr(new TxBlock(body, 0));
+
+  return true;
+}
+
+bool BlockStorage::GetSerializedDSBlock(const uint64_t& blockNum,
+                                        bytes& body) {
+  // Blocks stored before the archive existed are only in LevelDB
+  if (m_dsBlockArchive && m_dsBlockArchive->Get(blockNum, body)) {
+    return true;
+  }
+
+  string blockString;
+  {
+    shared_lock<shared_timed_mutex> g(m_mutexDsBlockchain);
+    blockString = m_dsBlockchainDB->Lookup(blockNum);
+  }
+
+  if (blockString.empty()) {
+    return false;
+  }
+
+  body.assign(blockString.begin(), blockString.end());
+
+  return true;
+}
+
+bool BlockStorage::GetSerializedTxBlock(const uint64_t& blockNum,
+                                        bytes& body) {
+  if (m_txBlockArchive && m_txBlockArchive->Get(blockNum, body)) {
+    return true;
+  }
+
   string blockString;
   {
     shared_lock<shared_timed_mutex> g(m_mutexTxBlockchain);
     blockString = m_txBlockchainDB->Lookup(blockNum);
   }
+
   if (blockString.empty()) {
     return false;
   }
 
-  block = TxBlockSharedPtr(
-      new TxBlock(bytes(blockString.begin(), blockString.end()), 0));
+  body.assign(blockString.begin(), blockString.end());
 
   return true;
 }
@@ -433,6 +643,12 @@ bool BlockStorage::GetTxBody(const dev::h256& key, TxBodySharedPtr& body) {
   }
 
   if (bodyString.empty()) {
+    bytes txBody;
+    if (m_coldStorage &&
+        m_coldStorage->Get(ColdStorage::TXBODY, key, txBody)) {
+      body = make_shared<TransactionWithReceipt>(txBody, 0);
+      return true;
+    }
     return false;
   }
   body = TxBodySharedPtr(new TransactionWithReceipt(
@@ -444,6 +660,9 @@ bool BlockStorage::GetTxBody(const dev::h256& key, TxBodySharedPtr& body) {
 bool BlockStorage::DeleteDSBlock(const uint64_t& blocknum) {
   LOG_GENERAL(INFO, "Delete DSBlock Num: " << blocknum);
   unique_lock<shared_timed_mutex> g(m_mutexDsBlockchain);
+  if (m_dsBlockArchive && !m_dsBlockArchive->Truncate(blocknum)) {
+    LOG_GENERAL(WARNING, "Failed to drop archived DSBlock num = " << blocknum);
+  }
   int ret = m_dsBlockchainDB->DeleteKey(blocknum);
   return (ret == 0);
 }
@@ -463,6 +682,9 @@ bool BlockStorage::DeleteFallbackBlock(const BlockHash& blockhash) {
 bool BlockStorage::DeleteTxBlock(const uint64_t& blocknum) {
   LOG_GENERAL(INFO, "Delete TxBlock Num: " << blocknum);
   unique_lock<shared_timed_mutex> g(m_mutexTxBlockchain);
+  if (m_txBlockArchive && !m_txBlockArchive->Truncate(blocknum)) {
+    LOG_GENERAL(WARNING, "Failed to drop archived TxBlock num = " << blocknum);
+  }
   int ret = m_txBlockchainDB->DeleteKey(blocknum);
   return (ret == 0);
 }
@@ -1162,12 +1384,14 @@ bool BlockStorage::ResetDB(DBTYPE type) {
     }
     case DS_BLOCK: {
       unique_lock<shared_timed_mutex> g(m_mutexDsBlockchain);
-      ret = m_dsBlockchainDB->ResetDB();
+      ret = m_dsBlockchainDB->ResetDB() &&
+            (!m_dsBlockArchive || m_dsBlockArchive->Reset());
       break;
     }
     case TX_BLOCK: {
       unique_lock<shared_timed_mutex> g(m_mutexTxBlockchain);
-      ret = m_txBlockchainDB->ResetDB();
+      ret = m_txBlockchainDB->ResetDB() &&
+            (!m_txBlockArchive || m_txBlockArchive->Reset());
       break;
     }
     case TX_BODY: {
@@ -1259,12 +1483,16 @@ bool BlockStorage::RefreshDB(DBTYPE type) {
     }
     case DS_BLOCK: {
       unique_lock<shared_timed_mutex> g(m_mutexDsBlockchain);
-      ret = m_dsBlockchainDB->RefreshDB();
+      // The DB may have been replaced, so the archive cannot be trusted to
+      // match it. Reads fall back to the DB until blocks are stored again.
+      ret = m_dsBlockchainDB->RefreshDB() &&
+            (!m_dsBlockArchive || m_dsBlockArchive->Reset());
       break;
     }
     case TX_BLOCK: {
       unique_lock<shared_timed_mutex> g(m_mutexTxBlockchain);
-      ret = m_txBlockchainDB->RefreshDB();
+      ret = m_txBlockchainDB->RefreshDB() &&
+            (!m_txBlockArchive || m_txBlockArchive->Reset());
       break;
     }
     case TX_BODY: {
@@ -1451,7 +1679,7 @@ bool BlockStorage::ResetAll() {
            ResetDB(BLOCKLINK) & ResetDB(SHARD_STRUCTURE) &
            ResetDB(STATE_DELTA) & ResetDB(TEMP_STATE) &
            ResetDB(DIAGNOSTIC_NODES) & ResetDB(DIAGNOSTIC_COINBASE) &
-           ResetDB(STATE_ROOT);
+           ResetDB(STATE_ROOT) & m_coldStorage->Reset();
   }
 }
 
@@ -1474,7 +1702,7 @@ bool BlockStorage::RefreshAll() {
            RefreshDB(BLOCKLINK) & RefreshDB(SHARD_STRUCTURE) &
            RefreshDB(STATE_DELTA) & RefreshDB(TEMP_STATE) &
            RefreshDB(DIAGNOSTIC_NODES) & RefreshDB(DIAGNOSTIC_COINBASE) &
-           RefreshDB(STATE_ROOT) &
+           RefreshDB(STATE_ROOT) & m_coldStorage->Refresh() &
            Contract::ContractStorage::GetContractStorage().RefreshAll();
   }
 }
\ No newline at end of file
@@ -23,6 +23,8 @@
 #include <shared_mutex>
 #include <vector>
 
+#include "BlockArchive.h"
+#include "ColdStorage.h"
 #include "ContractStorage.h"
 #include "common/Singleton.h"
 #include "depends/libDatabase/LevelDB.h"
@@ -101,6 +103,18 @@ class BlockStorage : public Singleton<BlockStorage> {
   /// used for historical data
   std::shared_ptr<LevelDB> m_txnHistoricalDB;
   std::shared_ptr<LevelDB> m_MBHistoricalDB;
+  std::shared_ptr<ColdStorage> m_coldStorage;
+  /// memory-mapped copies of the DS and Tx blocks, read before LevelDB
+  std::shared_ptr<BlockArchive> m_dsBlockArchive;
+  std::shared_ptr<BlockArchive> m_txBlockArchive;
+
+  /// Finds the lowest TxBlock number not below fromBlockNum in LevelDB by
+  /// scanning all the keys
+  bool GetLowestTxBlockNum(const uint64_t& fromBlockNum, uint64_t& blockNum);
+
+  /// Retrieves the TxBlock blockNum, or else the next one present, in which
+  /// case blockNum is moved forward to it
+  bool GetTxBlockAtOrAfter(uint64_t& blockNum, TxBlockSharedPtr& block);
 
   BlockStorage(const std::string& path = "", bool diagnostic = false)
       : m_metadataDB(std::make_shared<LevelDB>("metadata")),
@@ -121,9 +135,17 @@ class BlockStorage : public Singleton<BlockStorage> {
         m_stateRootDB(std::make_shared<LevelDB>("stateRoot")),
         m_diagnosticDBNodesCounter(0),
         m_diagnosticDBCoinbaseCounter(0) {
+    if (LOOKUP_NODE_MODE && !diagnostic) {
+      m_dsBlockArchive = std::make_shared<BlockArchive>(
+          "./" + PERSISTENCE_PATH + "/archive", "dsBlocks");
+      m_txBlockArchive = std::make_shared<BlockArchive>(
+          "./" + PERSISTENCE_PATH + "/archive", "txBlocks");
+    }
     if (LOOKUP_NODE_MODE) {
       m_txBodyDB = std::make_shared<LevelDB>("txBodies");
       m_txBodyTmpDB = std::make_shared<LevelDB>("txBodiesTmp");
+      m_coldStorage =
+          std::make_shared<ColdStorage>("./" + PERSISTENCE_PATH + "/cold");
     }
   };
   ~BlockStorage() = default;
@@ -171,8 +193,9 @@ class BlockStorage : public Singleton<BlockStorage> {
   // /// Adds a micro block to storage.
   bool PutMicroBlock(const BlockHash& blockHash, const bytes& body);
 
-  /// Adds a transaction body to storage.
-  bool PutTxBody(const dev::h256& key, const bytes& body);
+  /// Adds transaction bodies to storage with one write per database.
+  bool PutTxBodies(
+      const std::vector<std::pair<dev::h256, dev::bytesConstRef>>& bodies);
 
   /// Retrieves the requested DS block.
   bool GetDSBlock(const uint64_t& blockNum, DSBlockSharedPtr& block);
@@ -185,6 +208,12 @@ class BlockStorage : public Singleton<BlockStorage> {
   /// Retrieves the requested Tx block.
   bool GetTxBlock(const uint64_t& blockNum, TxBlockSharedPtr& block);
 
+  /// Retrieves the stored encoding of the requested DS block.
+  bool GetSerializedDSBlock(const uint64_t& blockNum, bytes& body);
+
+  /// Retrieves the stored encoding of the requested Tx block.
+  bool GetSerializedTxBlock(const uint64_t& blockNum, bytes& body);
+
   bool ReleaseDB();
 
   // /// Retrieves the requested Micro block
@@ -205,6 +234,10 @@ class BlockStorage : public Singleton<BlockStorage> {
   bool GetHistoricalMicroBlock(const BlockHash& blockhash,
                                MicroBlockSharedPtr& microblock);
 
+  /// Moves the txn bodies and microblocks of the DS epochs that have left the
+  /// retention window from LevelDB into cold storage segments
+  bool MoveToColdStorage(const uint64_t& dsBlockNum);
+
   /// Deletes the requested DS block
   bool DeleteDSBlock(const uint64_t& blocknum);
 
@@ -357,6 +390,7 @@ class BlockStorage : public Singleton<BlockStorage> {
   mutable std::shared_timed_mutex m_mutexStateRoot;
   mutable std::shared_timed_mutex m_mutexTxnHistorical;
   mutable std::shared_timed_mutex m_mutexMBHistorical;
+  std::mutex m_mutexColdStorage;
 
   unsigned int m_diagnosticDBNodesCounter;
   unsigned int m_diagnosticDBCoinbaseCounter;
@@ -0,0 +1,362 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <fstream>
+
+#include <snappy.h>
+#include <boost/filesystem.hpp>
+
+#include "ColdStorage.h"
+#include "common/Serializable.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+namespace {
+const uint64_t SEGMENT_MAGIC = 0x5A494C434F4C4431;  // "ZILCOLD1"
+const string SEGMENT_EXTENSION = ".seg";
+const string SEGMENT_TMP_EXTENSION = ".tmp";
+
+// Magic, DS block num, lowest and highest TxBlock num, number of records
+const unsigned int SEGMENT_HEADER_SIZE = 5 * sizeof(uint64_t);
+
+// Record type, key, offset in the segment, compressed length
+const unsigned int INDEX_ENTRY_SIZE = sizeof(unsigned char) +
+                                      dev::h256::size + sizeof(uint64_t) +
+                                      sizeof(uint32_t);
+
+// Flushes a file or directory to the disk
+bool SyncPath(const string& path, int flags) {
+  const int fd = open(path.c_str(), flags);
+  if (fd < 0) {
+    LOG_GENERAL(WARNING, "Failed to open " << path);
+    return false;
+  }
+  const bool synced = fsync(fd) == 0;
+  close(fd);
+  if (!synced) {
+    LOG_GENERAL(WARNING, "Failed to sync " << path);
+  }
+  return synced;
+}
+}  // namespace
+
+ColdStorage::ColdStorage(const string& path) : m_path(path) { Refresh(); }
+
+bool ColdStorage::LoadSegment(const string& filename, Segment& segment) {
+  ifstream file(filename, ios::binary);
+  if (!file) {
+    LOG_GENERAL(WARNING, "Failed to open " << filename);
+    return false;
+  }
+
+  bytes header(SEGMENT_HEADER_SIZE);
+  if (!file.read(reinterpret_cast<char*>(header.data()), header.size())) {
+    LOG_GENERAL(WARNING, "Failed to read header of " << filename);
+    return false;
+  }
+
+  unsigned int curOffset = 0;
+  if (Serializable::GetNumber<uint64_t>(header, curOffset, sizeof(uint64_t)) !=
+      SEGMENT_MAGIC) {
+    LOG_GENERAL(WARNING, filename << " is not a cold storage segment");
+    return false;
+  }
+  curOffset += sizeof(uint64_t);
+
+  segment.m_filename = filename;
+  segment.m_dsBlockNum =
+      Serializable::GetNumber<uint64_t>(header, curOffset, sizeof(uint64_t));
+  curOffset += sizeof(uint64_t);
+  segment.m_loTxBlockNum =
+      Serializable::GetNumber<uint64_t>(header, curOffset, sizeof(uint64_t));
+  curOffset += sizeof(uint64_t);
+  segment.m_hiTxBlockNum =
+      Serializable::GetNumber<uint64_t>(header, curOffset, sizeof(uint64_t));
+  curOffset += sizeof(uint64_t);
+  const uint64_t count =
+      Serializable::GetNumber<uint64_t>(header, curOffset, sizeof(uint64_t));
+
+  boost::system::error_code ec;
+  const uint64_t fileSize = boost::filesystem::file_size(filename, ec);
+  if (ec || count > (fileSize - SEGMENT_HEADER_SIZE) / INDEX_ENTRY_SIZE) {
+    LOG_GENERAL(WARNING,
+                "Invalid record count " << count << " in " << filename);
+    return false;
+  }
+
+  bytes index(count * INDEX_ENTRY_SIZE);
+  if (!file.read(reinterpret_cast<char*>(index.data()), index.size())) {
+    LOG_GENERAL(WARNING, "Failed to read index of " << filename);
+    return false;
+  }
+
+  segment.m_index.clear();
+  segment.m_index.reserve(count);
+
+  curOffset = 0;
+  for (uint64_t i = 0; i < count; i++) {
+    IndexEntry entry;
+    entry.m_type = static_cast<RecordType>(index.at(curOffset));
+    curOffset += sizeof(unsigned char);
+    copy(index.begin() + curOffset,
+         index.begin() + curOffset + entry.m_key.size,
+         entry.m_key.asArray().begin());
+    curOffset += entry.m_key.size;
+    entry.m_offset =
+        Serializable::GetNumber<uint64_t>(index, curOffset, sizeof(uint64_t));
+    curOffset += sizeof(uint64_t);
+    entry.m_length =
+        Serializable::GetNumber<uint32_t>(index, curOffset, sizeof(uint32_t));
+    curOffset += sizeof(uint32_t);
+
+    if (entry.m_offset + entry.m_length > fileSize) {
+      LOG_GENERAL(WARNING, "Record " << entry.m_key << " out of bounds in "
+                                     << filename);
+      return false;
+    }
+
+    segment.m_index.emplace_back(entry);
+  }
+
+  return true;
+}
+
+bool ColdStorage::PutSegment(const uint64_t& dsBlockNum,
+                             const uint64_t& loTxBlockNum,
+                             const uint64_t& hiTxBlockNum,
+                             const vector<Record>& records) {
+  LOG_MARKER();
+
+  {
+    shared_lock<shared_timed_mutex> g(m_mutexSegments);
+    if (!m_segments.empty() &&
+        m_segments.back().m_hiTxBlockNum >= loTxBlockNum) {
+      LOG_GENERAL(WARNING,
+                  "TxBlock " << loTxBlockNum << " already in cold storage");
+      return false;
+    }
+  }
+
+  Segment segment;
+  segment.m_filename = m_path + "/" + to_string(dsBlockNum) + SEGMENT_EXTENSION;
+  segment.m_dsBlockNum = dsBlockNum;
+  segment.m_loTxBlockNum = loTxBlockNum;
+  segment.m_hiTxBlockNum = hiTxBlockNum;
+  segment.m_index.reserve(records.size());
+
+  // Records are laid out after the index in the order given
+  vector<string> compressedValues(records.size());
+  uint64_t offset = SEGMENT_HEADER_SIZE + records.size() * INDEX_ENTRY_SIZE;
+  for (unsigned int i = 0; i < records.size(); i++) {
+    const auto& record = records.at(i);
+    auto& compressedValue = compressedValues.at(i);
+    snappy::Compress(reinterpret_cast<const char*>(record.m_value.data()),
+                     record.m_value.size(), &compressedValue);
+    segment.m_index.push_back({record.m_type, record.m_key, offset,
+                               (uint32_t)compressedValue.size()});
+    offset += compressedValue.size();
+  }
+
+  sort(segment.m_index.begin(), segment.m_index.end());
+
+  bytes header;
+  unsigned int curOffset = 0;
+  for (const uint64_t& num : {SEGMENT_MAGIC, dsBlockNum, loTxBlockNum,
+                              hiTxBlockNum, (uint64_t)records.size()}) {
+    Serializable::SetNumber<uint64_t>(header, curOffset, num,
+                                      sizeof(uint64_t));
+    curOffset += sizeof(uint64_t);
+  }
+  for (const auto& entry : segment.m_index) {
+    header.push_back(entry.m_type);
+    header.insert(header.end(), entry.m_key.begin(), entry.m_key.end());
+    curOffset += sizeof(unsigned char) + entry.m_key.size;
+    Serializable::SetNumber<uint64_t>(header, curOffset, entry.m_offset,
+                                      sizeof(uint64_t));
+    curOffset += sizeof(uint64_t);
+    Serializable::SetNumber<uint32_t>(header, curOffset, entry.m_length,
+                                      sizeof(uint32_t));
+    curOffset += sizeof(uint32_t);
+  }
+
+  // Write under a temporary name so that a segment is either complete or
+  // absent
+  const string tmpFilename = segment.m_filename + SEGMENT_TMP_EXTENSION;
+  {
+    ofstream file(tmpFilename, ios::binary | ios::trunc);
+    file.write(reinterpret_cast<const char*>(header.data()), header.size());
+    for (const auto& compressedValue : compressedValues) {
+      file.write(compressedValue.data(), compressedValue.size());
+    }
+    file.close();
+    if (!file) {
+      LOG_GENERAL(WARNING, "Failed to write " << tmpFilename);
+      return false;
+    }
+  }
+  if (!SyncPath(tmpFilename, O_RDONLY)) {
+    return false;
+  }
+
+  boost::system::error_code ec;
+  boost::filesystem::rename(tmpFilename, segment.m_filename, ec);
+  if (ec) {
+    LOG_GENERAL(WARNING, "Failed to rename " << tmpFilename << ": "
+                                             << ec.message());
+    return false;
+  }
+
+  // Make the rename durable before the hot copies are deleted
+  if (!SyncPath(m_path, O_RDONLY | O_DIRECTORY)) {
+    return false;
+  }
+
+  LOG_GENERAL(INFO, "Stored " << records.size() << " records of DS epoch "
+                              << dsBlockNum << " in " << segment.m_filename);
+
+  unique_lock<shared_timed_mutex> g(m_mutexSegments);
+  m_segments.emplace_back(move(segment));
+
+  return true;
+}
+
+bool ColdStorage::Get(RecordType type, const dev::h256& key,
+                      bytes& value) const {
+  const IndexEntry target{type, key, 0, 0};
+
+  string filename;
+  uint64_t offset = 0;
+  uint32_t length = 0;
+
+  {
+    shared_lock<shared_timed_mutex> g(m_mutexSegments);
+    for (auto it = m_segments.rbegin(); it != m_segments.rend(); it++) {
+      auto found = lower_bound(it->m_index.begin(), it->m_index.end(), target);
+      if (found != it->m_index.end() && found->m_type == type &&
+          found->m_key == key) {
+        filename = it->m_filename;
+        offset = found->m_offset;
+        length = found->m_length;
+        break;
+      }
+    }
+  }
+
+  if (filename.empty()) {
+    return false;
+  }
+
+  string compressedValue(length, '\0');
+  ifstream file(filename, ios::binary);
+  if (!file.seekg(offset) || !file.read(&compressedValue[0], length)) {
+    LOG_GENERAL(WARNING, "Failed to read " << key << " from " << filename);
+    return false;
+  }
+
+  string uncompressedValue;
+  if (!snappy::Uncompress(compressedValue.data(), compressedValue.size(),
+                          &uncompressedValue)) {
+    LOG_GENERAL(WARNING, "Failed to uncompress " << key << " from "
+                                                 << filename);
+    return false;
+  }
+
+  value.assign(uncompressedValue.begin(), uncompressedValue.end());
+
+  return true;
+}
+
+uint64_t ColdStorage::GetNextTxBlockNum() const {
+  shared_lock<shared_timed_mutex> g(m_mutexSegments);
+  return m_segments.empty() ? 0 : m_segments.back().m_hiTxBlockNum + 1;
+}
+
+bool ColdStorage::Reset() {
+  unique_lock<shared_timed_mutex> g(m_mutexSegments);
+
+  m_segments.clear();
+
+  boost::system::error_code ec;
+  boost::filesystem::remove_all(m_path, ec);
+  if (ec) {
+    LOG_GENERAL(WARNING, "Failed to remove " << m_path << ": " << ec.message());
+    return false;
+  }
+
+  boost::filesystem::create_directories(m_path, ec);
+  if (ec) {
+    LOG_GENERAL(WARNING, "Failed to create " << m_path << ": " << ec.message());
+    return false;
+  }
+
+  return true;
+}
+
+bool ColdStorage::Refresh() {
+  unique_lock<shared_timed_mutex> g(m_mutexSegments);
+
+  m_segments.clear();
+
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(m_path, ec);
+  if (ec) {
+    LOG_GENERAL(WARNING, "Failed to create " << m_path << ": " << ec.message());
+    return false;
+  }
+
+  for (boost::filesystem::directory_iterator it(m_path, ec), end;
+       !ec && it != end; it.increment(ec)) {
+    const auto& path = it->path();
+
+    // Left behind by an interrupted PutSegment
+    if (path.extension() == SEGMENT_TMP_EXTENSION) {
+      boost::system::error_code removeEc;
+      boost::filesystem::remove(path, removeEc);
+      continue;
+    }
+
+    if (path.extension() != SEGMENT_EXTENSION) {
+      continue;
+    }
+
+    Segment segment;
+    if (!LoadSegment(path.string(), segment)) {
+      LOG_GENERAL(WARNING, "Skipping segment " << path.string());
+      continue;
+    }
+    m_segments.emplace_back(move(segment));
+  }
+
+  if (ec) {
+    LOG_GENERAL(WARNING, "Failed to list " << m_path << ": " << ec.message());
+    return false;
+  }
+
+  sort(m_segments.begin(), m_segments.end(),
+       [](const Segment& l, const Segment& r) {
+         return l.m_loTxBlockNum < r.m_loTxBlockNum;
+       });
+
+  LOG_GENERAL(INFO, "Loaded " << m_segments.size()
+                              << " cold storage segments from " << m_path);
+
+  return true;
+}
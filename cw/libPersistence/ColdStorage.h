@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __COLDSTORAGE_H__
+#define __COLDSTORAGE_H__
+
+#include <shared_mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "common/BaseType.h"
+#include "depends/common/FixedHash.h"
+
+/// Immutable segment files holding the txn bodies and microblocks of DS
+/// epochs that have left the LevelDB retention window of a lookup node.
+/// Each segment covers one DS epoch and starts with an index of its records
+/// sorted by key, followed by the compressed records. Segments are only ever
+/// added after the latest one, and are never modified once written.
+class ColdStorage {
+ public:
+  enum RecordType : unsigned char { TXBODY = 0x00, MICROBLOCK = 0x01 };
+
+  struct Record {
+    RecordType m_type;
+    dev::h256 m_key;
+    bytes m_value;
+  };
+
+ private:
+  struct IndexEntry {
+    RecordType m_type;
+    dev::h256 m_key;
+    uint64_t m_offset;
+    uint32_t m_length;
+
+    bool operator<(const IndexEntry& r) const {
+      return std::tie(m_type, m_key) < std::tie(r.m_type, r.m_key);
+    }
+  };
+
+  struct Segment {
+    std::string m_filename;
+    uint64_t m_dsBlockNum;
+    uint64_t m_loTxBlockNum;
+    uint64_t m_hiTxBlockNum;
+    std::vector<IndexEntry> m_index;
+  };
+
+  const std::string m_path;
+  std::vector<Segment> m_segments;
+  mutable std::shared_timed_mutex m_mutexSegments;
+
+  static bool LoadSegment(const std::string& filename, Segment& segment);
+
+ public:
+  /// Constructor. Loads the indexes of the segments found under path.
+  explicit ColdStorage(const std::string& path);
+
+  /// Writes the records of the DS epoch dsBlockNum, spanning the TxBlocks
+  /// loTxBlockNum to hiTxBlockNum, into a new segment
+  bool PutSegment(const uint64_t& dsBlockNum, const uint64_t& loTxBlockNum,
+                  const uint64_t& hiTxBlockNum,
+                  const std::vector<Record>& records);
+
+  /// Retrieves a record from the newest segment holding it
+  bool Get(RecordType type, const dev::h256& key, bytes& value) const;
+
+  /// Returns the first TxBlock not yet covered by any segment
+  uint64_t GetNextTxBlockNum() const;
+
+  /// Deletes all segments
+  bool Reset();
+
+  /// Reloads the segment indexes from disk
+  bool Refresh();
+};
+
+#endif  // __COLDSTORAGE_H__
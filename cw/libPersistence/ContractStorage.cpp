@@ -17,6 +17,8 @@
 
 #include "ContractStorage.h"
 
+#include <memory>
+
 #include "libCrypto/Sha2.h"
 #include "libMessage/Messenger.h"
 #include "libUtils/DataConversion.h"
@@ -25,6 +27,27 @@
 using namespace std;
 
 namespace Contract {
+/// Converts a state entry to the {vname, type, value} JSON of the state APIs
+static bool StateEntryToJson(const StateEntry& entry, Json::Value& item) {
+  const string& tValue = std::get<VALUE>(entry);
+
+  item["vname"] = std::get<VNAME>(entry);
+  item["type"] = std::get<TYPE>(entry);
+  if (tValue[0] == '[' || tValue[0] == '{') {
+    Json::Value obj;
+
+    if (!JSONUtils::GetInstance().convertStrtoJson(tValue, obj)) {
+      return false;
+    }
+
+    item["value"] = obj;
+  } else {
+    item["value"] = tValue;
+  }
+
+  return true;
+}
+
 // Code
 // ======================================
 
@@ -53,39 +76,59 @@ bool ContractStorage::DeleteContractCode(const dev::h160& address) {
 // State
 // ========================================
 
-Index GetIndex(const dev::h160& address, const string& key,
-               unsigned int counter) {
+Index GetIndex(const dev::h160& address, const string& key) {
   SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
   sha2.Update(address.asBytes());
   sha2.Update(DataConversion::StringToCharArray(key));
-  if (counter != 0) {
-    sha2.Update(DataConversion::StringToCharArray(to_string(counter)));
+  return dev::h256(sha2.Finalize());
+}
+
+string GetStateKey(const dev::h160& address, const Index& index) {
+  string key(address.begin(), address.end());
+  key.append(index.begin(), index.end());
+  return key;
+}
+
+dev::h256 GetLegacyStorageRoot(const vector<pair<Index, bytes>>& entries) {
+  SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
+  for (const auto& entry : entries) {
+    sha2.Update(entry.second);
   }
   return dev::h256(sha2.Finalize());
 }
 
-bool ContractStorage::CheckIndexExists(const Index& index) {
-  shared_lock<shared_timed_mutex> g(m_stateIndexMutex);
-  auto t_found = t_stateDataMap.find(index.hex());
-  auto m_found = m_stateDataMap.find(index.hex());
-  return t_found != t_stateDataMap.end() || m_found != m_stateDataMap.end() ||
-         m_stateDataDB.Exists(index.hex());
+string StateTrieLayer::lookup(dev::h256 const& _h) const {
+  string ret = dev::MemoryDB::lookup(_h);
+  if (!ret.empty()) {
+    return ret;
+  }
+  return m_below ? m_below->lookup(_h) : m_db->lookup(_h);
 }
 
-Index ContractStorage::GetNewIndex(const dev::h160& address, const string& key,
-                                   const vector<Index>& existing_indexes) {
-  // LOG_MARKER();
-  Index index;
-  unsigned int counter = 0;
+bool StateTrieLayer::exists(dev::h256 const& _h) const {
+  if (dev::MemoryDB::exists(_h)) {
+    return true;
+  }
+  return m_below ? m_below->exists(_h) : m_db->exists(_h);
+}
+
+void StateTrieLayer::MergeDown() {
+  unique_lock<shared_timed_mutex> lock(x_this);
 
-  do {
-    index = GetIndex(address, key, counter);
-    counter++;
-  } while (find(existing_indexes.begin(), existing_indexes.end(), index) ==
-               existing_indexes.end() &&
-           CheckIndexExists(index));
+  // Keep the reference counts, so later tries in the layer below only kill a
+  // node once no root of that layer refers to it
+  for (const auto& node : m_main) {
+    for (unsigned int i = 0; i < node.second.second; i++) {
+      if (m_below) {
+        m_below->insert(node.first, dev::bytesConstRef(&node.second.first));
+      } else {
+        m_db->insert(node.first, dev::bytesConstRef(&node.second.first));
+      }
+    }
+  }
 
-  return index;
+  m_main.clear();
+  m_aux.clear();
 }
 
 bool ContractStorage::PutContractState(const dev::h160& address,
@@ -94,72 +137,113 @@ bool ContractStorage::PutContractState(const dev::h160& address,
   // LOG_MARKER();
   vector<pair<Index, bytes>> entries;
 
-  vector<Index> entry_indexes = GetContractStateIndexes(address, true);
-
   for (const auto& state : states) {
-    Index index = GetNewIndex(address, std::get<VNAME>(state), entry_indexes);
-
     bytes rawBytes;
     if (!Messenger::SetStateData(rawBytes, 0, state)) {
       LOG_GENERAL(WARNING, "Messenger::SetStateData failed");
       return false;
     }
 
-    entries.emplace_back(index, rawBytes);
+    entries.emplace_back(GetIndex(address, std::get<VNAME>(state)), rawBytes);
   }
 
-  return PutContractState(address, entries, stateHash, temp, false,
-                          entry_indexes, true);
+  return PutContractState(address, entries, stateHash, temp, false);
 }
 
 bool ContractStorage::PutContractState(
     const dev::h160& address, const vector<pair<Index, bytes>>& entries,
-    dev::h256& stateHash, bool temp, bool revertible,
-    const vector<Index>& existing_indexes, bool provideExisting) {
+    dev::h256& stateHash, bool temp, bool revertible) {
   // LOG_MARKER();
-  {
-    unique_lock<shared_timed_mutex> g(m_stateMainMutex);
+  unique_lock<shared_timed_mutex> g(m_stateMainMutex);
 
-    if (address == Address()) {
-      LOG_GENERAL(WARNING, "Null address rejected");
-      return false;
+  if (address == Address()) {
+    LOG_GENERAL(WARNING, "Null address rejected");
+    return false;
+  }
+
+  auto& stateData = temp ? t_stateDataMap[address] : m_stateDataMap[address];
+  for (const auto& entry : entries) {
+    if (!temp && revertible) {
+      // Keep the value from before the first change
+      auto m_found = stateData.find(entry.first);
+      r_stateDataMap[address].emplace(
+          entry.first,
+          m_found != stateData.end() ? m_found->second : bytes());
     }
+    stateData[entry.first] = entry.second;
+  }
 
-    vector<Index> entry_indexes;
+  auto& layer = temp ? t_stateTrie : (revertible ? r_stateTrie : m_stateTrie);
+  if (!UpdateContractStateTrie(address, entries, temp, layer, stateHash)) {
+    LOG_GENERAL(WARNING, "UpdateContractStateTrie failed");
+    return false;
+  }
 
-    if (provideExisting) {
-      entry_indexes = existing_indexes;
-    } else {
-      entry_indexes = GetContractStateIndexes(address, temp);
+  return true;
+}
+
+bool ContractStorage::UpdateContractStateTrie(
+    const dev::h160& address, const vector<pair<Index, bytes>>& entries,
+    bool temp, StateTrieLayer& layer, dev::h256& root, bool rebuild) {
+  auto insertState = [](StateTrie& trie, const Index& index,
+                        const bytes& rawState) {
+    if (rawState.empty()) {
+      trie.remove(index);
+      return;
     }
+    SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
+    sha2.Update(rawState);
+    trie.insert(index, sha2.Finalize());
+  };
 
-    unordered_map<string, string> batch;
+  try {
+    StateTrie trie(&layer);
 
-    for (const auto& entry : entries) {
-      // Append the new index to the existing indexes
-      if (find(entry_indexes.begin(), entry_indexes.end(), entry.first) ==
-          entry_indexes.end()) {
-        entry_indexes.emplace_back(entry.first);
+    // A new contract, or one whose storage is replaced as a whole, starts
+    // from an empty trie holding only the given entries
+    if (root == dev::h256()) {
+      trie.init();
+    } else {
+      try {
+        trie.setRoot(root);
+      } catch (const dev::RootNotFound&) {
+        LOG_GENERAL(WARNING, "State trie root " << root << " of contract "
+                                                << address << " not found");
+        return false;
       }
+    }
 
-      if (temp) {
-        t_stateDataMap[entry.first.hex()] = entry.second;
-      } else {
-        if (revertible) {
-          r_stateDataMap[entry.first.hex()] = m_stateDataMap[entry.first.hex()];
-        }
-        m_stateDataMap[entry.first.hex()] = entry.second;
+    if (rebuild) {
+      auto visit = [&trie, &insertState](const Index& index,
+                                         const bytes& rawState) -> bool {
+        insertState(trie, index, rawState);
+        return true;
+      };
+      ForEachContractState(address, temp, Index(), visit);
+    } else {
+      for (const auto& entry : entries) {
+        insertState(trie, entry.first, entry.second);
       }
     }
 
-    // Update the stateIndexDB
-    if (!SetContractStateIndexes(address, entry_indexes, temp, revertible)) {
-      LOG_GENERAL(WARNING, "SetContractStateIndex failed");
-      return false;
-    }
+    root = trie.root();
+  } catch (const std::exception& e) {
+    LOG_GENERAL(WARNING, "Exception caught: " << e.what());
+    return false;
   }
 
-  stateHash = GetContractStateHash(address, temp);
+  return true;
+}
+
+bool ContractStorage::RebuildContractStateTrie(const dev::h160& address,
+                                               dev::h256& root) {
+  unique_lock<shared_timed_mutex> g(m_stateMainMutex);
+
+  root = dev::h256();
+  if (!UpdateContractStateTrie(address, {}, false, m_stateTrie, root, true)) {
+    LOG_GENERAL(WARNING, "UpdateContractStateTrie failed");
+    return false;
+  }
 
   return true;
 }
@@ -167,192 +251,199 @@ bool ContractStorage::PutContractState(
 void ContractStorage::BufferCurrentState() {
   LOG_MARKER();
   shared_lock<shared_timed_mutex> g(m_stateMainMutex);
-  p_stateIndexMap = t_stateIndexMap;
   p_stateDataMap = t_stateDataMap;
+  p_stateTrie = t_stateTrie;
 }
 
 void ContractStorage::RevertPrevState() {
   LOG_MARKER();
   unique_lock<shared_timed_mutex> g(m_stateMainMutex);
-  t_stateIndexMap = std::move(p_stateIndexMap);
   t_stateDataMap = std::move(p_stateDataMap);
-}
-
-bool ContractStorage::SetContractStateIndexes(const dev::h160& address,
-                                              const std::vector<Index>& indexes,
-                                              bool temp, bool revertible) {
-  // LOG_MARKER();
-  unique_lock<shared_timed_mutex> g(m_stateIndexMutex);
-
-  bytes rawBytes;
-  if (!Messenger::SetStateIndex(rawBytes, 0, indexes)) {
-    LOG_GENERAL(WARNING, "Messenger::SetStateIndex failed.");
-    return false;
-  }
-
-  if (temp) {
-    t_stateIndexMap[address.hex()] = rawBytes;
-  } else {
-    if (revertible) {
-      r_stateIndexMap[address.hex()] = m_stateIndexMap[address.hex()];
-    }
-    m_stateIndexMap[address.hex()] = rawBytes;
-  }
-
-  return true;
+  t_stateTrie.Restore(p_stateTrie);
+  p_stateTrie.clear();
 }
 
 void ContractStorage::RevertContractStates() {
   LOG_MARKER();
   unique_lock<shared_timed_mutex> g(m_stateMainMutex);
 
-  for (const auto& acc : r_stateIndexMap) {
-    if (acc.second.empty()) {
-      m_stateIndexMap.erase(acc.first);
-    } else {
-      m_stateIndexMap[acc.first] = acc.second;
-    }
-  }
-  for (const auto& data : r_stateDataMap) {
-    if (data.second.empty()) {
-      m_stateDataMap.erase(data.first);
-    } else {
-      m_stateDataMap[data.first] = data.second;
+  for (const auto& contract : r_stateDataMap) {
+    auto& stateData = m_stateDataMap[contract.first];
+    for (const auto& data : contract.second) {
+      if (data.second.empty()) {
+        stateData.erase(data.first);
+      } else {
+        stateData[data.first] = data.second;
+      }
     }
   }
+
+  // The storage roots are reverted with the accounts, drop their new nodes
+  r_stateTrie.clear();
 }
 
 void ContractStorage::InitRevertibles() {
   LOG_MARKER();
   unique_lock<shared_timed_mutex> g(m_stateMainMutex);
-  r_stateIndexMap.clear();
   r_stateDataMap.clear();
+  r_stateTrie.MergeDown();
 }
 
-vector<Index> ContractStorage::GetContractStateIndexes(const dev::h160& address,
-                                                       bool temp) {
-  // get from stateIndexDB
-  // return DataConversion::StringToCharArray(m_codeDB.Lookup(address.hex()));
-  // LOG_MARKER();
-  shared_lock<shared_timed_mutex> g(m_stateIndexMutex);
+void ContractStorage::ForEachContractState(
+    const dev::h160& address, bool temp, const Index& from,
+    const function<bool(const Index&, const bytes&)>& visit) {
+  const leveldb::Slice prefix(reinterpret_cast<const char*>(address.data()),
+                             address.size);
+  const size_t keySize = address.size + Index::size;
+
+  // Merge the indexes of the DB, the main map and the temp map in order, the
+  // temp map taking precedence over the main map over the DB
+  unique_ptr<leveldb::Iterator> dbIt(
+      m_stateDataDB.GetDB()->NewIterator(leveldb::ReadOptions()));
+  dbIt->Seek(GetStateKey(address, from));
+
+  map<Index, bytes>::const_iterator m_it, m_end, t_it, t_end;
+  auto m_found = m_stateDataMap.find(address);
+  if (m_found != m_stateDataMap.end()) {
+    m_it = m_found->second.lower_bound(from);
+    m_end = m_found->second.end();
+  }
+  auto t_found = temp ? t_stateDataMap.find(address) : t_stateDataMap.end();
+  if (t_found != t_stateDataMap.end()) {
+    t_it = t_found->second.lower_bound(from);
+    t_end = t_found->second.end();
+  }
 
-  std::vector<Index> indexes;
+  while (true) {
+    const bool dbValid = dbIt->Valid() && dbIt->key().starts_with(prefix) &&
+                         dbIt->key().size() == keySize;
+    const Index dbIndex =
+        dbValid ? Index(reinterpret_cast<const unsigned char*>(
+                            dbIt->key().data() + address.size),
+                        Index::ConstructFromPointer)
+                : Index();
+    const bool m_valid = m_found != m_stateDataMap.end() && m_it != m_end;
+    const bool t_valid = t_found != t_stateDataMap.end() && t_it != t_end;
+
+    if (!dbValid && !m_valid && !t_valid) {
+      break;
+    }
 
-  bytes rawBytes;
+    const Index* index = dbValid ? &dbIndex : nullptr;
+    if (m_valid && (index == nullptr || m_it->first < *index)) {
+      index = &m_it->first;
+    }
+    if (t_valid && (index == nullptr || t_it->first < *index)) {
+      index = &t_it->first;
+    }
+    const Index key = *index;
 
-  auto t_found = t_stateIndexMap.find(address.hex());
-  auto m_found = m_stateIndexMap.find(address.hex());
-  if (temp && t_found != t_stateIndexMap.end()) {
-    rawBytes = t_found->second;
-  } else if (m_found != m_stateIndexMap.end()) {
-    rawBytes = m_found->second;
-  } else if (m_stateIndexDB.Exists(address.hex())) {
-    std::string rawString = m_stateIndexDB.Lookup(address.hex());
-    rawBytes = bytes(rawString.begin(), rawString.end());
-  } else {
-    return {};
-  }
+    const bool inDB = dbValid && dbIndex == key;
+    const bool inMain = m_valid && m_it->first == key;
+    const bool inTemp = t_valid && t_it->first == key;
 
-  if (!Messenger::GetStateIndex(rawBytes, 0, indexes)) {
-    LOG_GENERAL(WARNING, "Messenger::GetStateIndex failed.");
-    return {};
-  }
+    bytes rawState;
+    if (inTemp) {
+      rawState = t_it->second;
+    } else if (inMain) {
+      rawState = m_it->second;
+    } else {
+      const leveldb::Slice value = dbIt->value();
+      rawState.assign(value.data(), value.data() + value.size());
+    }
 
-  return indexes;
+    if (inDB) {
+      dbIt->Next();
+    }
+    if (inMain) {
+      m_it++;
+    }
+    if (inTemp) {
+      t_it++;
+    }
+
+    if (!visit(key, rawState)) {
+      break;
+    }
+  }
 }
 
-vector<bytes> ContractStorage::GetContractStatesData(const dev::h160& address,
-                                                     bool temp) {
+vector<Index> ContractStorage::GetContractStateIndexes(const dev::h160& address,
+                                                       bool temp) {
   // LOG_MARKER();
   shared_lock<shared_timed_mutex> g(m_stateMainMutex);
-  // get indexes
-  if (address == Address()) {
-    LOG_GENERAL(WARNING, "Null address rejected");
-    return {};
-  }
 
-  vector<Index> indexes = GetContractStateIndexes(address, temp);
+  vector<Index> indexes;
+  auto visit = [&indexes](const Index& index,
+                          [[gnu::unused]] const bytes& rawState) -> bool {
+    indexes.emplace_back(index);
+    return true;
+  };
+  ForEachContractState(address, temp, Index(), visit);
 
-  vector<bytes> rawStates;
+  return indexes;
+}
 
-  // return vector of raw protobuf string
-  for (const auto& index : indexes) {
-    auto t_found = t_stateDataMap.find(index.hex());
-    auto m_found = m_stateDataMap.find(index.hex());
-    if (temp && t_found != t_stateDataMap.end()) {
-      rawStates.push_back(t_found->second);
-    } else if (m_found != m_stateDataMap.end()) {
-      rawStates.push_back(m_found->second);
-    } else if (m_stateDataDB.Exists(index.hex())) {
-      std::string rawString = m_stateDataDB.Lookup(index.hex());
-      rawStates.push_back(bytes(rawString.begin(), rawString.end()));
-    } else {
-      rawStates.push_back({});
+bytes ContractStorage::GetContractStateRawData(const dev::h160& address,
+                                               const Index& index, bool temp) {
+  auto findState = [&address, &index](const StateDataMap& stateDataMap,
+                                      bytes& rawState) -> bool {
+    auto contract = stateDataMap.find(address);
+    if (contract == stateDataMap.end()) {
+      return false;
     }
+    auto found = contract->second.find(index);
+    if (found == contract->second.end()) {
+      return false;
+    }
+    rawState = found->second;
+    return true;
+  };
+
+  bytes rawState;
+  if ((temp && findState(t_stateDataMap, rawState)) ||
+      findState(m_stateDataMap, rawState)) {
+    return rawState;
   }
 
-  return rawStates;
+  bool found = false;
+  const string rawString =
+      m_stateDataDB.Lookup(GetStateKey(address, index), found);
+  if (found) {
+    rawState.assign(rawString.begin(), rawString.end());
+  }
+  return rawState;
 }
 
-string ContractStorage::GetContractStateData(const Index& index, bool temp) {
+string ContractStorage::GetContractStateData(const dev::h160& address,
+                                             const Index& index, bool temp) {
   // LOG_MARKER();
-  shared_lock<shared_timed_mutex> g(m_stateDataMutex);
-  auto t_found = t_stateDataMap.find(index.hex());
-  auto m_found = m_stateDataMap.find(index.hex());
-  if (temp && t_found != t_stateDataMap.end()) {
-    return DataConversion::CharArrayToString(t_found->second);
-  }
-  if (m_found != m_stateDataMap.end()) {
-    return DataConversion::CharArrayToString(m_found->second);
-  }
-  return m_stateDataDB.Lookup(index.hex());
+  shared_lock<shared_timed_mutex> g(m_stateMainMutex);
+  return DataConversion::CharArrayToString(
+      GetContractStateRawData(address, index, temp));
 }
 
 bool ContractStorage::CommitStateDB() {
   LOG_MARKER();
   unique_lock<shared_timed_mutex> g(m_stateMainMutex);
   // copy everything into m_stateXXDB;
-  // Index
   unordered_map<string, std::string> batch;
-  unordered_map<string, std::string> reset_buffer;
 
-  for (const auto& i : m_stateIndexMap) {
-    batch.insert({i.first, DataConversion::CharArrayToString(i.second)});
-    reset_buffer.insert({i.first, m_stateIndexDB.Lookup(i.first)});
-  }
-
-  if (!m_stateIndexDB.BatchInsert(batch)) {
-    LOG_GENERAL(WARNING, "BatchInsert m_stateIndexDB failed");
-    return false;
-  }
-  batch.clear();
-  // Data
-  for (const auto& i : m_stateDataMap) {
-    batch.insert({i.first, DataConversion::CharArrayToString(i.second)});
+  for (const auto& contract : m_stateDataMap) {
+    for (const auto& i : contract.second) {
+      batch.insert({GetStateKey(contract.first, i.first),
+                    DataConversion::CharArrayToString(i.second)});
+    }
   }
   if (!m_stateDataDB.BatchInsert(batch)) {
     LOG_GENERAL(WARNING, "BatchInsert m_stateDataDB failed");
-    // Reset the values in m_stateIndexDB
-    for (const auto& it : reset_buffer) {
-      if (it.second.empty()) {
-        if (m_stateIndexDB.DeleteKey(it.first) != 0) {
-          LOG_GENERAL(WARNING,
-                      "Something terrible happened, unable to clean the key in "
-                      "m_stateIndexDB");
-        }
-      } else {
-        if (m_stateIndexDB.Insert(
-                it.first, DataConversion::StringToCharArray(it.second)) != 0) {
-          LOG_GENERAL(WARNING,
-                      "Something terrible happened, unable to reset the key in "
-                      "m_stateIndexDB");
-        }
-      }
-    }
     return false;
   }
 
-  m_stateIndexMap.clear();
+  r_stateTrie.MergeDown();
+  m_stateTrie.MergeDown();
+  m_stateTrieDB.commit();
+
   m_stateDataMap.clear();
 
   InitTempState();
@@ -363,13 +454,14 @@ bool ContractStorage::CommitStateDB() {
 void ContractStorage::InitTempState() {
   LOG_MARKER();
 
-  t_stateIndexMap.clear();
   t_stateDataMap.clear();
+  t_stateTrie.clear();
+  p_stateTrie.clear();
 }
 
 bool ContractStorage::GetContractStateJson(
     const dev::h160& address, pair<Json::Value, Json::Value>& roots,
-    uint32_t& scilla_version, bool temp) {
+    uint32_t& scilla_version, bool temp, uint64_t maxSizeInBytes) {
   // LOG_MARKER();
 
   if (address == Address()) {
@@ -377,17 +469,30 @@ bool ContractStorage::GetContractStateJson(
     return false;
   }
 
-  // iterate and deserialize the vector of raw protobuf string
-  vector<bytes> rawStates = GetContractStatesData(address, temp);
+  shared_lock<shared_timed_mutex> g(m_stateMainMutex);
 
   bool hasScillaVersion = false;
+  bool success = true;
+  uint64_t sizeInBytes = 0;
   pair<Json::Value, Json::Value> t_roots;
   try {
-    for (const auto& rawState : rawStates) {
+    // read and deserialize the raw protobuf strings one at a time
+    auto visit = [&]([[gnu::unused]] const Index& index,
+                     const bytes& rawState) -> bool {
+      sizeInBytes += rawState.size();
+      if (maxSizeInBytes > 0 && sizeInBytes > maxSizeInBytes) {
+        LOG_GENERAL(WARNING, "State of contract " << address << " exceeds "
+                                                  << maxSizeInBytes
+                                                  << " bytes");
+        success = false;
+        return false;
+      }
+
       StateEntry entry;
       uint32_t version;
       if (!Messenger::GetStateData(rawState, 0, entry, version)) {
         LOG_GENERAL(WARNING, "Messenger::GetStateData failed.");
+        success = false;
         return false;
       }
 
@@ -396,6 +501,7 @@ bool ContractStorage::GetContractStateJson(
                                  << version
                                  << " is not match to CONTRACT_STATE_VERSION "
                                  << CONTRACT_STATE_VERSION);
+        success = false;
         return false;
       }
 
@@ -411,6 +517,7 @@ bool ContractStorage::GetContractStateJson(
         } catch (...) {
           LOG_GENERAL(WARNING,
                       "_scilla_version " << tValue << " is not a number");
+          success = false;
           return false;
         }
 
@@ -418,18 +525,8 @@ bool ContractStorage::GetContractStateJson(
       }
 
       Json::Value item;
-      item["vname"] = tVname;
-      item["type"] = tType;
-      if (tValue[0] == '[' || tValue[0] == '{') {
-        Json::Value obj;
-
-        if (!JSONUtils::GetInstance().convertStrtoJson(tValue, obj)) {
-          continue;
-        }
-
-        item["value"] = obj;
-      } else {
-        item["value"] = tValue;
+      if (!StateEntryToJson(entry, item)) {
+        return true;
       }
 
       if (!tMutable) {
@@ -437,12 +534,20 @@ bool ContractStorage::GetContractStateJson(
       } else {
         t_roots.second.append(item);
       }
-    }
+
+      return true;
+    };
+
+    ForEachContractState(address, temp, Index(), visit);
   } catch (const std::exception& e) {
     LOG_GENERAL(WARNING, "Exception caught: " << e.what());
     return false;
   }
 
+  if (!success) {
+    return false;
+  }
+
   if (!hasScillaVersion) {
     LOG_GENERAL(WARNING, "_scilla_version is not found in initData");
     return false;
@@ -453,21 +558,65 @@ bool ContractStorage::GetContractStateJson(
   return true;
 }
 
-dev::h256 ContractStorage::GetContractStateHash(const dev::h160& address,
-                                                bool temp) {
-  // LOG_MARKER();
+bool ContractStorage::GetContractStateJsonPage(const dev::h160& address,
+                                               const string& vnamePrefix,
+                                               const Index& cursor,
+                                               Json::Value& states,
+                                               Index& nextCursor, bool temp) {
   if (address == Address()) {
     LOG_GENERAL(WARNING, "Null address rejected");
-    return dev::h256();
+    return false;
   }
 
-  // iterate the raw protobuf string and hash
-  vector<bytes> rawStates = GetContractStatesData(address, temp);
-  SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
-  for (const auto& rawState : rawStates) {
-    sha2.Update(rawState);
+  shared_lock<shared_timed_mutex> g(m_stateMainMutex);
+
+  states = Json::arrayValue;
+  nextCursor = Index();
+
+  bool success = true;
+  unsigned int numEntries = 0;
+  uint64_t sizeInBytes = 0;
+  try {
+    auto visit = [&](const Index& index, const bytes& rawState) -> bool {
+      if (numEntries >= CONTRACT_STATE_PAGE_SIZE ||
+          sizeInBytes >= CONTRACT_STATE_PAGE_SIZE_IN_BYTES) {
+        nextCursor = index;
+        return false;
+      }
+
+      // Entries skipped by the prefix also count, to bound the reads per page
+      sizeInBytes += rawState.size();
+
+      StateEntry entry;
+      uint32_t version;
+      if (!Messenger::GetStateData(rawState, 0, entry, version)) {
+        LOG_GENERAL(WARNING, "Messenger::GetStateData failed.");
+        success = false;
+        return false;
+      }
+
+      if (!std::get<MUTABLE>(entry) ||
+          std::get<VNAME>(entry).compare(0, vnamePrefix.size(), vnamePrefix) !=
+              0) {
+        return true;
+      }
+
+      Json::Value item;
+      if (StateEntryToJson(entry, item)) {
+        states.append(item);
+        numEntries++;
+      }
+
+      return true;
+    };
+
+    ForEachContractState(address, temp, cursor, visit);
+  } catch (const std::exception& e) {
+    LOG_GENERAL(WARNING, "Exception caught: " << e.what());
+    return false;
   }
-  return dev::h256(sha2.Finalize());
+
+  return success;
 }
 
 void ContractStorage::Reset() {
@@ -477,14 +626,13 @@ void ContractStorage::Reset() {
   }
   {
     unique_lock<shared_timed_mutex> g(m_stateMainMutex);
-    {
-      unique_lock<shared_timed_mutex> g(m_stateIndexMutex);
-      m_stateIndexDB.ResetDB();
-    }
-    {
-      unique_lock<shared_timed_mutex> g(m_stateDataMutex);
-      m_stateDataDB.ResetDB();
-    }
+    m_stateDataDB.ResetDB();
+    m_stateTrie.clear();
+    r_stateTrie.clear();
+    t_stateTrie.clear();
+    p_stateTrie.clear();
+    m_stateTrieDB.ResetDB();
+    m_legacyStateIndexDB.ResetDB();
   }
 }
 
@@ -496,16 +644,67 @@ bool ContractStorage::RefreshAll() {
   }
   if (ret) {
     unique_lock<shared_timed_mutex> g(m_stateMainMutex);
-    {
-      unique_lock<shared_timed_mutex> g(m_stateIndexMutex);
-      ret = m_stateIndexDB.RefreshDB();
+    ret = m_stateDataDB.RefreshDB() && m_stateTrieDB.RefreshDB() &&
+          m_legacyStateIndexDB.RefreshDB();
+  }
+  return ret;
+}
+
+bool ContractStorage::MigrateLegacyStateIndexes() {
+  LOG_MARKER();
+  unique_lock<shared_timed_mutex> g(m_stateMainMutex);
+
+  // Previously each contract had the list of its state indexes stored under
+  // its address, and each state was stored under its index alone
+  unique_ptr<leveldb::Iterator> it(
+      m_legacyStateIndexDB.GetDB()->NewIterator(leveldb::ReadOptions()));
+
+  vector<string> migrated;
+  for (it->SeekToFirst(); it->Valid(); it->Next()) {
+    const string addressHex = it->key().ToString();
+    const leveldb::Slice value = it->value();
+
+    vector<Index> indexes;
+    if (!Messenger::GetStateIndex(
+            bytes(value.data(), value.data() + value.size()), 0, indexes)) {
+      LOG_GENERAL(WARNING, "Messenger::GetStateIndex failed for contract "
+                               << addressHex);
+      return false;
     }
-    if (ret) {
-      unique_lock<shared_timed_mutex> g(m_stateDataMutex);
-      ret = m_stateDataDB.RefreshDB();
+
+    const dev::h160 address(addressHex);
+    unordered_map<string, string> batch;
+    for (const auto& index : indexes) {
+      bool found = false;
+      string rawString = m_stateDataDB.Lookup(index.hex(), found);
+      if (found) {
+        batch.emplace(GetStateKey(address, index), move(rawString));
+      }
     }
+
+    if (!m_stateDataDB.BatchInsert(batch)) {
+      LOG_GENERAL(WARNING, "BatchInsert m_stateDataDB failed for contract "
+                               << addressHex);
+      return false;
+    }
+
+    for (const auto& index : indexes) {
+      m_stateDataDB.DeleteKey(index.hex());
+    }
+
+    migrated.emplace_back(addressHex);
   }
-  return ret;
+
+  for (const auto& addressHex : migrated) {
+    m_legacyStateIndexDB.DeleteKey(addressHex);
+  }
+
+  if (!migrated.empty()) {
+    LOG_GENERAL(INFO, "Migrated the states of " << migrated.size()
+                                                << " contracts");
+  }
+
+  return true;
 }
 
-}  // namespace Contract
\ No newline at end of file
+}  // namespace Contract
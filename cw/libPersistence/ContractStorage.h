@@ -20,7 +20,10 @@
 
 #include <json/json.h>
 #include <leveldb/db.h>
+#include <functional>
+#include <map>
 #include <shared_mutex>
+#include <unordered_map>
 
 #include "common/Constants.h"
 #include "common/Singleton.h"
@@ -35,55 +38,124 @@
 
 namespace Contract {
 
+/// Returns the index of the state key of a contract
 Index GetIndex(const dev::h160& address, const std::string& key);
 
+/// Returns the binary storage key of a state, the contract address followed by
+/// the index
+std::string GetStateKey(const dev::h160& address, const Index& index);
+
+/// Returns the storage root of the previous format, the hash of the raw states
+/// in the order of the entries
+dev::h256 GetLegacyStorageRoot(
+    const std::vector<std::pair<Index, bytes>>& entries);
+
+/// Nodes of the contract state tries not yet committed, layered over the
+/// nodes below them. Each state writes its tries to its own layer, so the
+/// nodes of temp or reverted executions are dropped with that layer and never
+/// reach the database.
+class StateTrieLayer : public dev::MemoryDB {
+  StateTrieLayer* m_below;
+  dev::OverlayDB* m_db;
+
+ public:
+  /// Constructor for the bottom layer, over the committed nodes in db
+  explicit StateTrieLayer(dev::OverlayDB& db) : m_below(nullptr), m_db(&db) {}
+
+  /// Constructor for a layer over below
+  explicit StateTrieLayer(StateTrieLayer& below)
+      : m_below(&below), m_db(nullptr) {}
+
+  StateTrieLayer(const StateTrieLayer&) = delete;
+
+  StateTrieLayer& operator=(const StateTrieLayer&) = delete;
+
+  std::string lookup(dev::h256 const& _h) const;
+
+  bool exists(dev::h256 const& _h) const;
+
+  /// Replaces the nodes of this layer with a copy taken earlier
+  void Restore(const dev::MemoryDB& nodes) { dev::MemoryDB::operator=(nodes); }
+
+  /// Moves the live nodes of this layer into the layer or database below
+  void MergeDown();
+};
+
+/// Commits the states of a contract, mapping each Index to the hash of its
+/// raw state. The root of the trie is the storage root of the contract.
+using StateTrie =
+    dev::SpecificTrieDB<dev::GenericTrieDB<StateTrieLayer>, Index>;
+
 class ContractStorage : public Singleton<ContractStorage> {
   LevelDB m_codeDB;
 
-  LevelDB m_stateIndexDB;
+  // States are keyed by GetStateKey(address, index), so that the states of a
+  // contract are contiguous and ordered by index
   LevelDB m_stateDataDB;
+  dev::OverlayDB m_stateTrieDB;
+
+  // Per-contract index lists of the previous layout, only read for migration
+  LevelDB m_legacyStateIndexDB;
+
+  // Raw states of each contract, ordered by index
+  using StateDataMap = std::unordered_map<dev::h160, std::map<Index, bytes>>;
 
   // Used by AccountStore
-  std::unordered_map<std::string, bytes> m_stateIndexMap;
-  std::unordered_map<std::string, bytes> m_stateDataMap;
+  StateDataMap m_stateDataMap;
 
   // Used by AccountStoreTemp for StateDelta
-  std::unordered_map<std::string, bytes> t_stateIndexMap;
-  std::unordered_map<std::string, bytes> t_stateDataMap;
+  StateDataMap t_stateDataMap;
 
   // Used for RevertCommitTemp
-  std::unordered_map<std::string, bytes> r_stateIndexMap;
-  std::unordered_map<std::string, bytes> r_stateDataMap;
+  StateDataMap r_stateDataMap;
 
   // Used for revert state due to failure in chain call
-  std::unordered_map<std::string, bytes> p_stateIndexMap;
-  std::unordered_map<std::string, bytes> p_stateDataMap;
+  StateDataMap p_stateDataMap;
+
+  // Uncommitted state trie nodes of m_, r_ and t_stateDataMap, each layered
+  // over the one before it
+  StateTrieLayer m_stateTrie;
+  StateTrieLayer r_stateTrie;
+  StateTrieLayer t_stateTrie;
+
+  // Copy of t_stateTrie buffered together with p_stateDataMap
+  dev::MemoryDB p_stateTrie;
 
   mutable std::shared_timed_mutex m_codeMutex;
   mutable std::shared_timed_mutex m_stateMainMutex;
-  mutable std::shared_timed_mutex m_stateIndexMutex;
-  mutable std::shared_timed_mutex m_stateDataMutex;
 
-  /// Set the indexes of all the states of an contract account
-  bool SetContractStateIndexes(const dev::h160& address,
-                               const std::vector<Index>& indexes, bool temp,
-                               bool revertible);
-
-  /// Get the raw rlp string of the states of an account
-  std::vector<bytes> GetContractStatesData(const dev::h160& address, bool temp);
+  /// Visits the states of a contract in index order, starting at index from,
+  /// until visit returns false. Caller must hold m_stateMainMutex
+  void ForEachContractState(
+      const dev::h160& address, bool temp, const Index& from,
+      const std::function<bool(const Index&, const bytes&)>& visit);
+
+  /// Get the raw protobuf string of a state of a contract, caller must hold
+  /// m_stateMainMutex
+  bytes GetContractStateRawData(const dev::h160& address, const Index& index,
+                                bool temp);
+
+  /// Applies the changed entries to the state trie of the contract at root,
+  /// writing the new nodes to layer, and sets root to the new root. An unset
+  /// root starts an empty trie. If rebuild is set, all the states of the
+  /// contract are applied instead of the entries. Caller must hold
+  /// m_stateMainMutex
+  bool UpdateContractStateTrie(
+      const dev::h160& address,
+      const std::vector<std::pair<Index, bytes>>& entries, bool temp,
+      StateTrieLayer& layer, dev::h256& root, bool rebuild = false);
 
   ContractStorage()
       : m_codeDB("contractCode"),
-        m_stateIndexDB("contractStateIndex"),
-        m_stateDataDB("contractStateData"){};
+        m_stateDataDB("contractStateData"),
+        m_stateTrieDB("contractStateTrie"),
+        m_legacyStateIndexDB("contractStateIndex"),
+        m_stateTrie(m_stateTrieDB),
+        r_stateTrie(m_stateTrie),
+        t_stateTrie(r_stateTrie){};
 
   ~ContractStorage() = default;
 
-  Index GetNewIndex(const dev::h160& address, const std::string& key,
-                    const std::vector<Index>& existing_indexes);
-
-  bool CheckIndexExists(const Index& index);
-
  public:
   /// Returns the singleton ContractStorage instance.
   static ContractStorage& GetContractStorage() {
@@ -108,19 +180,23 @@ class ContractStorage : public Singleton<ContractStorage> {
   std::vector<Index> GetContractStateIndexes(const dev::h160& address,
                                              bool temp);
 
-  /// Get the raw protobuf string of the state by a index
-  std::string GetContractStateData(const Index& index, bool temp);
+  /// Get the raw protobuf string of a state of a contract by its index
+  std::string GetContractStateData(const dev::h160& address,
+                                   const Index& index, bool temp);
 
-  /// Put one's contract states in database
+  /// Put one's contract states in database. stateHash is the current
+  /// storage root of the contract, updated with the changed states only.
   bool PutContractState(const dev::h160& address,
                         const std::vector<StateEntry>& states,
                         dev::h256& stateHash, bool temp);
 
   bool PutContractState(const dev::h160& address,
                         const std::vector<std::pair<Index, bytes>>& entries,
-                        dev::h256& stateHash, bool temp, bool revertible,
-                        const std::vector<Index>& existing_indexes = {},
-                        bool provideExisting = false);
+                        dev::h256& stateHash, bool temp, bool revertible);
+
+  /// Builds the state trie of a contract from its committed states and sets
+  /// root to its root. The nodes are written to the DB by CommitStateDB
+  bool RebuildContractStateTrie(const dev::h160& address, dev::h256& root);
 
   /// Buffer the current t_map into p_map
   void BufferCurrentState();
@@ -134,13 +210,20 @@ class ContractStorage : public Singleton<ContractStorage> {
   /// Clean t_maps
   void InitTempState();
 
-  /// Get the json formatted data of the states for a contract account
+  /// Get the json formatted data of the states for a contract account,
+  /// failing if the raw states exceed maxSizeInBytes (0 for no limit)
   bool GetContractStateJson(const dev::h160& address,
                             std::pair<Json::Value, Json::Value>& roots,
-                            uint32_t& scilla_version, bool temp);
+                            uint32_t& scilla_version, bool temp,
+                            uint64_t maxSizeInBytes = 0);
 
-  /// Get the state hash of a contract account
-  dev::h256 GetContractStateHash(const dev::h160& address, bool temp);
+  /// Get one page of the mutable states whose name starts with vnamePrefix,
+  /// starting at the state index cursor. nextCursor is empty once the last
+  /// state has been read.
+  bool GetContractStateJsonPage(const dev::h160& address,
+                                const std::string& vnamePrefix,
+                                const Index& cursor, Json::Value& states,
+                                Index& nextCursor, bool temp);
 
   /// Clean the databases
   void Reset();
@@ -153,6 +236,10 @@ class ContractStorage : public Singleton<ContractStorage> {
 
   /// Refresh all DB
   bool RefreshAll();
+
+  /// Moves the states stored with per-contract index lists to the keys used
+  /// now. Does nothing once done.
+  bool MigrateLegacyStateIndexes();
 };
 
 }  // namespace Contract
@@ -406,19 +406,25 @@ bool Retriever::RetrieveStates() {
 bool Retriever::ValidateStates() {
   LOG_MARKER();
 
-  if (m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetStateRootHash() ==
-      AccountStore::GetInstance().GetStateRootHash()) {
+  const dev::h256 blockRoot = m_mediator.m_txBlockChain.GetLastBlockPtr()
+                                  ->GetHeader()
+                                  .GetStateRootHash();
+  if (blockRoot == AccountStore::GetInstance().GetStateRootHash()) {
     LOG_GENERAL(INFO, "ValidateStates passed.");
     return true;
+  } else if (AccountStore::GetInstance().IsMigratedFrom(blockRoot)) {
+    // The final block predates the migration of the contract storage roots
+    LOG_GENERAL(INFO, "ValidateStates passed with migrated storage roots.");
+    return true;
   } else {
     LOG_GENERAL(WARNING, "ValidateStates failed.");
     LOG_GENERAL(INFO, "StateRoot in FinalBlock(BlockNum: "
-                          << m_mediator.m_txBlockChain.GetLastBlock()
-                                 .GetHeader()
+                          << m_mediator.m_txBlockChain.GetLastBlockPtr()
+                                 ->GetHeader()
                                  .GetBlockNum()
                           << "): "
-                          << m_mediator.m_txBlockChain.GetLastBlock()
-                                 .GetHeader()
+                          << m_mediator.m_txBlockChain.GetLastBlockPtr()
+                                 ->GetHeader()
                                  .GetStateRootHash()
                           << '\n'
                           << "Retrieved StateRoot: "
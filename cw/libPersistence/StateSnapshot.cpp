@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "StateSnapshot.h"
+
+#include <algorithm>
+
+#include "common/Constants.h"
+#include "libCrypto/Sha2.h"
+#include "libData/AccountData/AccountStore.h"
+#include "libMessage/Messenger.h"
+#include "libUtils/Logger.h"
+
+using namespace std;
+
+dev::h256 StateSnapshot::GetChunkHash(const bytes& chunk) {
+  SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
+  sha2.Update(chunk);
+  return dev::h256(sha2.Finalize());
+}
+
+bool StateSnapshot::Export(const uint64_t& txBlockNum,
+                           const dev::h256& txBlockStateRoot) {
+  LOG_MARKER();
+
+  vector<bytes> chunks;
+  if (!AccountStore::GetInstance().SerializeChunks(
+          chunks, STATE_SNAPSHOT_CHUNK_SIZE_IN_BYTES)) {
+    LOG_GENERAL(WARNING, "AccountStore::SerializeChunks failed");
+    return false;
+  }
+
+  // The state may have moved on while it was being serialized
+  const dev::h256 stateRoot = AccountStore::GetInstance().GetStateRootHash();
+  if (stateRoot != txBlockStateRoot) {
+    LOG_GENERAL(WARNING, "State root " << stateRoot
+                                       << " does not match that of TxBlock "
+                                       << txBlockNum << " "
+                                       << txBlockStateRoot);
+    return false;
+  }
+
+  lock_guard<mutex> g(m_mutex);
+
+  m_manifest.m_txBlockNum = txBlockNum;
+  m_manifest.m_stateRoot = stateRoot;
+  m_manifest.m_chunkHashes.clear();
+  m_chunks.clear();
+  m_importedChunks.clear();
+
+  for (auto& chunk : chunks) {
+    const dev::h256 chunkHash = GetChunkHash(chunk);
+    m_manifest.m_chunkHashes.emplace_back(chunkHash);
+    m_chunks.emplace(chunkHash, make_shared<const bytes>(move(chunk)));
+  }
+
+  LOG_GENERAL(INFO, "Exported state of TxBlock "
+                        << txBlockNum << " in " << m_chunks.size()
+                        << " chunks");
+
+  return true;
+}
+
+shared_ptr<const bytes> StateSnapshot::GetChunk(
+    const dev::h256& chunkHash) const {
+  lock_guard<mutex> g(m_mutex);
+
+  auto it = m_chunks.find(chunkHash);
+  if (it == m_chunks.end()) {
+    return nullptr;
+  }
+
+  return it->second;
+}
+
+StateSnapshotManifest StateSnapshot::GetManifest() const {
+  lock_guard<mutex> g(m_mutex);
+  return m_manifest;
+}
+
+void StateSnapshot::StartImport(const StateSnapshotManifest& manifest) {
+  LOG_MARKER();
+
+  lock_guard<mutex> g(m_mutex);
+
+  m_manifest = manifest;
+  m_chunks.clear();
+  m_importedChunks.clear();
+
+  AccountStore::GetInstance().Init();
+}
+
+bool StateSnapshot::ImportChunk(const bytes& chunk) {
+  const dev::h256 chunkHash = GetChunkHash(chunk);
+
+  lock_guard<mutex> g(m_mutex);
+
+  if (find(m_manifest.m_chunkHashes.begin(), m_manifest.m_chunkHashes.end(),
+           chunkHash) == m_manifest.m_chunkHashes.end()) {
+    LOG_GENERAL(WARNING, "Chunk " << chunkHash << " not in manifest");
+    return false;
+  }
+
+  if (m_importedChunks.find(chunkHash) != m_importedChunks.end()) {
+    return true;
+  }
+
+  // Code and storage of every contract account are checked against the
+  // account's code hash and storage root while deserializing
+  if (!AccountStore::GetInstance().DeserializeChunk(chunk, 0)) {
+    LOG_GENERAL(WARNING, "AccountStore::DeserializeChunk failed for chunk "
+                             << chunkHash);
+    return false;
+  }
+
+  m_importedChunks.emplace(chunkHash);
+
+  return true;
+}
+
+vector<dev::h256> StateSnapshot::GetMissingChunks() const {
+  lock_guard<mutex> g(m_mutex);
+
+  vector<dev::h256> missingChunks;
+  for (const auto& chunkHash : m_manifest.m_chunkHashes) {
+    if (m_importedChunks.find(chunkHash) == m_importedChunks.end()) {
+      missingChunks.emplace_back(chunkHash);
+    }
+  }
+
+  return missingChunks;
+}
+
+bool StateSnapshot::IsImportComplete() const {
+  lock_guard<mutex> g(m_mutex);
+  return m_importedChunks.size() == m_manifest.m_chunkHashes.size();
+}
+
+bool StateSnapshot::FinishImport() const {
+  LOG_MARKER();
+
+  if (!IsImportComplete()) {
+    LOG_GENERAL(WARNING, "Snapshot import is incomplete");
+    return false;
+  }
+
+  const dev::h256 stateRoot = AccountStore::GetInstance().GetStateRootHash();
+
+  lock_guard<mutex> g(m_mutex);
+  if (stateRoot != m_manifest.m_stateRoot) {
+    LOG_CHECK_FAIL("State root", stateRoot, m_manifest.m_stateRoot);
+    return false;
+  }
+
+  LOG_GENERAL(INFO, "Imported state of TxBlock " << m_manifest.m_txBlockNum);
+
+  return true;
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __STATESNAPSHOT_H__
+#define __STATESNAPSHOT_H__
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "common/BaseType.h"
+#include "depends/common/FixedHash.h"
+
+/// Describes a state snapshot: the content hashes of the chunks holding the
+/// accounts of the state committed by the TxBlock m_txBlockNum
+struct StateSnapshotManifest {
+  uint64_t m_txBlockNum = 0;
+  dev::h256 m_stateRoot;
+  std::vector<dev::h256> m_chunkHashes;
+};
+
+/// Account state split into content-addressed chunks, used to bootstrap
+/// nodes without transferring the whole state in a single message.
+/// The exporting side serves chunks by hash; the importing side checks every
+/// chunk against the manifest, applies it directly to the AccountStore, and
+/// finally checks the resulting state root against the manifest.
+class StateSnapshot {
+  StateSnapshotManifest m_manifest;
+  std::unordered_map<dev::h256, std::shared_ptr<const bytes>> m_chunks;
+  std::unordered_set<dev::h256> m_importedChunks;
+  mutable std::mutex m_mutex;
+
+ public:
+  /// Returns the content hash of a chunk
+  static dev::h256 GetChunkHash(const bytes& chunk);
+
+  /// Splits the current AccountStore state into chunks. Fails if the state
+  /// does not match the state root of the TxBlock txBlockNum.
+  bool Export(const uint64_t& txBlockNum, const dev::h256& txBlockStateRoot);
+
+  /// Returns the chunk with the given hash, or nullptr if not part of this
+  /// snapshot
+  std::shared_ptr<const bytes> GetChunk(const dev::h256& chunkHash) const;
+
+  StateSnapshotManifest GetManifest() const;
+
+  /// Resets the AccountStore and prepares to import the given snapshot
+  void StartImport(const StateSnapshotManifest& manifest);
+
+  /// Checks the chunk against the manifest and applies it to the AccountStore
+  bool ImportChunk(const bytes& chunk);
+
+  /// Returns the hashes of the chunks that still need to be imported
+  std::vector<dev::h256> GetMissingChunks() const;
+
+  bool IsImportComplete() const;
+
+  /// Checks that the imported state matches the manifest state root
+  bool FinishImport() const;
+};
+
+#endif  // __STATESNAPSHOT_H__
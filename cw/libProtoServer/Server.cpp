@@ -78,7 +78,7 @@ Server::~Server() {
 
 uint256_t Server::GetNumTransactions(uint64_t blockNum) {
   uint64_t currBlockNum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
 
   if (blockNum >= currBlockNum) {
     return 0;
@@ -86,7 +86,7 @@ uint256_t Server::GetNumTransactions(uint64_t blockNum) {
 
   uint64_t i, res = 0;
   for (i = blockNum + 1; i <= currBlockNum; i++) {
-    res += m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetNumTxs();
+    res += m_mediator.m_txBlockChain.GetBlockPtr(i)->GetHeader().GetNumTxs();
   }
 
   return res;
@@ -350,11 +350,11 @@ GetDSBlockResponse Server::GetDsBlock(ProtoBlockNum& protoBlockNum) {
     uint64_t blockNum = protoBlockNum.blocknum();
 
     // Get the DS block.
-    DSBlock dsblock = m_mediator.m_dsBlockChain.GetBlock(blockNum);
+    const auto dsblock = m_mediator.m_dsBlockChain.GetBlockPtr(blockNum);
 
     // Convert DSBlock to proto.
     ProtoDSBlock protoDSBlock;
-    DSBlockToProtobuf(dsblock, protoDSBlock);
+    DSBlockToProtobuf(*dsblock, protoDSBlock);
     ret.set_allocated_dsblock(&protoDSBlock);
   } catch (const char* msg) {
     ret.set_error(msg);
@@ -391,11 +391,11 @@ GetTxBlockResponse Server::GetTxBlock(ProtoBlockNum& protoBlockNum) {
     uint64_t blockNum = protoBlockNum.blocknum();
 
     // Get the tx block.
-    TxBlock txblock = m_mediator.m_txBlockChain.GetBlock(blockNum);
+    const auto txblock = m_mediator.m_txBlockChain.GetBlockPtr(blockNum);
 
     // Convert txblock to proto.
     ProtoTxBlock protoTxBlock;
-    TxBlockToProtobuf(txblock, protoTxBlock);
+    TxBlockToProtobuf(*txblock, protoTxBlock);
     ret.set_allocated_txblock(&protoTxBlock);
   } catch (const char* msg) {
     ret.set_error(msg);
@@ -425,15 +425,15 @@ GetDSBlockResponse Server::GetLatestDsBlock() {
   GetDSBlockResponse ret;
 
   // Retrieve the latest DS block.
-  DSBlock dsblock = m_mediator.m_dsBlockChain.GetLastBlock();
+  const auto dsblock = m_mediator.m_dsBlockChain.GetLastBlockPtr();
 
   LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
-            "BlockNum " << dsblock.GetHeader().GetBlockNum()
-                        << "  Timestamp:        " << dsblock.GetTimestamp());
+            "BlockNum " << dsblock->GetHeader().GetBlockNum()
+                        << "  Timestamp:        " << dsblock->GetTimestamp());
 
   // Convert DSBlock to proto.
   ProtoDSBlock protoDSBlock;
-  DSBlockToProtobuf(dsblock, protoDSBlock);
+  DSBlockToProtobuf(*dsblock, protoDSBlock);
   ret.set_allocated_dsblock(&protoDSBlock);
 
   return ret;
@@ -445,15 +445,15 @@ GetTxBlockResponse Server::GetLatestTxBlock() {
   GetTxBlockResponse ret;
 
   // Get the latest tx block.
-  TxBlock txblock = m_mediator.m_txBlockChain.GetLastBlock();
+  const auto txblock = m_mediator.m_txBlockChain.GetLastBlockPtr();
 
   LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
-            "BlockNum " << txblock.GetHeader().GetBlockNum()
-                        << "  Timestamp:        " << txblock.GetTimestamp());
+            "BlockNum " << txblock->GetHeader().GetBlockNum()
+                        << "  Timestamp:        " << txblock->GetTimestamp());
 
   // Convert txblock to proto.
   ProtoTxBlock protoTxBlock;
-  TxBlockToProtobuf(txblock, protoTxBlock);
+  TxBlockToProtobuf(*txblock, protoTxBlock);
   ret.set_allocated_txblock(&protoTxBlock);
 
   return ret;
@@ -544,8 +544,12 @@ GetSmartContractStateResponse Server::GetSmartContractState(
     }
 
     pair<Json::Value, Json::Value> roots;
-    if (!account->GetStorageJson(roots, false)) {
-      ret.set_error("Scilla_version not set properly");
+    uint32_t scilla_version;
+    if (!account->GetStorageJson(roots, false, scilla_version,
+                                 CONTRACT_STATE_JSON_MAX_SIZE_IN_BYTES)) {
+      ret.set_error(CONTRACT_STATE_JSON_MAX_SIZE_IN_BYTES > 0
+                        ? "Scilla_version not set properly or state too large"
+                        : "Scilla_version not set properly");
       return ret;
     }
 
@@ -742,11 +746,11 @@ StringResponse Server::GetNumTransactions() {
   LOG_MARKER();
 
   uint64_t currBlock =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
   if (m_BlockTxPair.first < currBlock) {
     for (uint64_t i = m_BlockTxPair.first + 1; i <= currBlock; i++) {
       m_BlockTxPair.second +=
-          m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetNumTxs();
+          m_mediator.m_txBlockChain.GetBlockPtr(i)->GetHeader().GetNumTxs();
     }
   }
   m_BlockTxPair.first = currBlock;
@@ -762,7 +766,7 @@ DoubleResponse Server::GetTransactionRate() {
   DoubleResponse ret;
 
   uint64_t refBlockNum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
 
   uint64_t refTimeTx = 0;
 
@@ -784,8 +788,8 @@ DoubleResponse Server::GetTransactionRate() {
   LOG_GENERAL(INFO, "Num Txns: " << numTxns);
 
   try {
-    TxBlock tx = m_mediator.m_txBlockChain.GetBlock(refBlockNum);
-    refTimeTx = tx.GetTimestamp();
+    const auto tx = m_mediator.m_txBlockChain.GetBlockPtr(refBlockNum);
+    refTimeTx = tx->GetTimestamp();
   } catch (const char* msg) {
     if (string(msg) == "Blocknumber Absent") {
       LOG_GENERAL(INFO, "Error in fetching ref block");
@@ -795,7 +799,7 @@ DoubleResponse Server::GetTransactionRate() {
   }
 
   uint64_t TimeDiff =
-      m_mediator.m_txBlockChain.GetLastBlock().GetTimestamp() - refTimeTx;
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetTimestamp() - refTimeTx;
 
   if (TimeDiff == 0 || refTimeTx == 0) {
     // something went wrong
@@ -824,8 +828,7 @@ DoubleResponse Server::GetDSBlockRate() {
   if (m_StartTimeDs == 0) {  // case when m_StartTime has not been set
     try {
       // Refernce time chosen to be the first block's timestamp
-      DSBlock dsb = m_mediator.m_dsBlockChain.GetBlock(1);
-      m_StartTimeDs = dsb.GetTimestamp();
+      m_StartTimeDs = m_mediator.m_dsBlockChain.GetBlockPtr(1)->GetTimestamp();
     } catch (const char* msg) {
       if (string(msg) == "Blocknumber Absent") {
         LOG_GENERAL(INFO, "No DSBlock has been mined yet");
@@ -836,7 +839,8 @@ DoubleResponse Server::GetDSBlockRate() {
   }
 
   uint64_t TimeDiff =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetTimestamp() - m_StartTimeDs;
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetTimestamp() -
+      m_StartTimeDs;
 
   if (TimeDiff == 0) {
     LOG_GENERAL(INFO, "Wait till the second block");
@@ -864,8 +868,7 @@ DoubleResponse Server::GetTxBlockRate() {
   if (m_StartTimeTx == 0) {
     try {
       // Reference Time chosen to be first block's timestamp
-      TxBlock txb = m_mediator.m_txBlockChain.GetBlock(1);
-      m_StartTimeTx = txb.GetTimestamp();
+      m_StartTimeTx = m_mediator.m_txBlockChain.GetBlockPtr(1)->GetTimestamp();
     } catch (const char* msg) {
       if (string(msg) == "Blocknumber Absent") {
         LOG_GENERAL(INFO, "No TxBlock has been mined yet");
@@ -876,7 +879,8 @@ DoubleResponse Server::GetTxBlockRate() {
   }
 
   uint64_t TimeDiff =
-      m_mediator.m_txBlockChain.GetLastBlock().GetTimestamp() - m_StartTimeTx;
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetTimestamp() -
+      m_StartTimeTx;
 
   if (TimeDiff == 0) {
     LOG_GENERAL(INFO, "Wait till the second block");
@@ -905,7 +909,7 @@ UInt64Response Server::GetCurrentDSEpoch() {
 
   UInt64Response ret;
   ret.set_result(
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum());
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum());
   return ret;
 }
 
@@ -919,14 +923,15 @@ ProtoBlockListing Server::DSBlockListing(ProtoPage& protoPage) {
   }
 
   uint64_t currBlockNum =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
   auto maxPages = (currBlockNum / PAGE_SIZE) + 1;
   ret.set_maxpages(int(maxPages));
 
   if (m_DSBlockCache.second.size() == 0) {
     try {
       // add the hash of genesis block
-      DSBlockHeader dshead = m_mediator.m_dsBlockChain.GetBlock(0).GetHeader();
+      DSBlockHeader dshead =
+          m_mediator.m_dsBlockChain.GetBlockPtr(0)->GetHeader();
       SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
       bytes vec;
       dshead.Serialize(vec, 0);
@@ -949,15 +954,16 @@ ProtoBlockListing Server::DSBlockListing(ProtoPage& protoPage) {
 
   if (currBlockNum > m_DSBlockCache.first) {
     for (uint64_t i = m_DSBlockCache.first + 1; i < currBlockNum; i++) {
-      m_DSBlockCache.second.insert_new(m_DSBlockCache.second.size(),
-                                       m_mediator.m_dsBlockChain.GetBlock(i + 1)
-                                           .GetHeader()
-                                           .GetPrevHash()
-                                           .hex());
+      m_DSBlockCache.second.insert_new(
+          m_DSBlockCache.second.size(),
+          m_mediator.m_dsBlockChain.GetBlockPtr(i + 1)
+              ->GetHeader()
+              .GetPrevHash()
+              .hex());
     }
     // for the latest block
     DSBlockHeader dshead =
-        m_mediator.m_dsBlockChain.GetBlock(currBlockNum).GetHeader();
+        m_mediator.m_dsBlockChain.GetBlockPtr(currBlockNum)->GetHeader();
     SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
     bytes vec;
     dshead.Serialize(vec, 0);
@@ -990,8 +996,8 @@ ProtoBlockListing Server::DSBlockListing(ProtoPage& protoPage) {
          i++) {
       auto blockData = ret.add_data();
       blockData->set_hash(
-          m_mediator.m_dsBlockChain.GetBlock(currBlockNum - i + 1)
-              .GetHeader()
+          m_mediator.m_dsBlockChain.GetBlockPtr(currBlockNum - i + 1)
+              ->GetHeader()
               .GetPrevHash()
               .hex());
       blockData->set_blocknum(int(currBlockNum - i));
@@ -1011,14 +1017,15 @@ ProtoBlockListing Server::TxBlockListing(ProtoPage& protoPage) {
   }
 
   uint64_t currBlockNum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
   auto maxPages = (currBlockNum / PAGE_SIZE) + 1;
   ret.set_maxpages(int(maxPages));
 
   if (m_TxBlockCache.second.size() == 0) {
     try {
       // add the hash of genesis block
-      TxBlockHeader txhead = m_mediator.m_txBlockChain.GetBlock(0).GetHeader();
+      TxBlockHeader txhead =
+          m_mediator.m_txBlockChain.GetBlockPtr(0)->GetHeader();
       SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
       bytes vec;
       txhead.Serialize(vec, 0);
@@ -1041,15 +1048,16 @@ ProtoBlockListing Server::TxBlockListing(ProtoPage& protoPage) {
 
   if (currBlockNum > m_TxBlockCache.first) {
     for (uint64_t i = m_TxBlockCache.first + 1; i < currBlockNum; i++) {
-      m_TxBlockCache.second.insert_new(m_TxBlockCache.second.size(),
-                                       m_mediator.m_txBlockChain.GetBlock(i + 1)
-                                           .GetHeader()
-                                           .GetPrevHash()
-                                           .hex());
+      m_TxBlockCache.second.insert_new(
+          m_TxBlockCache.second.size(),
+          m_mediator.m_txBlockChain.GetBlockPtr(i + 1)
+              ->GetHeader()
+              .GetPrevHash()
+              .hex());
     }
     // for the latest block
     TxBlockHeader txhead =
-        m_mediator.m_txBlockChain.GetBlock(currBlockNum).GetHeader();
+        m_mediator.m_txBlockChain.GetBlockPtr(currBlockNum)->GetHeader();
     SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
     bytes vec;
     txhead.Serialize(vec, 0);
@@ -1082,8 +1090,8 @@ ProtoBlockListing Server::TxBlockListing(ProtoPage& protoPage) {
          i++) {
       auto blockData = ret.add_data();
       blockData->set_hash(
-          m_mediator.m_txBlockChain.GetBlock(currBlockNum - i + 1)
-              .GetHeader()
+          m_mediator.m_txBlockChain.GetBlockPtr(currBlockNum - i + 1)
+              ->GetHeader()
               .GetPrevHash()
               .hex());
       blockData->set_blocknum(int(currBlockNum - i));
@@ -1169,7 +1177,7 @@ UIntResponse Server::GetNumTxnsTxEpoch() {
 
   try {
     ret.set_result(
-        m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetNumTxs());
+        m_mediator.m_txBlockChain.GetLastBlockPtr()->GetHeader().GetNumTxs());
   } catch (exception& e) {
     LOG_GENERAL(WARNING, e.what());
     ret.set_result(0);
@@ -1184,31 +1192,31 @@ StringResponse Server::GetNumTxnsDSEpoch() {
   StringResponse ret;
 
   try {
-    auto latestTxBlock = m_mediator.m_txBlockChain.GetLastBlock().GetHeader();
-    auto latestTxBlockNum = latestTxBlock.GetBlockNum();
-    auto latestDSBlockNum = latestTxBlock.GetDSBlockNum();
+    const auto latestTxBlock = m_mediator.m_txBlockChain.GetLastBlockPtr();
+    auto latestTxBlockNum = latestTxBlock->GetHeader().GetBlockNum();
+    auto latestDSBlockNum = latestTxBlock->GetHeader().GetDSBlockNum();
 
     if (latestTxBlockNum > m_TxBlockCountSumPair.first) {
       // Case where the DS Epoch is same
-      if (m_mediator.m_txBlockChain.GetBlock(m_TxBlockCountSumPair.first)
-              .GetHeader()
+      if (m_mediator.m_txBlockChain.GetBlockPtr(m_TxBlockCountSumPair.first)
+              ->GetHeader()
               .GetDSBlockNum() == latestDSBlockNum) {
         for (auto i = latestTxBlockNum; i > m_TxBlockCountSumPair.first; i--) {
           m_TxBlockCountSumPair.second +=
-              m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetNumTxs();
+              m_mediator.m_txBlockChain.GetBlockPtr(i)->GetHeader().GetNumTxs();
         }
 
       } else {  // Case if DS Epoch Changed
         m_TxBlockCountSumPair.second = 0;
 
         for (auto i = latestTxBlockNum; i > m_TxBlockCountSumPair.first; i--) {
-          if (m_mediator.m_txBlockChain.GetBlock(i)
-                  .GetHeader()
+          if (m_mediator.m_txBlockChain.GetBlockPtr(i)
+                  ->GetHeader()
                   .GetDSBlockNum() < latestDSBlockNum) {
             break;
           }
           m_TxBlockCountSumPair.second +=
-              m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetNumTxs();
+              m_mediator.m_txBlockChain.GetBlockPtr(i)->GetHeader().GetNumTxs();
         }
       }
 
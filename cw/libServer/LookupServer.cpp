@@ -15,6 +15,7 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 #include "LookupServer.h"
+#include <boost/lexical_cast.hpp>
 #include <boost/multiprecision/cpp_dec_float.hpp>
 #include "JSONConversion.h"
 #include "common/Messages.h"
@@ -29,6 +30,7 @@
 #include "libNetwork/P2PComm.h"
 #include "libNetwork/Peer.h"
 #include "libPersistence/BlockStorage.h"
+#include "libPersistence/ContractStorage.h"
 #include "libUtils/DetachedFunction.h"
 #include "libUtils/Logger.h"
 #include "libUtils/TimeUtils.h"
@@ -74,6 +76,11 @@ LookupServer::LookupServer(Mediator& mediator,
                          jsonrpc::JSON_OBJECT, "param01", jsonrpc::JSON_OBJECT,
                          NULL),
       &LookupServer::CreateTransactionI);
+  this->bindAndAddMethod(
+      jsonrpc::Procedure("CreateTransactions", jsonrpc::PARAMS_BY_POSITION,
+                         jsonrpc::JSON_ARRAY, "param01", jsonrpc::JSON_ARRAY,
+                         NULL),
+      &LookupServer::CreateTransactionsI);
   this->bindAndAddMethod(
       jsonrpc::Procedure("GetTransaction", jsonrpc::PARAMS_BY_POSITION,
                          jsonrpc::JSON_OBJECT, "param01", jsonrpc::JSON_STRING,
@@ -192,6 +199,13 @@ LookupServer::LookupServer(Mediator& mediator,
                          jsonrpc::JSON_OBJECT, "param01", jsonrpc::JSON_STRING,
                          NULL),
       &LookupServer::GetSmartContractStateI);
+  this->bindAndAddMethod(
+      jsonrpc::Procedure("GetSmartContractSubState",
+                         jsonrpc::PARAMS_BY_POSITION, jsonrpc::JSON_OBJECT,
+                         "param01", jsonrpc::JSON_STRING, "param02",
+                         jsonrpc::JSON_STRING, "param03", jsonrpc::JSON_STRING,
+                         NULL),
+      &LookupServer::GetSmartContractSubStateI);
   this->bindAndAddMethod(
       jsonrpc::Procedure("GetSmartContractCode", jsonrpc::PARAMS_BY_POSITION,
                          jsonrpc::JSON_OBJECT, "param01", jsonrpc::JSON_STRING,
@@ -311,7 +325,8 @@ bool LookupServer::StartCollectorThread() {
 }
 
 bool LookupServer::ValidateTxn(const Transaction& tx, const Address& fromAddr,
-                               const Account* sender) const {
+                               const Account* sender,
+                               bool verifySignature) const {
   if (DataConversion::UnpackA(tx.GetVersion()) != CHAIN_ID) {
     throw JsonRpcException(RPC_VERIFY_REJECTED, "CHAIN_ID incorrect");
   }
@@ -321,16 +336,16 @@ bool LookupServer::ValidateTxn(const Transaction& tx, const Address& fromAddr,
   }
 
   if (tx.GetGasPrice() <
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetGasPrice()) {
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetGasPrice()) {
     throw JsonRpcException(RPC_VERIFY_REJECTED,
                            "GasPrice " + tx.GetGasPrice().convert_to<string>() +
                                " lower than minimum allowable " +
-                               m_mediator.m_dsBlockChain.GetLastBlock()
-                                   .GetHeader()
+                               m_mediator.m_dsBlockChain.GetLastBlockPtr()
+                                   ->GetHeader()
                                    .GetGasPrice()
                                    .convert_to<string>());
   }
-  if (!m_mediator.m_validator->VerifyTransaction(tx)) {
+  if (verifySignature && !m_mediator.m_validator->VerifyTransaction(tx)) {
     throw JsonRpcException(RPC_VERIFY_REJECTED, "Unable to verify transaction");
   }
 
@@ -353,6 +368,83 @@ bool LookupServer::ValidateTxn(const Transaction& tx, const Address& fromAddr,
   return true;
 }
 
+Json::Value LookupServer::GetTxnShardMapIndex(const Transaction& tx,
+                                              const Address& fromAddr,
+                                              const Account* sender,
+                                              const Json::Value& _json,
+                                              unsigned int& mapIndex) const {
+  Json::Value ret;
+
+  const unsigned int num_shards = m_mediator.m_lookup->GetShardPeers().size();
+  const unsigned int shard = Transaction::GetShardIndex(fromAddr, num_shards);
+  mapIndex = shard;
+  switch (Transaction::GetTransactionType(tx)) {
+    case Transaction::ContractType::NON_CONTRACT:
+      if (ARCHIVAL_LOOKUP) {
+        mapIndex = SEND_TYPE::ARCHIVAL_SEND_SHARD;
+      }
+      ret["Info"] = "Non-contract txn, sent to shard";
+      break;
+    case Transaction::ContractType::CONTRACT_CREATION:
+      if (!ENABLE_SC) {
+        throw JsonRpcException(RPC_MISC_ERROR, "Smart contract is disabled");
+      }
+      if (ARCHIVAL_LOOKUP) {
+        mapIndex = SEND_TYPE::ARCHIVAL_SEND_SHARD;
+      }
+      ret["Info"] = "Contract Creation txn, sent to shard";
+      ret["ContractAddress"] =
+          Account::GetAddressForContract(fromAddr, sender->GetNonce()).hex();
+      break;
+    case Transaction::ContractType::CONTRACT_CALL: {
+      if (!ENABLE_SC) {
+        throw JsonRpcException(RPC_MISC_ERROR, "Smart contract is disabled");
+      }
+      const Account* account =
+          AccountStore::GetInstance().GetAccount(tx.GetToAddr());
+
+      if (account == nullptr) {
+        throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY, "To addr is null");
+      }
+
+      else if (!account->isContract()) {
+        throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY,
+                               "Non - contract address called");
+      }
+
+      unsigned int to_shard =
+          Transaction::GetShardIndex(tx.GetToAddr(), num_shards);
+      bool sendToDs = false;
+      if (_json.isMember("priority")) {
+        sendToDs = _json["priority"].asBool();
+      }
+      if ((to_shard == shard) && !sendToDs) {
+        if (ARCHIVAL_LOOKUP) {
+          mapIndex = SEND_TYPE::ARCHIVAL_SEND_SHARD;
+        }
+        ret["Info"] =
+            "Contract Txn, Shards Match of the sender "
+            "and reciever";
+      } else {
+        if (ARCHIVAL_LOOKUP) {
+          mapIndex = SEND_TYPE::ARCHIVAL_SEND_DS;
+        } else {
+          mapIndex = num_shards;
+        }
+        ret["Info"] = "Contract Txn, Sent To Ds";
+      }
+    } break;
+    case Transaction::ContractType::ERROR:
+      throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY,
+                             "Code is empty and To addr is null");
+      break;
+    default:
+      throw JsonRpcException(RPC_MISC_ERROR, "Txn type unexpected");
+  }
+
+  return ret;
+}
+
 Json::Value LookupServer::CreateTransaction(const Json::Value& _json) {
   LOG_MARKER();
 
@@ -376,72 +468,9 @@ Json::Value LookupServer::CreateTransaction(const Json::Value& _json) {
       return ret;
     }
 
-    const unsigned int num_shards = m_mediator.m_lookup->GetShardPeers().size();
-    const unsigned int shard = Transaction::GetShardIndex(fromAddr, num_shards);
-    unsigned int mapIndex = shard;
-    switch (Transaction::GetTransactionType(tx)) {
-      case Transaction::ContractType::NON_CONTRACT:
-        if (ARCHIVAL_LOOKUP) {
-          mapIndex = SEND_TYPE::ARCHIVAL_SEND_SHARD;
-        }
-        ret["Info"] = "Non-contract txn, sent to shard";
-        break;
-      case Transaction::ContractType::CONTRACT_CREATION:
-        if (!ENABLE_SC) {
-          throw JsonRpcException(RPC_MISC_ERROR, "Smart contract is disabled");
-        }
-        if (ARCHIVAL_LOOKUP) {
-          mapIndex = SEND_TYPE::ARCHIVAL_SEND_SHARD;
-        }
-        ret["Info"] = "Contract Creation txn, sent to shard";
-        ret["ContractAddress"] =
-            Account::GetAddressForContract(fromAddr, sender->GetNonce()).hex();
-        break;
-      case Transaction::ContractType::CONTRACT_CALL: {
-        if (!ENABLE_SC) {
-          throw JsonRpcException(RPC_MISC_ERROR, "Smart contract is disabled");
-        }
-        const Account* account =
-            AccountStore::GetInstance().GetAccount(tx.GetToAddr());
+    unsigned int mapIndex = 0;
+    ret = GetTxnShardMapIndex(tx, fromAddr, sender, _json, mapIndex);
 
-        if (account == nullptr) {
-          throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY, "To addr is null");
-        }
-
-        else if (!account->isContract()) {
-          throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY,
-                                 "Non - contract address called");
-        }
-
-        unsigned int to_shard =
-            Transaction::GetShardIndex(tx.GetToAddr(), num_shards);
-        bool sendToDs = false;
-        if (_json.isMember("priority")) {
-          sendToDs = _json["priority"].asBool();
-        }
-        if ((to_shard == shard) && !sendToDs) {
-          if (ARCHIVAL_LOOKUP) {
-            mapIndex = SEND_TYPE::ARCHIVAL_SEND_SHARD;
-          }
-          ret["Info"] =
-              "Contract Txn, Shards Match of the sender "
-              "and reciever";
-        } else {
-          if (ARCHIVAL_LOOKUP) {
-            mapIndex = SEND_TYPE::ARCHIVAL_SEND_DS;
-          } else {
-            mapIndex = num_shards;
-          }
-          ret["Info"] = "Contract Txn, Sent To Ds";
-        }
-      } break;
-      case Transaction::ContractType::ERROR:
-        throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY,
-                               "Code is empty and To addr is null");
-        break;
-      default:
-        throw JsonRpcException(RPC_MISC_ERROR, "Txn type unexpected");
-    }
     if (!m_mediator.m_lookup->AddToTxnShardMap(tx, mapIndex)) {
       throw JsonRpcException(RPC_DATABASE_ERROR,
                              "Txn could not be added as database exceeded "
@@ -458,6 +487,132 @@ Json::Value LookupServer::CreateTransaction(const Json::Value& _json) {
   }
 }
 
+Json::Value LookupServer::CreateTransactions(const Json::Value& _json) {
+  LOG_MARKER();
+
+  if (!LOOKUP_NODE_MODE) {
+    throw JsonRpcException(RPC_INVALID_REQUEST, "Sent to a non-lookup");
+  }
+
+  if (!_json.isArray()) {
+    throw JsonRpcException(RPC_INVALID_PARAMS, "Expected an array of txns");
+  }
+
+  if (_json.size() > LOOKUP_RPC_MAX_TXNS_PER_BATCH) {
+    throw JsonRpcException(
+        RPC_INVALID_PARAMS,
+        "Batch larger than " + to_string(LOOKUP_RPC_MAX_TXNS_PER_BATCH));
+  }
+
+  const unsigned int numTxns = _json.size();
+  vector<Transaction> txns(numTxns);
+  vector<Json::Value> results(numTxns);
+  vector<bool> failed(numTxns, false);
+
+  auto setError = [&results, &failed](unsigned int i, int code,
+                                      const string& message) {
+    results[i] = Json::Value();
+    results[i]["error"]["code"] = code;
+    results[i]["error"]["message"] = message;
+    failed[i] = true;
+  };
+
+  // Parse
+  for (unsigned int i = 0; i < numTxns; i++) {
+    try {
+      if (!JSONConversion::checkJsonTx(_json[i])) {
+        setError(i, RPC_PARSE_ERROR, "Invalid Transaction JSON");
+        continue;
+      }
+      txns[i] = JSONConversion::convertJsontoTx(_json[i]);
+    } catch (const JsonRpcException& je) {
+      setError(i, je.GetCode(), je.GetMessage());
+    } catch (exception& e) {
+      LOG_GENERAL(INFO, "[Error]" << e.what());
+      setError(i, RPC_MISC_ERROR, "Unable to Process");
+    }
+  }
+
+  // Verify the signatures of the whole batch on the shared verifier pool
+  vector<unsigned char> signatureValid(numTxns, false);
+  atomic<unsigned int> next{0};
+  const unsigned int numJobs =
+      min<unsigned int>(numTxns, LOOKUP_RPC_NUM_VERIFIER_THREADS);
+  unsigned int jobsLeft = numJobs;
+  mutex mutexJobsLeft;
+  condition_variable cvJobsLeft;
+  auto verifyFunc = [this, &next, &txns, &failed, &signatureValid, &jobsLeft,
+                     &mutexJobsLeft, &cvJobsLeft]() mutable -> void {
+    for (unsigned int i = next++; i < txns.size(); i = next++) {
+      if (!failed[i]) {
+        signatureValid[i] = m_mediator.m_validator->VerifyTransaction(txns[i]);
+      }
+    }
+    lock_guard<mutex> g(mutexJobsLeft);
+    if (--jobsLeft == 0) {
+      cvJobsLeft.notify_all();
+    }
+  };
+  for (unsigned int i = 0; i < numJobs; i++) {
+    m_verifierPool.AddJob(verifyFunc);
+  }
+  {
+    unique_lock<mutex> lock(mutexJobsLeft);
+    cvJobsLeft.wait(lock, [&jobsLeft] { return jobsLeft == 0; });
+  }
+
+  // Check against the current state and assign the shards
+  vector<pair<Transaction, uint32_t>> accepted;
+  vector<unsigned int> acceptedIndexes;
+  for (unsigned int i = 0; i < numTxns; i++) {
+    if (failed[i]) {
+      continue;
+    }
+    if (!signatureValid[i]) {
+      setError(i, RPC_VERIFY_REJECTED, "Unable to verify transaction");
+      continue;
+    }
+
+    try {
+      const Address fromAddr = txns[i].GetSenderAddr();
+      const Account* sender = AccountStore::GetInstance().GetAccount(fromAddr);
+
+      ValidateTxn(txns[i], fromAddr, sender, false);
+
+      unsigned int mapIndex = 0;
+      results[i] =
+          GetTxnShardMapIndex(txns[i], fromAddr, sender, _json[i], mapIndex);
+      results[i]["TranID"] = txns[i].GetTranID().hex();
+
+      accepted.emplace_back(move(txns[i]), mapIndex);
+      acceptedIndexes.emplace_back(i);
+    } catch (const JsonRpcException& je) {
+      setError(i, je.GetCode(), je.GetMessage());
+    } catch (exception& e) {
+      LOG_GENERAL(INFO, "[Error]" << e.what());
+      setError(i, RPC_MISC_ERROR, "Unable to Process");
+    }
+  }
+
+  vector<bool> added;
+  m_mediator.m_lookup->AddToTxnShardMap(accepted, added);
+
+  for (unsigned int j = 0; j < acceptedIndexes.size(); j++) {
+    if (!added[j]) {
+      setError(acceptedIndexes[j], RPC_DATABASE_ERROR,
+               "Txn could not be added as database exceeded limit or the txn "
+               "was already present");
+    }
+  }
+
+  Json::Value ret = Json::arrayValue;
+  for (auto& result : results) {
+    ret.append(result);
+  }
+
+  return ret;
+}
+
 Json::Value LookupServer::GetTransaction(const string& transactionHash) {
   LOG_MARKER();
 
@@ -500,7 +655,7 @@ Json::Value LookupServer::GetDsBlock(const string& blockNum) {
   try {
     uint64_t BlockNum = stoull(blockNum);
     return JSONConversion::convertDSblocktoJson(
-        m_mediator.m_dsBlockChain.GetBlock(BlockNum));
+        *m_mediator.m_dsBlockChain.GetBlockPtr(BlockNum));
   } catch (const JsonRpcException& je) {
     throw je;
   } catch (runtime_error& e) {
@@ -526,7 +681,7 @@ Json::Value LookupServer::GetTxBlock(const string& blockNum) {
   try {
     uint64_t BlockNum = stoull(blockNum);
     return JSONConversion::convertTxBlocktoJson(
-        m_mediator.m_txBlockChain.GetBlock(BlockNum));
+        *m_mediator.m_txBlockChain.GetBlockPtr(BlockNum));
   } catch (const JsonRpcException& je) {
     throw je;
   } catch (runtime_error& e) {
@@ -549,25 +704,113 @@ string LookupServer::GetMinimumGasPrice() {
     throw JsonRpcException(RPC_INVALID_REQUEST, "Sent to a non-lookup");
   }
 
-  return m_mediator.m_dsBlockChain.GetLastBlock()
-      .GetHeader()
+  return m_mediator.m_dsBlockChain.GetLastBlockPtr()
+      ->GetHeader()
       .GetGasPrice()
       .str();
 }
 
+// Adds roughly the size of the compact JSON text of value to size, without
+// writing it out. Stops early once size exceeds limit.
+static void AddJsonSize(const Json::Value& value, const uint64_t& limit,
+                        uint64_t& size) {
+  switch (value.type()) {
+    case Json::stringValue: {
+      const char* begin = nullptr;
+      const char* end = nullptr;
+      value.getString(&begin, &end);
+      size += (end - begin) + 2;
+      break;
+    }
+    case Json::arrayValue:
+      size += 2;
+      for (const auto& element : value) {
+        if (size > limit) {
+          return;
+        }
+        AddJsonSize(element, limit, size);
+        size++;
+      }
+      break;
+    case Json::objectValue:
+      size += 2;
+      for (auto it = value.begin(); it != value.end(); it++) {
+        if (size > limit) {
+          return;
+        }
+        size += it.name().size() + 4;
+        AddJsonSize(*it, limit, size);
+      }
+      break;
+    case Json::nullValue:
+    case Json::booleanValue:
+      size += 5;
+      break;
+    default:
+      // Numbers
+      size += 20;
+      break;
+  }
+}
+
+Json::Value LookupServer::GetCachedResponse(
+    const string& method, const string& params,
+    const function<Json::Value()>& compute) {
+  const pair<uint64_t, uint64_t> blockNums{
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum(),
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum()};
+  const string key = method + ":" + params;
+
+  {
+    lock_guard<mutex> g(m_mutexResponseCache);
+    if (m_responseCacheBlockNums != blockNums) {
+      // A new block has been committed since
+      m_responseCache.clear();
+      m_responseCacheSizeInBytes = 0;
+      m_responseCacheBlockNums = blockNums;
+    } else {
+      auto it = m_responseCache.find(key);
+      if (it != m_responseCache.end()) {
+        return it->second;
+      }
+    }
+  }
+
+  // Errors are thrown as JsonRpcException and never cached
+  Json::Value response = compute();
+
+  // Large responses are not cached, they would crowd out many small ones
+  uint64_t responseSize = 0;
+  AddJsonSize(response, LOOKUP_RPC_RESPONSE_MAX_CACHED_SIZE_IN_BYTES,
+              responseSize);
+  if (responseSize > LOOKUP_RPC_RESPONSE_MAX_CACHED_SIZE_IN_BYTES) {
+    return response;
+  }
+
+  lock_guard<mutex> g(m_mutexResponseCache);
+  if (m_responseCacheBlockNums == blockNums &&
+      m_responseCacheSizeInBytes + responseSize <=
+          LOOKUP_RPC_RESPONSE_CACHE_SIZE_IN_BYTES &&
+      m_responseCache.emplace(key, response).second) {
+    m_responseCacheSizeInBytes += responseSize;
+  }
+
+  return response;
+}
+
 Json::Value LookupServer::GetLatestDsBlock() {
   if (!LOOKUP_NODE_MODE) {
     throw JsonRpcException(RPC_INVALID_REQUEST, "Sent to a non-lookup");
   }
 
   LOG_MARKER();
-  DSBlock Latest = m_mediator.m_dsBlockChain.GetLastBlock();
+  const auto Latest = m_mediator.m_dsBlockChain.GetLastBlockPtr();
 
   LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
-            "BlockNum " << Latest.GetHeader().GetBlockNum()
-                        << "  Timestamp:        " << Latest.GetTimestamp());
+            "BlockNum " << Latest->GetHeader().GetBlockNum()
+                        << "  Timestamp:        " << Latest->GetTimestamp());
 
-  return JSONConversion::convertDSblocktoJson(Latest);
+  return JSONConversion::convertDSblocktoJson(*Latest);
 }
 
 Json::Value LookupServer::GetLatestTxBlock() {
@@ -577,13 +820,13 @@ Json::Value LookupServer::GetLatestTxBlock() {
     throw JsonRpcException(RPC_INVALID_REQUEST, "Sent to a non-lookup");
   }
 
-  TxBlock Latest = m_mediator.m_txBlockChain.GetLastBlock();
+  const auto Latest = m_mediator.m_txBlockChain.GetLastBlockPtr();
 
   LOG_EPOCH(INFO, m_mediator.m_currentEpochNum,
-            "BlockNum " << Latest.GetHeader().GetBlockNum()
-                        << "  Timestamp:        " << Latest.GetTimestamp());
+            "BlockNum " << Latest->GetHeader().GetBlockNum()
+                        << "  Timestamp:        " << Latest->GetTimestamp());
 
-  return JSONConversion::convertTxBlocktoJson(Latest);
+  return JSONConversion::convertTxBlocktoJson(*Latest);
 }
 
 Json::Value LookupServer::GetBalance(const string& address) {
@@ -659,7 +902,94 @@ Json::Value LookupServer::GetSmartContractState(const string& address) {
                              "Address not contract address");
     }
 
-    return account->GetStateJson(false);
+    if (CONTRACT_STATE_JSON_MAX_SIZE_IN_BYTES == 0) {
+      return account->GetStateJson(false);
+    }
+
+    pair<Json::Value, Json::Value> roots;
+    uint32_t scilla_version;
+    if (!account->GetStorageJson(roots, false, scilla_version,
+                                 CONTRACT_STATE_JSON_MAX_SIZE_IN_BYTES)) {
+      throw JsonRpcException(RPC_MISC_ERROR,
+                             "State too large or unreadable, use "
+                             "GetSmartContractSubState");
+    }
+
+    return roots.second;
+  } catch (const JsonRpcException& je) {
+    throw je;
+  } catch (exception& e) {
+    LOG_GENERAL(INFO, "[Error]" << e.what() << " Input: " << address);
+    throw JsonRpcException(RPC_MISC_ERROR, "Unable To Process");
+  }
+}
+
+Json::Value LookupServer::GetSmartContractSubState(const string& address,
+                                                   const string& vnamePrefix,
+                                                   const string& cursor) {
+  LOG_MARKER();
+
+  if (!LOOKUP_NODE_MODE) {
+    throw JsonRpcException(RPC_INVALID_REQUEST, "Sent to a non-lookup");
+  }
+
+  try {
+    if (address.size() != ACC_ADDR_SIZE * 2) {
+      throw JsonRpcException(RPC_INVALID_PARAMETER,
+                             "Address size not appropriate");
+    }
+    bytes tmpaddr;
+    if (!DataConversion::HexStrToUint8Vec(address, tmpaddr)) {
+      throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY, "invalid address");
+    }
+
+    // The cursor is the index of the state to start from
+    Contract::Index cursorIndex;
+    if (!cursor.empty()) {
+      bytes tmpCursor;
+      if (cursor.size() != Contract::Index::size * 2 ||
+          !DataConversion::HexStrToUint8Vec(cursor, tmpCursor)) {
+        throw JsonRpcException(RPC_INVALID_PARAMETER, "Invalid cursor");
+      }
+      cursorIndex = Contract::Index(tmpCursor);
+    }
+
+    Address addr(tmpaddr);
+    const Account* account = AccountStore::GetInstance().GetAccount(addr);
+
+    if (account == nullptr) {
+      throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY,
+                             "Address does not exist");
+    }
+
+    if (!account->isContract()) {
+      throw JsonRpcException(RPC_INVALID_ADDRESS_OR_KEY,
+                             "Address not contract address");
+    }
+
+    Json::Value states;
+    Contract::Index nextCursor;
+    if (!Contract::ContractStorage::GetContractStorage()
+             .GetContractStateJsonPage(addr, vnamePrefix, cursorIndex, states,
+                                       nextCursor, false)) {
+      throw JsonRpcException(RPC_MISC_ERROR, "Unable To Process");
+    }
+
+    // _balance is not stored with the other states, it comes last
+    if (nextCursor == Contract::Index() &&
+        string("_balance").compare(0, vnamePrefix.size(), vnamePrefix) == 0) {
+      Json::Value balance;
+      balance["vname"] = "_balance";
+      balance["type"] = "Uint128";
+      balance["value"] = account->GetBalance().convert_to<string>();
+      states.append(balance);
+    }
+
+    Json::Value _json;
+    _json["states"] = states;
+    _json["nextCursor"] =
+        nextCursor == Contract::Index() ? "" : nextCursor.hex();
+    return _json;
   } catch (const JsonRpcException& je) {
     throw je;
   } catch (exception& e) {
@@ -845,8 +1175,8 @@ unsigned int LookupServer::GetNumPeers() {
   }
 
   unsigned int numPeers = m_mediator.m_lookup->GetNodePeers().size();
-  lock_guard<mutex> g(m_mediator.m_mutexDSCommittee);
-  return numPeers + m_mediator.m_DSCommittee->size();
+  const auto chainTip = m_mediator.GetChainTip();
+  return numPeers + chainTip->GetCommitteeView()->GetDSCommittee().size();
 }
 
 string LookupServer::GetNumTxBlocks() {
@@ -879,11 +1209,11 @@ string LookupServer::GetNumTransactions() {
   lock_guard<mutex> g(m_mutexBlockTxPair);
 
   uint64_t currBlock =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
   if (m_BlockTxPair.first < currBlock) {
     for (uint64_t i = m_BlockTxPair.first + 1; i <= currBlock; i++) {
       m_BlockTxPair.second +=
-          m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetNumTxs();
+          m_mediator.m_txBlockChain.GetBlockPtr(i)->GetHeader().GetNumTxs();
     }
   }
   m_BlockTxPair.first = currBlock;
@@ -897,7 +1227,7 @@ size_t LookupServer::GetNumTransactions(uint64_t blockNum) {
   }
 
   uint64_t currBlockNum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
 
   if (blockNum >= currBlockNum) {
     return 0;
@@ -906,7 +1236,7 @@ size_t LookupServer::GetNumTransactions(uint64_t blockNum) {
   size_t i, res = 0;
 
   for (i = blockNum + 1; i <= currBlockNum; i++) {
-    res += m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetNumTxs();
+    res += m_mediator.m_txBlockChain.GetBlockPtr(i)->GetHeader().GetNumTxs();
   }
 
   return res;
@@ -919,7 +1249,7 @@ double LookupServer::GetTransactionRate() {
   }
 
   uint64_t refBlockNum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
 
   uint64_t refTimeTx = 0;
 
@@ -941,8 +1271,8 @@ double LookupServer::GetTransactionRate() {
   LOG_GENERAL(INFO, "Num Txns: " << numTxns);
 
   try {
-    TxBlock tx = m_mediator.m_txBlockChain.GetBlock(refBlockNum);
-    refTimeTx = tx.GetTimestamp();
+    const auto tx = m_mediator.m_txBlockChain.GetBlockPtr(refBlockNum);
+    refTimeTx = tx->GetTimestamp();
   } catch (const JsonRpcException& je) {
     throw je;
   } catch (const char* msg) {
@@ -953,7 +1283,7 @@ double LookupServer::GetTransactionRate() {
   }
 
   uint64_t TimeDiff =
-      m_mediator.m_txBlockChain.GetLastBlock().GetTimestamp() - refTimeTx;
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetTimestamp() - refTimeTx;
 
   if (TimeDiff == 0 || refTimeTx == 0) {
     // something went wrong
@@ -983,8 +1313,7 @@ double LookupServer::GetDSBlockRate() {
   {
     try {
       // Refernce time chosen to be the first block's timestamp
-      DSBlock dsb = m_mediator.m_dsBlockChain.GetBlock(1);
-      m_StartTimeDs = dsb.GetTimestamp();
+      m_StartTimeDs = m_mediator.m_dsBlockChain.GetBlockPtr(1)->GetTimestamp();
     } catch (const JsonRpcException& je) {
       throw je;
     } catch (const char* msg) {
@@ -995,7 +1324,8 @@ double LookupServer::GetDSBlockRate() {
     }
   }
   uint64_t TimeDiff =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetTimestamp() - m_StartTimeDs;
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetTimestamp() -
+      m_StartTimeDs;
 
   if (TimeDiff == 0) {
     LOG_GENERAL(INFO, "Wait till the second block");
@@ -1022,8 +1352,7 @@ double LookupServer::GetTxBlockRate() {
   if (m_StartTimeTx == 0) {
     try {
       // Reference Time chosen to be first block's timestamp
-      TxBlock txb = m_mediator.m_txBlockChain.GetBlock(1);
-      m_StartTimeTx = txb.GetTimestamp();
+      m_StartTimeTx = m_mediator.m_txBlockChain.GetBlockPtr(1)->GetTimestamp();
     } catch (const char* msg) {
       if (string(msg) == "Blocknumber Absent") {
         LOG_GENERAL(INFO, "No TxBlock has been mined yet");
@@ -1032,7 +1361,8 @@ double LookupServer::GetTxBlockRate() {
     }
   }
   uint64_t TimeDiff =
-      m_mediator.m_txBlockChain.GetLastBlock().GetTimestamp() - m_StartTimeTx;
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetTimestamp() -
+      m_StartTimeTx;
 
   if (TimeDiff == 0) {
     LOG_GENERAL(INFO, "Wait till the second block");
@@ -1051,7 +1381,7 @@ Json::Value LookupServer::DSBlockListing(unsigned int page) {
     throw JsonRpcException(RPC_INVALID_REQUEST, "Sent to a non-lookup");
   }
   uint64_t currBlockNum =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
   Json::Value _json;
 
   uint maxPages = (currBlockNum / PAGE_SIZE) + 1;
@@ -1063,7 +1393,8 @@ Json::Value LookupServer::DSBlockListing(unsigned int page) {
   if (m_DSBlockCache.second.size() == 0) {
     try {
       // add the hash of genesis block
-      DSBlockHeader dshead = m_mediator.m_dsBlockChain.GetBlock(0).GetHeader();
+      DSBlockHeader dshead =
+          m_mediator.m_dsBlockChain.GetBlockPtr(0)->GetHeader();
       SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
       bytes vec;
       dshead.Serialize(vec, 0);
@@ -1083,15 +1414,16 @@ Json::Value LookupServer::DSBlockListing(unsigned int page) {
 
   if (currBlockNum > m_DSBlockCache.first) {
     for (uint64_t i = m_DSBlockCache.first + 1; i < currBlockNum; i++) {
-      m_DSBlockCache.second.insert_new(m_DSBlockCache.second.size(),
-                                       m_mediator.m_dsBlockChain.GetBlock(i + 1)
-                                           .GetHeader()
-                                           .GetPrevHash()
-                                           .hex());
+      m_DSBlockCache.second.insert_new(
+          m_DSBlockCache.second.size(),
+          m_mediator.m_dsBlockChain.GetBlockPtr(i + 1)
+              ->GetHeader()
+              .GetPrevHash()
+              .hex());
     }
     // for the latest block
     DSBlockHeader dshead =
-        m_mediator.m_dsBlockChain.GetBlock(currBlockNum).GetHeader();
+        m_mediator.m_dsBlockChain.GetBlockPtr(currBlockNum)->GetHeader();
     SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
     bytes vec;
     dshead.Serialize(vec, 0);
@@ -1126,10 +1458,11 @@ Json::Value LookupServer::DSBlockListing(unsigned int page) {
     for (uint64_t i = offset; i < PAGE_SIZE + offset && i <= currBlockNum;
          i++) {
       tmpJson.clear();
-      tmpJson["Hash"] = m_mediator.m_dsBlockChain.GetBlock(currBlockNum - i + 1)
-                            .GetHeader()
-                            .GetPrevHash()
-                            .hex();
+      tmpJson["Hash"] =
+          m_mediator.m_dsBlockChain.GetBlockPtr(currBlockNum - i + 1)
+              ->GetHeader()
+              .GetPrevHash()
+              .hex();
       tmpJson["BlockNum"] = uint(currBlockNum - i);
       _json["data"].append(tmpJson);
     }
@@ -1144,7 +1477,7 @@ Json::Value LookupServer::TxBlockListing(unsigned int page) {
     throw JsonRpcException(RPC_INVALID_REQUEST, "Sent to a non-lookup");
   }
   uint64_t currBlockNum =
-      m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_txBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
   Json::Value _json;
 
   uint maxPages = (currBlockNum / PAGE_SIZE) + 1;
@@ -1156,7 +1489,8 @@ Json::Value LookupServer::TxBlockListing(unsigned int page) {
   if (m_TxBlockCache.second.size() == 0) {
     try {
       // add the hash of genesis block
-      TxBlockHeader txhead = m_mediator.m_txBlockChain.GetBlock(0).GetHeader();
+      TxBlockHeader txhead =
+          m_mediator.m_txBlockChain.GetBlockPtr(0)->GetHeader();
       SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
       bytes vec;
       txhead.Serialize(vec, 0);
@@ -1176,15 +1510,16 @@ Json::Value LookupServer::TxBlockListing(unsigned int page) {
 
   if (currBlockNum > m_TxBlockCache.first) {
     for (uint64_t i = m_TxBlockCache.first + 1; i < currBlockNum; i++) {
-      m_TxBlockCache.second.insert_new(m_TxBlockCache.second.size(),
-                                       m_mediator.m_txBlockChain.GetBlock(i + 1)
-                                           .GetHeader()
-                                           .GetPrevHash()
-                                           .hex());
+      m_TxBlockCache.second.insert_new(
+          m_TxBlockCache.second.size(),
+          m_mediator.m_txBlockChain.GetBlockPtr(i + 1)
+              ->GetHeader()
+              .GetPrevHash()
+              .hex());
     }
     // for the latest block
     TxBlockHeader txhead =
-        m_mediator.m_txBlockChain.GetBlock(currBlockNum).GetHeader();
+        m_mediator.m_txBlockChain.GetBlockPtr(currBlockNum)->GetHeader();
     SHA2<HASH_TYPE::HASH_VARIANT_256> sha2;
     bytes vec;
     txhead.Serialize(vec, 0);
@@ -1220,10 +1555,11 @@ Json::Value LookupServer::TxBlockListing(unsigned int page) {
     for (uint64_t i = offset; i < PAGE_SIZE + offset && i <= currBlockNum;
          i++) {
       tmpJson.clear();
-      tmpJson["Hash"] = m_mediator.m_txBlockChain.GetBlock(currBlockNum - i + 1)
-                            .GetHeader()
-                            .GetPrevHash()
-                            .hex();
+      tmpJson["Hash"] =
+          m_mediator.m_txBlockChain.GetBlockPtr(currBlockNum - i + 1)
+              ->GetHeader()
+              .GetPrevHash()
+              .hex();
       tmpJson["BlockNum"] = uint(currBlockNum - i);
       _json["data"].append(tmpJson);
     }
@@ -1314,7 +1650,7 @@ string LookupServer::GetNumTxnsTxEpoch() {
   }
   try {
     return to_string(
-        m_mediator.m_txBlockChain.GetLastBlock().GetHeader().GetNumTxs());
+        m_mediator.m_txBlockChain.GetLastBlockPtr()->GetHeader().GetNumTxs());
   } catch (const JsonRpcException& je) {
     throw je;
   } catch (exception& e) {
@@ -1329,20 +1665,20 @@ string LookupServer::GetNumTxnsDSEpoch() {
     throw JsonRpcException(RPC_INVALID_REQUEST, "Sent to a non-lookup");
   }
   try {
-    auto latestTxBlock = m_mediator.m_txBlockChain.GetLastBlock().GetHeader();
-    auto latestTxBlockNum = latestTxBlock.GetBlockNum();
-    auto latestDSBlockNum = latestTxBlock.GetDSBlockNum();
+    const auto latestTxBlock = m_mediator.m_txBlockChain.GetLastBlockPtr();
+    auto latestTxBlockNum = latestTxBlock->GetHeader().GetBlockNum();
+    auto latestDSBlockNum = latestTxBlock->GetHeader().GetDSBlockNum();
 
     lock_guard<mutex> g(m_mutexTxBlockCountSumPair);
 
     if (latestTxBlockNum > m_TxBlockCountSumPair.first) {
       // Case where the DS Epoch is same
-      if (m_mediator.m_txBlockChain.GetBlock(m_TxBlockCountSumPair.first)
-              .GetHeader()
+      if (m_mediator.m_txBlockChain.GetBlockPtr(m_TxBlockCountSumPair.first)
+              ->GetHeader()
               .GetDSBlockNum() == latestDSBlockNum) {
         for (auto i = latestTxBlockNum; i > m_TxBlockCountSumPair.first; i--) {
           m_TxBlockCountSumPair.second +=
-              m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetNumTxs();
+              m_mediator.m_txBlockChain.GetBlockPtr(i)->GetHeader().GetNumTxs();
         }
       }
       // Case if DS Epoch Changed
@@ -1350,13 +1686,13 @@ string LookupServer::GetNumTxnsDSEpoch() {
         m_TxBlockCountSumPair.second = 0;
 
         for (auto i = latestTxBlockNum; i > m_TxBlockCountSumPair.first; i--) {
-          if (m_mediator.m_txBlockChain.GetBlock(i)
-                  .GetHeader()
+          if (m_mediator.m_txBlockChain.GetBlockPtr(i)
+                  ->GetHeader()
                   .GetDSBlockNum() < latestDSBlockNum) {
             break;
           }
           m_TxBlockCountSumPair.second +=
-              m_mediator.m_txBlockChain.GetBlock(i).GetHeader().GetNumTxs();
+              m_mediator.m_txBlockChain.GetBlockPtr(i)->GetHeader().GetNumTxs();
         }
       }
 
@@ -1387,18 +1723,18 @@ Json::Value LookupServer::GetTransactionsForTxBlock(const string& txBlockNum) {
     throw JsonRpcException(RPC_INVALID_PARAMETER, e.what());
   }
 
-  auto const& txBlock = m_mediator.m_txBlockChain.GetBlock(txNum);
+  const auto txBlock = m_mediator.m_txBlockChain.GetBlockPtr(txNum);
 
   // TODO
   // Workaround to identify dummy block as == comparator does not work on
   // empty object for TxBlock and TxBlockheader().
   // if (txBlock == TxBlock()) {
-  if (txBlock.GetHeader().GetBlockNum() == INIT_BLOCK_NUMBER &&
-      txBlock.GetHeader().GetDSBlockNum() == INIT_BLOCK_NUMBER) {
+  if (txBlock->GetHeader().GetBlockNum() == INIT_BLOCK_NUMBER &&
+      txBlock->GetHeader().GetDSBlockNum() == INIT_BLOCK_NUMBER) {
     throw JsonRpcException(RPC_INVALID_PARAMS, "Tx Block does not exist");
   }
 
-  auto microBlockInfos = txBlock.GetMicroBlockInfos();
+  const auto& microBlockInfos = txBlock->GetMicroBlockInfos();
 
   bool hasTransactions = false;
   for (auto const& mbInfo : microBlockInfos) {
@@ -18,7 +18,11 @@
 #ifndef __LOOKUP_SERVER_H__
 #define __LOOKUP_SERVER_H__
 
+#include <functional>
+#include <unordered_map>
+
 #include "Server.h"
+#include "libUtils/ThreadPool.h"
 
 class Mediator;
 
@@ -37,6 +41,20 @@ class LookupServer : public Server,
   static CircularArray<std::string> m_RecentTransactions;
   static std::mutex m_mutexRecentTxns;
   std::mt19937 m_eng;
+  /// Responses computed for the latest (DS block, Tx block) pair, keyed by
+  /// method and parameters
+  std::mutex m_mutexResponseCache;
+  std::pair<uint64_t, uint64_t> m_responseCacheBlockNums;
+  std::unordered_map<std::string, Json::Value> m_responseCache;
+  uint64_t m_responseCacheSizeInBytes = 0;
+  /// Verifies the signatures of batched transactions, shared by all requests
+  ThreadPool m_verifierPool{LOOKUP_RPC_NUM_VERIFIER_THREADS, "RPCVerifierPool"};
+
+  /// Returns the cached response to the method call if the chain has not
+  /// moved on since it was computed, otherwise computes and caches it
+  Json::Value GetCachedResponse(const std::string& method,
+                                const std::string& params,
+                                const std::function<Json::Value()>& compute);
 
  public:
   LookupServer(Mediator& mediator, jsonrpc::AbstractServerConnector& server);
@@ -51,31 +69,45 @@ class LookupServer : public Server,
                                          Json::Value& response) {
     response = this->CreateTransaction(request[0u]);
   }
+  inline virtual void CreateTransactionsI(const Json::Value& request,
+                                          Json::Value& response) {
+    response = this->CreateTransactions(request[0u]);
+  }
   inline virtual void GetTransactionI(const Json::Value& request,
                                       Json::Value& response) {
     response = this->GetTransaction(request[0u].asString());
   }
   inline virtual void GetDsBlockI(const Json::Value& request,
                                   Json::Value& response) {
-    response = this->GetDsBlock(request[0u].asString());
+    response = GetCachedResponse("GetDsBlock", request[0u].asString(), [&]() {
+      return this->GetDsBlock(request[0u].asString());
+    });
   }
   inline virtual void GetTxBlockI(const Json::Value& request,
                                   Json::Value& response) {
-    response = this->GetTxBlock(request[0u].asString());
+    response = GetCachedResponse("GetTxBlock", request[0u].asString(), [&]() {
+      return this->GetTxBlock(request[0u].asString());
+    });
   }
   inline virtual void GetLatestDsBlockI(const Json::Value& request,
                                         Json::Value& response) {
     (void)request;
-    response = this->GetLatestDsBlock();
+    response = GetCachedResponse("GetLatestDsBlock", "", [&]() {
+      return this->GetLatestDsBlock();
+    });
   }
   inline virtual void GetLatestTxBlockI(const Json::Value& request,
                                         Json::Value& response) {
     (void)request;
-    response = this->GetLatestTxBlock();
+    response = GetCachedResponse("GetLatestTxBlock", "", [&]() {
+      return this->GetLatestTxBlock();
+    });
   }
   inline virtual void GetBalanceI(const Json::Value& request,
                                   Json::Value& response) {
-    response = this->GetBalance(request[0u].asString());
+    response = GetCachedResponse("GetBalance", request[0u].asString(), [&]() {
+      return this->GetBalance(request[0u].asString());
+    });
   }
   inline virtual void GetMinimumGasPriceI(const Json::Value& request,
                                           Json::Value& response) {
@@ -84,7 +116,10 @@ class LookupServer : public Server,
   }
   inline virtual void GetSmartContractsI(const Json::Value& request,
                                          Json::Value& response) {
-    response = this->GetSmartContracts(request[0u].asString());
+    response = GetCachedResponse(
+        "GetSmartContracts", request[0u].asString(), [&]() {
+          return this->GetSmartContracts(request[0u].asString());
+        });
   }
   inline virtual void GetContractAddressFromTransactionIDI(
       const Json::Value& request, Json::Value& response) {
@@ -129,12 +164,18 @@ class LookupServer : public Server,
   inline virtual void DSBlockListingI(const Json::Value& request,
                                       Json::Value& response) {
     (void)request;
-    response = this->DSBlockListing(request[0u].asUInt());
+    response = GetCachedResponse(
+        "DSBlockListing", std::to_string(request[0u].asUInt()), [&]() {
+          return this->DSBlockListing(request[0u].asUInt());
+        });
   }
   inline virtual void TxBlockListingI(const Json::Value& request,
                                       Json::Value& response) {
     (void)request;
-    response = this->TxBlockListing(request[0u].asUInt());
+    response = GetCachedResponse(
+        "TxBlockListing", std::to_string(request[0u].asUInt()), [&]() {
+          return this->TxBlockListing(request[0u].asUInt());
+        });
   }
   inline virtual void GetBlockchainInfoI(const Json::Value& request,
                                          Json::Value& response) {
@@ -149,7 +190,9 @@ class LookupServer : public Server,
   inline virtual void GetShardingStructureI(const Json::Value& request,
                                             Json::Value& response) {
     (void)request;
-    response = this->GetShardingStructure();
+    response = GetCachedResponse("GetShardingStructure", "", [&]() {
+      return this->GetShardingStructure();
+    });
   }
   inline virtual void GetNumTxnsTxEpochI(const Json::Value& request,
                                          Json::Value& response) {
@@ -163,15 +206,36 @@ class LookupServer : public Server,
   }
   inline virtual void GetSmartContractStateI(const Json::Value& request,
                                              Json::Value& response) {
-    response = this->GetSmartContractState(request[0u].asString());
+    response = GetCachedResponse(
+        "GetSmartContractState", request[0u].asString(), [&]() {
+          return this->GetSmartContractState(request[0u].asString());
+        });
+  }
+  inline virtual void GetSmartContractSubStateI(const Json::Value& request,
+                                                Json::Value& response) {
+    response = GetCachedResponse(
+        "GetSmartContractSubState",
+        request[0u].asString() + ":" + request[1u].asString() + ":" +
+            request[2u].asString(),
+        [&]() {
+          return this->GetSmartContractSubState(request[0u].asString(),
+                                                request[1u].asString(),
+                                                request[2u].asString());
+        });
   }
   inline virtual void GetSmartContractCodeI(const Json::Value& request,
                                             Json::Value& response) {
-    response = this->GetSmartContractCode(request[0u].asString());
+    response = GetCachedResponse(
+        "GetSmartContractCode", request[0u].asString(), [&]() {
+          return this->GetSmartContractCode(request[0u].asString());
+        });
   }
   inline virtual void GetSmartContractInitI(const Json::Value& request,
                                             Json::Value& response) {
-    response = this->GetSmartContractInit(request[0u].asString());
+    response = GetCachedResponse(
+        "GetSmartContractInit", request[0u].asString(), [&]() {
+          return this->GetSmartContractInit(request[0u].asString());
+        });
   }
   inline virtual void GetTransactionsForTxBlockI(const Json::Value& request,
                                                  Json::Value& response) {
@@ -184,6 +248,10 @@ class LookupServer : public Server,
 
   std::string GetNetworkId();
   Json::Value CreateTransaction(const Json::Value& _json);
+  /// Accepts an array of txns. Signatures are verified in parallel and the
+  /// accepted txns are added to the shard map at once. Returns one result
+  /// (TranID and Info, or error) per txn.
+  Json::Value CreateTransactions(const Json::Value& _json);
   Json::Value GetTransaction(const std::string& transactionHash);
   Json::Value GetDsBlock(const std::string& blockNum);
   Json::Value GetTxBlock(const std::string& blockNum);
@@ -211,7 +279,14 @@ class LookupServer : public Server,
 
   size_t GetNumTransactions(uint64_t blockNum);
   bool ValidateTxn(const Transaction& tx, const Address& fromAddr,
-                   const Account* sender) const;
+                   const Account* sender, bool verifySignature = true) const;
+  /// Returns the Info of a validated txn and the txn shard map index to add
+  /// it to
+  Json::Value GetTxnShardMapIndex(const Transaction& tx,
+                                  const Address& fromAddr,
+                                  const Account* sender,
+                                  const Json::Value& _json,
+                                  unsigned int& mapIndex) const;
   bool StartCollectorThread();
   std::string GetNodeState();
 
@@ -221,6 +296,11 @@ class LookupServer : public Server,
   // block
 
   Json::Value GetSmartContractState(const std::string& address);
+  /// Returns one page of the mutable contract states whose name starts with
+  /// vnamePrefix, and the cursor of the next page ("" after the last page)
+  Json::Value GetSmartContractSubState(const std::string& address,
+                                       const std::string& vnamePrefix,
+                                       const std::string& cursor);
   Json::Value GetSmartContractInit(const std::string& address);
   Json::Value GetSmartContractCode(const std::string& address);
   Json::Value GetTransactionsForTxBlock(const std::string& txBlockNum);
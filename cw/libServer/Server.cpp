@@ -50,14 +50,13 @@ Server::~Server(){
 string Server::GetCurrentMiniEpoch() {
   LOG_MARKER();
 
-  return to_string(m_mediator.m_currentEpochNum);
+  return to_string(m_mediator.GetChainTip()->GetEpochNum());
 }
 
 string Server::GetCurrentDSEpoch() {
   LOG_MARKER();
 
-  return to_string(
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum());
+  return to_string(m_mediator.GetChainTip()->GetDSBlockNum());
 }
 
 string Server::GetNodeType() {
@@ -76,9 +75,13 @@ string Server::GetNodeType() {
 }
 
 uint8_t Server::GetPrevDSDifficulty() {
-  return m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDSDifficulty();
+  return m_mediator.m_dsBlockChain.GetLastBlockPtr()
+      ->GetHeader()
+      .GetDSDifficulty();
 }
 
 uint8_t Server::GetPrevDifficulty() {
-  return m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetDifficulty();
+  return m_mediator.m_dsBlockChain.GetLastBlockPtr()
+      ->GetHeader()
+      .GetDifficulty();
 }
@@ -43,4 +43,46 @@ class SafeMath {
 
 #include "SafeMath.tpp"
 
+#include "libUtils/Logger.h"
+#include "libUtils/Uint128.h"
+
+// uint128_t is the type of balances, amounts and gas prices, so its checks
+// use the compiler overflow builtins on the native value
+
+template <>
+inline bool SafeMath<uint128_t>::add(const uint128_t& a, const uint128_t& b,
+                                     uint128_t& result) {
+  native_uint128_t n;
+  if (__builtin_add_overflow(ToNativeUint128(a), ToNativeUint128(b), &n)) {
+    LOG_GENERAL(WARNING, "Addition overflow!");
+    return false;
+  }
+  result = FromNativeUint128(n);
+  return true;
+}
+
+template <>
+inline bool SafeMath<uint128_t>::sub(const uint128_t& a, const uint128_t& b,
+                                     uint128_t& result) {
+  native_uint128_t n;
+  if (__builtin_sub_overflow(ToNativeUint128(a), ToNativeUint128(b), &n)) {
+    LOG_GENERAL(WARNING, "Subtraction underflow!");
+    return false;
+  }
+  result = FromNativeUint128(n);
+  return true;
+}
+
+template <>
+inline bool SafeMath<uint128_t>::mul(const uint128_t& a, const uint128_t& b,
+                                     uint128_t& result) {
+  native_uint128_t n;
+  if (__builtin_mul_overflow(ToNativeUint128(a), ToNativeUint128(b), &n)) {
+    LOG_GENERAL(WARNING, "Multiplication overflow!");
+    return false;
+  }
+  result = FromNativeUint128(n);
+  return true;
+}
+
 #endif  //__SAFEMATH_H__
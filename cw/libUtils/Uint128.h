@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __UINT128_H__
+#define __UINT128_H__
+
+#include <boost/functional/hash.hpp>
+
+#include "common/BaseType.h"
+
+#ifndef BOOST_HAS_INT128
+#error "uint128_t fast paths require compiler support for unsigned __int128"
+#endif
+
+/// Native 128-bit integer. The fixed-width boost backend of uint128_t stores
+/// its value as one, so converting between the two does not touch any limbs.
+using native_uint128_t = unsigned __int128;
+
+static_assert(sizeof(native_uint128_t) == 16,
+              "native_uint128_t must be 16 bytes wide");
+
+inline native_uint128_t ToNativeUint128(const uint128_t& value) {
+  return static_cast<native_uint128_t>(value);
+}
+
+inline uint128_t FromNativeUint128(const native_uint128_t& value) {
+  return uint128_t(value);
+}
+
+/// Writes value to dst as 16 big-endian bytes
+inline void Uint128ToBigEndian(const uint128_t& value, uint8_t* dst) {
+  native_uint128_t n = ToNativeUint128(value);
+  for (int i = sizeof(native_uint128_t) - 1; i >= 0; i--) {
+    dst[i] = static_cast<uint8_t>(n);
+    n >>= 8;
+  }
+}
+
+/// Reads 16 big-endian bytes from src
+inline uint128_t Uint128FromBigEndian(const uint8_t* src) {
+  native_uint128_t n = 0;
+  for (unsigned int i = 0; i < sizeof(native_uint128_t); i++) {
+    n = (n << 8) | src[i];
+  }
+  return FromNativeUint128(n);
+}
+
+/// Hashes a uint128_t from its two 64-bit halves, without formatting it
+struct Uint128Hash {
+  std::size_t operator()(const uint128_t& value) const {
+    const native_uint128_t n = ToNativeUint128(value);
+    std::size_t seed = 0;
+    boost::hash_combine(seed, static_cast<uint64_t>(n >> 64));
+    boost::hash_combine(seed, static_cast<uint64_t>(n));
+    return seed;
+  }
+};
+
+namespace std {
+template <>
+struct hash<uint128_t> : Uint128Hash {};
+}  // namespace std
+
+#endif  // __UINT128_H__
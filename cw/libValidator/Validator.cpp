@@ -154,12 +154,12 @@ bool Validator::CheckCreatedTransactionFromLookup(const Transaction& tx) {
   }
 
   if (tx.GetGasPrice() <
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetGasPrice()) {
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetGasPrice()) {
     LOG_EPOCH(WARNING, m_mediator.m_currentEpochNum,
               "GasPrice " << tx.GetGasPrice()
                           << " lower than minimum allowable "
-                          << m_mediator.m_dsBlockChain.GetLastBlock()
-                                 .GetHeader()
+                          << m_mediator.m_dsBlockChain.GetLastBlockPtr()
+                                 ->GetHeader()
                                  .GetGasPrice());
     return false;
   }
@@ -258,7 +258,7 @@ bool Validator::CheckDirBlocks(
   bool ret = true;
 
   uint64_t prevdsblocknum =
-      m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetBlockNum();
+      m_mediator.m_dsBlockChain.GetLastBlockPtr()->GetHeader().GetBlockNum();
   uint64_t totalIndex = index_num;
   ShardingHash prevShardingHash =
       m_mediator.m_dsBlockChain.GetLastBlock().GetHeader().GetShardingHash();
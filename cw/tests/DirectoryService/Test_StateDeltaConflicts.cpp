@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "libDirectoryService/DirectoryService.h"
+#include "libMessage/Messenger.h"
+#include "libMessage/ZilliqaMessage.pb.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE statedeltaconflicts
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace ZilliqaMessage;
+
+BOOST_AUTO_TEST_SUITE(statedeltaconflicts)
+
+static const Address ACCOUNT_A("0x1000000000000000000000000000000000000001");
+static const Address ACCOUNT_B("0x1000000000000000000000000000000000000002");
+static const Address ACCOUNT_C("0x1000000000000000000000000000000000000003");
+static const Address ACCOUNT_D("0x1000000000000000000000000000000000000004");
+
+/// Adds an account delta with the given nonce change and storage entry count
+static void AddAccountDelta(ProtoAccountStore& delta, const Address& address,
+                            uint64_t nonce, unsigned int numStorageEntries) {
+  ProtoAccountStore::AddressAccount* entry = delta.add_entries();
+  entry->set_address(address.data(), address.size);
+  ProtoAccount* account = entry->mutable_account();
+  account->mutable_base()->set_version(1);
+  account->mutable_base()->mutable_balance()->set_data(
+      string(UINT128_SIZE, '\0'));
+  account->mutable_base()->set_nonce(nonce);
+  account->set_numbersign(true);
+  for (unsigned int i = 0; i < numStorageEntries; i++) {
+    ProtoAccount::StorageData* storage = account->add_storage();
+    storage->set_keyhash(string(dev::h256::size, static_cast<char>(i)));
+    storage->set_data("value");
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_exclusive_updates) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  ProtoAccountStore delta;
+  AddAccountDelta(delta, ACCOUNT_A, 1, 0);  // sender
+  AddAccountDelta(delta, ACCOUNT_B, 0, 0);  // recipient only
+  AddAccountDelta(delta, ACCOUNT_C, 0, 2);  // contract called
+
+  bytes src(delta.ByteSize());
+  BOOST_CHECK(delta.SerializeToArray(src.data(), src.size()));
+
+  vector<Address> addresses;
+  BOOST_CHECK(Messenger::StateDeltaToExclusiveUpdates(src, 0, addresses));
+  BOOST_CHECK_EQUAL(addresses.size(), 2);
+  BOOST_CHECK(find(addresses.begin(), addresses.end(), ACCOUNT_A) !=
+              addresses.end());
+  BOOST_CHECK(find(addresses.begin(), addresses.end(), ACCOUNT_C) !=
+              addresses.end());
+}
+
+BOOST_AUTO_TEST_CASE(test_conflicting_shards) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  StateDeltaExclusiveUpdates updates;
+  updates[0] = {BlockHash(1), {ACCOUNT_A}};
+  updates[1] = {BlockHash(2), {ACCOUNT_B}};
+  BOOST_CHECK(DirectoryService::GetConflictingShards(updates).empty());
+
+  // The higher shard loses, whichever shard was added first
+  updates[3] = {BlockHash(4), {ACCOUNT_D, ACCOUNT_C}};
+  updates[2] = {BlockHash(3), {ACCOUNT_C}};
+  const set<uint32_t> conflicting =
+      DirectoryService::GetConflictingShards(updates);
+  BOOST_CHECK_EQUAL(conflicting.size(), 1);
+  BOOST_CHECK(conflicting.count(3) == 1);
+
+  // A dropped shard does not take accounts away from higher shards
+  updates[4] = {BlockHash(5), {ACCOUNT_D}};
+  BOOST_CHECK(DirectoryService::GetConflictingShards(updates) ==
+              set<uint32_t>({3}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
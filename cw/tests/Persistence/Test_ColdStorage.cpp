@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <boost/filesystem.hpp>
+
+#include "depends/common/SHA3.h"
+#include "libPersistence/ColdStorage.h"
+#include "libUtils/DataConversion.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE coldstorage
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(coldstorage)
+
+/// Returns count records of each type, with distinct keys and values
+static vector<ColdStorage::Record> GenerateRecords(const string& prefix,
+                                                   unsigned int count) {
+  vector<ColdStorage::Record> records;
+  for (unsigned int i = 0; i < count; i++) {
+    for (const auto& type : {ColdStorage::TXBODY, ColdStorage::MICROBLOCK}) {
+      const string name = prefix + to_string(type) + "_" + to_string(i);
+      records.push_back(
+          {type, dev::h256(dev::sha3(name)),
+           DataConversion::StringToCharArray(string(100 + i, 'x') + name)});
+    }
+  }
+  return records;
+}
+
+static void CheckRecords(const ColdStorage& coldStorage,
+                         const vector<ColdStorage::Record>& records) {
+  for (const auto& record : records) {
+    bytes value;
+    BOOST_CHECK(coldStorage.Get(record.m_type, record.m_key, value));
+    BOOST_CHECK(value == record.m_value);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_segment_round_trip) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  const string path = (boost::filesystem::temp_directory_path() /
+                       boost::filesystem::unique_path())
+                          .string();
+
+  const auto records1 = GenerateRecords("epoch1_", 20);
+  const auto records2 = GenerateRecords("epoch2_", 5);
+
+  {
+    ColdStorage coldStorage(path);
+    BOOST_CHECK_EQUAL(coldStorage.GetNextTxBlockNum(), 0);
+
+    BOOST_CHECK(coldStorage.PutSegment(1, 0, 99, records1));
+    BOOST_CHECK_EQUAL(coldStorage.GetNextTxBlockNum(), 100);
+
+    // Segments may span TxBlocks missing from the node
+    BOOST_CHECK(coldStorage.PutSegment(2, 150, 199, records2));
+    BOOST_CHECK_EQUAL(coldStorage.GetNextTxBlockNum(), 200);
+
+    // Segments are only ever added after the latest one
+    BOOST_CHECK(!coldStorage.PutSegment(3, 199, 299, records2));
+
+    CheckRecords(coldStorage, records1);
+    CheckRecords(coldStorage, records2);
+  }
+
+  // The segments are read back from disk by a new instance
+  ColdStorage coldStorage(path);
+  BOOST_CHECK_EQUAL(coldStorage.GetNextTxBlockNum(), 200);
+  CheckRecords(coldStorage, records1);
+  CheckRecords(coldStorage, records2);
+
+  // A key stored under one type is not found under the other
+  bytes value;
+  const auto& record = records1.front();
+  BOOST_CHECK(record.m_type == ColdStorage::TXBODY);
+  BOOST_CHECK(!coldStorage.Get(ColdStorage::MICROBLOCK, record.m_key, value));
+
+  BOOST_CHECK(coldStorage.Reset());
+  BOOST_CHECK_EQUAL(coldStorage.GetNextTxBlockNum(), 0);
+  BOOST_CHECK(!coldStorage.Get(record.m_type, record.m_key, value));
+
+  boost::system::error_code ec;
+  boost::filesystem::remove_all(path, ec);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2019 Zilliqa
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <map>
+
+#include "libData/AccountData/Account.h"
+#include "libMessage/MessengerAccountStoreBase.h"
+#include "libPersistence/ContractStorage.h"
+#include "libUtils/DataConversion.h"
+#include "libUtils/Logger.h"
+
+#define BOOST_TEST_MODULE contractstorage
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+using namespace std;
+using namespace Contract;
+
+BOOST_AUTO_TEST_SUITE(contractstorage)
+
+/// Returns count states of a contract, ordered by index
+static vector<pair<Index, bytes>> GenerateStates(const Address& address,
+                                                 unsigned int count) {
+  vector<pair<Index, bytes>> entries;
+  for (unsigned int i = 0; i < count; i++) {
+    entries.emplace_back(
+        GetIndex(address, "state" + to_string(i)),
+        DataConversion::StringToCharArray("value" + to_string(i)));
+  }
+  sort(entries.begin(), entries.end());
+  return entries;
+}
+
+BOOST_AUTO_TEST_CASE(test_rebuild_matches_incremental_root) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  ContractStorage& cs = ContractStorage::GetContractStorage();
+  cs.Reset();
+
+  const Address address("0x1000000000000000000000000000000000000001");
+  const auto entries = GenerateStates(address, 10);
+
+  // Commit the states in two steps, as two blocks would
+  dev::h256 root;
+  BOOST_CHECK(cs.PutContractState(
+      address, {entries.begin(), entries.begin() + 5}, root, false, false));
+  BOOST_CHECK(cs.PutContractState(address, {entries.begin() + 5, entries.end()},
+                                  root, false, false));
+  BOOST_CHECK(cs.CommitStateDB());
+
+  dev::h256 rebuiltRoot;
+  BOOST_CHECK(cs.RebuildContractStateTrie(address, rebuiltRoot));
+  BOOST_CHECK_EQUAL(rebuiltRoot, root);
+  BOOST_CHECK(cs.CommitStateDB());
+
+  // The migrated root can be updated incrementally afterwards
+  const vector<pair<Index, bytes>> update = {
+      {entries[0].first, DataConversion::StringToCharArray("changed")}};
+  BOOST_CHECK(cs.PutContractState(address, update, rebuiltRoot, false, false));
+  BOOST_CHECK(rebuiltRoot != root);
+}
+
+BOOST_AUTO_TEST_CASE(test_unknown_root_is_rejected) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  ContractStorage& cs = ContractStorage::GetContractStorage();
+  cs.Reset();
+
+  const Address address("0x1000000000000000000000000000000000000002");
+  const auto entries = GenerateStates(address, 3);
+
+  // A root of the previous format is not a node of any state trie
+  dev::h256 root = GetLegacyStorageRoot(entries);
+  BOOST_CHECK(!cs.PutContractState(address, entries, root, false, false));
+}
+
+BOOST_AUTO_TEST_CASE(test_account_with_legacy_root_round_trip) {
+  INIT_STDOUT_LOGGER();
+
+  LOG_MARKER();
+
+  ContractStorage::GetContractStorage().Reset();
+
+  const Address address("0x1000000000000000000000000000000000000003");
+  const auto entries = GenerateStates(address, 5);
+
+  Account account(0, 0);
+  BOOST_CHECK(account.SetCode(DataConversion::StringToCharArray("code")));
+  BOOST_CHECK(account.SetStorage(address, entries, false));
+  const dev::h256 trieRoot = account.GetStorageRoot();
+
+  // A sender not yet migrated sends the same states with the previous root
+  account.SetStorageRoot(GetLegacyStorageRoot(entries));
+
+  map<Address, Account> sent = {{address, account}};
+  bytes message;
+  BOOST_CHECK(MessengerAccountStoreBase::SetAccountStore(message, 0, sent));
+
+  ContractStorage::GetContractStorage().Reset();
+
+  map<Address, Account> received;
+  BOOST_CHECK(MessengerAccountStoreBase::GetAccountStore(message, 0, received));
+  BOOST_CHECK_EQUAL(received[address].GetStorageRoot(), trieRoot);
+
+  // Any other root is still rejected
+  account.SetStorageRoot(dev::h256(1));
+  sent[address] = account;
+  message.clear();
+  received.clear();
+  BOOST_CHECK(MessengerAccountStoreBase::SetAccountStore(message, 0, sent));
+  BOOST_CHECK(
+      !MessengerAccountStoreBase::GetAccountStore(message, 0, received));
+}
+
+BOOST_AUTO_TEST_SUITE_END()